@@ -1,6 +1,53 @@
 #pragma once
 #include <ostream>
 #include <math.h>
+#include <span>
+#include <vector>
+#include <new>
+#include <array>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <functional>
+#include <type_traits>
+#include <algorithm>
+#include <mutex>
+#include <climits>
+#include <memory>
+#include <cstring>
+#include <atomic>
+#include <cstdint>
+#include <cassert>
+
+#if !defined(ZCPP_COLOR_NO_SIMD)
+#if defined(__AVX2__)
+#define ZCPP_COLOR_AVX2
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ZCPP_COLOR_SSE2
+#include <immintrin.h>
+#endif
+#if defined(__SSSE3__) || defined(ZCPP_COLOR_AVX2)
+#define ZCPP_COLOR_SSSE3
+#endif
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(ZCPP_COLOR_AVX2))
+#define ZCPP_COLOR_F16C
+#endif
+#endif
+
+#if defined(_WIN32)
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define ZCPP_COLOR_MMAP
+#endif
 
 #undef RGB
 #undef HSV
@@ -20,12 +67,39 @@ namespace ZCPP
 		// | Current supported types:                      |
 		// | RGB32 - Base type                             |
 		// | RGB  |  HSV  |  HSL  |  CMYK                  |
+		// | HSV32  |  HSL32 - 8bit integer variants       |
+		// | Lab  |  OKLab  |  OKLCh - Perceptual spaces   |
 		// |                                               |
 		// | Conversion to type:   To_TYPE(value)          |
 		// |                                               |
 		// | Extra functions:                              |
 		// | RGB_TO_HUE(RGB) - Converts rgb to a hue       |
 		// | HUE_TO_RGB(HUE) - Converts a hue to rgb       |
+		// |                                               |
+		// | Bulk conversion:  Convert(src, dst)           |
+		// | (SSE2 / AVX2 when enabled by the compiler)    |
+		// |                                               |
+		// | PlanarImage<TYPE> - One aligned plane per     |
+		// |                     channel (RGB/HSV/HSL/CMYK)|
+		// | LUT3D - Baked / .cube color grading LUT       |
+		// |                                               |
+		// | sRGB: SRGB_TO_LINEAR / LINEAR_TO_SRGB,        |
+		// | Light_Mode::Linear for gamma-correct passes   |
+		// |                                               |
+		// | Composite(src, dst, op) - Porter-Duff         |
+		// | Blend(src, dst, mode)   - Multiply, Screen... |
+		// |                                               |
+		// | Pipeline - Fused, tiled multi-stage chains    |
+		// | Palette - Median cut / k-means quantization   |
+		// | Color_Histogram - Min/max/mean/percentiles    |
+		// | YCbCr_Image - BT.601/709 I420/NV12 frames     |
+		// | Dither / Error_Diffuse - Banding-free output  |
+		// | Convolve - Separable box / Gaussian / N-tap   |
+		// | Resample - Bilinear / bicubic / Lanczos       |
+		// | Packed_RGB32 - SWAR ops, RGBA/BGRA/ARGB swaps |
+		// | Gradient / Colormap - Viridis, baked tables   |
+		// | Image_Reader / Image_Writer - PPM, PAM, QOI   |
+		// | RGBA16 / RGBA_Half - 8 byte HDR pixels        |
 		// |                                     - Zyphery |
 		// \-----------------------------------------------/
 
@@ -50,6 +124,55 @@ namespace ZCPP
 			return static_cast<BYTE>(_x * 255.0f);
 		}
 
+		// Rounded _x / 255 for _x in [0, 65535]
+		inline int div255(int _x) { _x += 128; return (_x + (_x >> 8)) >> 8; }
+
+		// /-----------------------------------------------\
+		// | Lookup Tables                                 |
+		// \-----------------------------------------------/
+
+		// BYTE -> float, bit-identical to BYTE * (1.0 / 255.0)
+		inline constexpr std::array<float, 256> BYTE_TO_FLOAT = [] {
+			std::array<float, 256> table{};
+			for (int i = 0; i < 256; i++)
+				table[i] = static_cast<float>(i) * static_cast<float>(1.0 / 255.0);
+			return table;
+		}();
+
+		// Rec.709 luminance weights in Q16 (sum to 65536, so white stays 255)
+		inline constexpr int LUMA_R_Q16 = 13933;
+		inline constexpr int LUMA_G_Q16 = 46871;
+		inline constexpr int LUMA_B_Q16 = 4732;
+
+		// round((255 << 12) / x), saturation divisor for the 8bit HSV / HSL paths
+		inline constexpr std::array<int, 256> SATURATION_DIV_Q12 = [] {
+			std::array<int, 256> table{};
+			for (int i = 1; i < 256; i++)
+				table[i] = ((255 << 12) + i / 2) / i;
+			return table;
+		}();
+
+		// round((256 << 12) / (6 * x)), one hue sector of delta x on the 0 - 255 circle
+		inline constexpr std::array<int, 256> HUE_DIV_Q12 = [] {
+			std::array<int, 256> table{};
+			for (int i = 1; i < 256; i++)
+				table[i] = ((256 << 12) + 3 * i) / (6 * i);
+			return table;
+		}();
+
+		// 8bit hue (full circle over 0 - 255) from integer channels, no division
+		inline BYTE byte_hue(int r, int g, int b, int cMax, int delta)
+		{
+			int h;
+			if (cMax == r)
+				h = (g - b) * HUE_DIV_Q12[delta];
+			else if (cMax == g)
+				h = (b - r) * HUE_DIV_Q12[delta] + ((2 * 256 << 12) + 3) / 6;
+			else
+				h = (r - g) * HUE_DIV_Q12[delta] + ((4 * 256 << 12) + 3) / 6;
+			return static_cast<BYTE>(((h + 2048) >> 12) & 255);
+		}
+
 		// /-----------------------------------------------\
 		// | Color Class Definitions                       |
 		// \-----------------------------------------------/
@@ -59,6 +182,8 @@ namespace ZCPP
 		class HSV;
 		class HSL;
 		class CMYK;
+		class HSV32;
+		class HSL32;
 
 		// < Utilizes 8bit int >
 		class RGB32
@@ -236,6 +361,141 @@ namespace ZCPP
 			friend std::ostream& operator << (std::ostream& os, const CMYK& cmyk);
 		};
 
+		// < Utilizes 8bit int, hue wraps the full circle over 0 - 255 >
+		class HSV32
+		{
+		public:
+			// < Hue >
+			// 0 - 255
+			BYTE h;
+			// < Saturation >
+			// 0 - 255
+			BYTE s;
+			// < Value >
+			// 0 - 255
+			BYTE v;
+			// < Alpha >
+			// 0 - 255
+			BYTE a;
+
+			HSV32(BYTE hue, BYTE saturation, BYTE value, BYTE alpha) : h(hue), s(saturation), v(value), a(alpha) {}
+			HSV32(BYTE hue, BYTE saturation, BYTE value) : h(hue), s(saturation), v(value), a(255) {}
+			HSV32() : h(0), s(0), v(0), a(255) {}
+
+			bool operator == (const HSV32& rhs) { return this->h == rhs.h && this->s == rhs.s && this->v == rhs.v && this->a == rhs.a; }
+			bool operator != (const HSV32& rhs) { return !(*this == rhs); }
+
+			friend std::ostream& operator << (std::ostream& os, const HSV32& hsv32);
+		};
+
+		// < Utilizes 8bit int, hue wraps the full circle over 0 - 255 >
+		class HSL32
+		{
+		public:
+			// < Hue >
+			// 0 - 255
+			BYTE h;
+			// < Saturation >
+			// 0 - 255
+			BYTE s;
+			// < Lightness >
+			// 0 - 255
+			BYTE l;
+			// < Alpha >
+			// 0 - 255
+			BYTE a;
+
+			HSL32(BYTE hue, BYTE saturation, BYTE lightness, BYTE alpha) : h(hue), s(saturation), l(lightness), a(alpha) {}
+			HSL32(BYTE hue, BYTE saturation, BYTE lightness) : h(hue), s(saturation), l(lightness), a(255) {}
+			HSL32() : h(0), s(0), l(0), a(255) {}
+
+			bool operator == (const HSL32& rhs) { return this->h == rhs.h && this->s == rhs.s && this->l == rhs.l && this->a == rhs.a; }
+			bool operator != (const HSL32& rhs) { return !(*this == rhs); }
+
+			friend std::ostream& operator << (std::ostream& os, const HSL32& hsl32);
+		};
+
+		// < CIE L*a*b* (D65), utilizes 32bit float >
+		class Lab
+		{
+		public:
+			// < Lightness >
+			// 0.0 - 100.0
+			float l;
+			// < Green - Red >
+			// about -128.0 - 127.0
+			float a;
+			// < Blue - Yellow >
+			// about -128.0 - 127.0
+			float b;
+			// < Alpha >
+			// 0.0 - 1.0
+			float alpha;
+
+			Lab(float lightness, float green_red, float blue_yellow, float alpha) : l(lightness), a(green_red), b(blue_yellow), alpha(alpha) {}
+			Lab(float lightness, float green_red, float blue_yellow) : l(lightness), a(green_red), b(blue_yellow), alpha(1.0f) {}
+			Lab() : l(0.0f), a(0.0f), b(0.0f), alpha(1.0f) {}
+
+			bool operator == (const Lab& rhs) { return this->l == rhs.l && this->a == rhs.a && this->b == rhs.b && this->alpha == rhs.alpha; }
+			bool operator != (const Lab& rhs) { return !(*this == rhs); }
+
+			friend std::ostream& operator << (std::ostream& os, const Lab& lab);
+		};
+
+		// < OKLab (Ottosson), utilizes 32bit float >
+		class OKLab
+		{
+		public:
+			// < Lightness >
+			// 0.0 - 1.0
+			float l;
+			// < Green - Red >
+			// about -0.4 - 0.4
+			float a;
+			// < Blue - Yellow >
+			// about -0.4 - 0.4
+			float b;
+			// < Alpha >
+			// 0.0 - 1.0
+			float alpha;
+
+			OKLab(float lightness, float green_red, float blue_yellow, float alpha) : l(lightness), a(green_red), b(blue_yellow), alpha(alpha) {}
+			OKLab(float lightness, float green_red, float blue_yellow) : l(lightness), a(green_red), b(blue_yellow), alpha(1.0f) {}
+			OKLab() : l(0.0f), a(0.0f), b(0.0f), alpha(1.0f) {}
+
+			bool operator == (const OKLab& rhs) { return this->l == rhs.l && this->a == rhs.a && this->b == rhs.b && this->alpha == rhs.alpha; }
+			bool operator != (const OKLab& rhs) { return !(*this == rhs); }
+
+			friend std::ostream& operator << (std::ostream& os, const OKLab& oklab);
+		};
+
+		// < Polar OKLab, utilizes 32bit float >
+		class OKLCh
+		{
+		public:
+			// < Lightness >
+			// 0.0 - 1.0
+			float l;
+			// < Chroma >
+			// 0.0 - about 0.4
+			float c;
+			// < Hue >
+			// 0.0 - 1.0
+			float h;
+			// < Alpha >
+			// 0.0 - 1.0
+			float alpha;
+
+			OKLCh(float lightness, float chroma, float hue, float alpha) : l(lightness), c(chroma), h(hue), alpha(alpha) {}
+			OKLCh(float lightness, float chroma, float hue) : l(lightness), c(chroma), h(hue), alpha(1.0f) {}
+			OKLCh() : l(0.0f), c(0.0f), h(0.0f), alpha(1.0f) {}
+
+			bool operator == (const OKLCh& rhs) { return this->l == rhs.l && this->c == rhs.c && this->h == rhs.h && this->alpha == rhs.alpha; }
+			bool operator != (const OKLCh& rhs) { return !(*this == rhs); }
+
+			friend std::ostream& operator << (std::ostream& os, const OKLCh& oklch);
+		};
+
 		// /-----------------------------------------------\
 		// | Function Declarations                         |
 		// \-----------------------------------------------/
@@ -269,65 +529,67 @@ namespace ZCPP
 		HSV RGB32_TO_HSV(RGB32);
 		HSL RGB32_TO_HSL(RGB32);
 		CMYK RGB32_TO_CMYK(RGB32);
+		HSV32 RGB32_TO_HSV32(RGB32);
+		HSL32 RGB32_TO_HSL32(RGB32);
+
+		RGB32 HSV32_TO_RGB32(HSV32);
+		RGB32 HSL32_TO_RGB32(HSL32);
+
+		Lab RGB_TO_LAB(RGB);
+		Lab RGB32_TO_LAB(RGB32);
+		RGB LAB_TO_RGB(Lab);
+		RGB32 LAB_TO_RGB32(Lab);
+
+		OKLab RGB_TO_OKLAB(RGB);
+		OKLab RGB32_TO_OKLAB(RGB32);
+		OKLab OKLCH_TO_OKLAB(OKLCh);
+		RGB OKLAB_TO_RGB(OKLab);
+		RGB32 OKLAB_TO_RGB32(OKLab);
+		OKLCh OKLAB_TO_OKLCH(OKLab);
 
 		// /-----------------------------------------------\
 		// | Helper Functions                              |
 		// \-----------------------------------------------/
 
-		float RGB_TO_HUE(RGB rgb)
+		// Branch-free hue in 0.0 - 1.0. Two conditional swaps (selects, not jumps) move the
+		// largest channel into r, and k records which sector that leaves the remainder in.
+		// The largest and smallest channel fall out of the same swaps, for HSV and HSL to reuse.
+		// fabsf rather than abs(), whose branch on the sign mispredicts on real images.
+		inline float float_hue(float r, float g, float b, float& cMax, float& cMin)
 		{
-			float hue = 0.0f;
-
-			float cMax = max(max(rgb.r, rgb.g), rgb.b);
-			float cMin = min(min(rgb.r, rgb.g), rgb.b);
-			float delta = cMax - cMin;
-
-			if (delta == 0.0f) {
-				hue = 0.0f;
-			}
-			else if (cMax == rgb.r) {
-				hue = (rgb.g - rgb.b) / delta;
-			}
-			else if (cMax == rgb.g) {
-				hue = 2.0f + ((rgb.b - rgb.r) / delta);
-			}
-			else if (cMax == rgb.b) {
-				hue = 4.0f + ((rgb.r - rgb.g) / delta);
-			}
+			float k = g < b ? -1.0f : 0.0f;
+			const float hi = max(g, b), lo = min(g, b);
+			k = r < hi ? -1.0f / 3.0f - k : k;
+			const float mid = min(r, hi);
+			cMax = max(r, hi);
+			cMin = min(mid, lo);
+			return fabsf(k + (mid - lo) / (6.0f * (cMax - cMin) + 1e-20f));
+		}
+		inline float float_hue(float r, float g, float b)
+		{
+			float cMax, cMin;
+			return float_hue(r, g, b, cMax, cMin);
+		}
 
-			hue = (hue * 60.0f) * .0027777777777f;
-			if (hue < 0)
-				hue++;
+		// Fully saturated color of a hue as three clamped ramps, so no sector is ever selected.
+		// Wraps the hue into 0.0 - 1.0 first.
+		inline void hue_channels(float hue, float& r, float& g, float& b)
+		{
+			const float h = (hue - floorf(hue)) * 6.0f;
+			r = min(max(abs(h - 3.0f) - 1.0f, 0.0f), 1.0f);
+			g = min(max(2.0f - abs(h - 2.0f), 0.0f), 1.0f);
+			b = min(max(2.0f - abs(h - 4.0f), 0.0f), 1.0f);
+		}
 
-			return hue;
+		float RGB_TO_HUE(RGB rgb)
+		{
+			return float_hue(rgb.r, rgb.g, rgb.b);
 		}
 
 		RGB HUE_TO_RGB(float hue = 1.0f)
 		{
 			RGB rgb;
-
-			float h = mod(hue, 1.0f) * 360.0f;
-			float X = (1.0f - abs(mod(h * 0.01666666666f, 2) - 1.0f));
-
-			if (hue >= 0.0f && hue < 60.0f) {
-				rgb = RGB(1.0f, X, 0.0f);
-			}
-			else if (hue >= 60.0f && hue < 120.0f) {
-				rgb = RGB(X, 1.0f, 0.0f);
-			}
-			else if (hue >= 120.0f && hue < 180.0f) {
-				rgb = RGB(0.0f, 1.0f, X);
-			}
-			else if (hue >= 180.0f && hue < 240.0f) {
-				rgb = RGB(0.0f, X, 1.0f);
-			}
-			else if (hue >= 240.0f && hue < 300.0f) {
-				rgb = RGB(X, 0.0f, 1.0f);
-			}
-			else {
-				rgb = RGB(1.0f, 0.0f, X);
-			}
-
+			hue_channels(hue, rgb.r, rgb.g, rgb.b);
 			return rgb;
 		}
 
@@ -339,18 +601,17 @@ namespace ZCPP
 
 		RGB32 RGB32_TO_GRAYSCALE(RGB32 rgb32)
 		{
-			RGB rgb = RGB32_TO_RGB(rgb32);
-			rgb = RGB_TO_GRAYSCALE(rgb);
-			return RGB_TO_RGB32(rgb);
+			// Q16 fixed point, within 1 of the float RGB_TO_GRAYSCALE round trip
+			BYTE value = static_cast<BYTE>((LUMA_R_Q16 * rgb32.r + LUMA_G_Q16 * rgb32.g + LUMA_B_Q16 * rgb32.b) >> 16);
+			return RGB32(value, value, value, rgb32.a);
 		}
 		RGB RGB32_TO_RGB(RGB32 rgb32)
 		{
 			RGB rgb;
-			float i = 1.0 / 255.0;
-			rgb.r = static_cast<float>(rgb32.r) * i;
-			rgb.g = static_cast<float>(rgb32.g) * i;
-			rgb.b = static_cast<float>(rgb32.b) * i;
-			rgb.a = static_cast<float>(rgb32.a) * i;
+			rgb.r = BYTE_TO_FLOAT[rgb32.r];
+			rgb.g = BYTE_TO_FLOAT[rgb32.g];
+			rgb.b = BYTE_TO_FLOAT[rgb32.b];
+			rgb.a = BYTE_TO_FLOAT[rgb32.a];
 			return rgb;
 		}
 		HSV RGB32_TO_HSV(RGB32 rgb32)
@@ -368,6 +629,46 @@ namespace ZCPP
 			RGB rgb = RGB32_TO_RGB(rgb32);
 			return RGB_TO_CMYK(rgb);
 		}
+		HSV32 RGB32_TO_HSV32(RGB32 rgb32)
+		{
+			HSV32 hsv32;
+
+			int cMax = std::max(std::max(rgb32.r, rgb32.g), rgb32.b);
+			int cMin = std::min(std::min(rgb32.r, rgb32.g), rgb32.b);
+			int delta = cMax - cMin;
+
+			hsv32.v = static_cast<BYTE>(cMax);
+			hsv32.s = static_cast<BYTE>((delta * SATURATION_DIV_Q12[cMax] + 2048) >> 12);
+			hsv32.h = delta == 0 ? 0 : byte_hue(rgb32.r, rgb32.g, rgb32.b, cMax, delta);
+
+			hsv32.a = rgb32.a;
+			return hsv32;
+		}
+		HSL32 RGB32_TO_HSL32(RGB32 rgb32)
+		{
+			HSL32 hsl32;
+
+			int cMax = std::max(std::max(rgb32.r, rgb32.g), rgb32.b);
+			int cMin = std::min(std::min(rgb32.r, rgb32.g), rgb32.b);
+			int delta = cMax - cMin;
+			int sum = cMax + cMin;
+
+			hsl32.l = static_cast<BYTE>((sum + 1) >> 1);
+
+			if (delta == 0) {
+				hsl32.h = 0;
+				hsl32.s = 0;
+			}
+			else {
+				// delta / (1 - |2l - 1|), the divisor is never 0 once delta != 0
+				int divisor = sum <= 255 ? sum : 510 - sum;
+				hsl32.s = static_cast<BYTE>(std::min((delta * SATURATION_DIV_Q12[divisor] + 2048) >> 12, 255));
+				hsl32.h = byte_hue(rgb32.r, rgb32.g, rgb32.b, cMax, delta);
+			}
+
+			hsl32.a = rgb32.a;
+			return hsl32;
+		}
 		std::ostream& operator << (std::ostream& os, const RGB32& rgb32)
 		{
 			os << "R: " << (int)rgb32.r << " G: " << (int)rgb32.g << " B: " << (int)rgb32.b << " A: " << (int)rgb32.a;
@@ -383,74 +684,22 @@ namespace ZCPP
 		}
 		HSV RGB_TO_HSV(RGB rgb)
 		{
-			HSV hsv;
-
-			float cMax = max(max(rgb.r, rgb.g), rgb.b);
-			float cMin = min(min(rgb.r, rgb.g), rgb.b);
+			float cMax, cMin;
+			float hue = float_hue(rgb.r, rgb.g, rgb.b, cMax, cMin);
 			float delta = cMax - cMin;
 
-			hsv.v = cMax;
-
-			if (cMax == 0.0f) {
-				hsv.s = 0.0f;
-			}
-			else {
-				hsv.s = delta / cMax;
-			}
-
-			if (delta == 0.0f) {
-				hsv.h = 0.0f;
-			}
-			else if (cMax == rgb.r) {
-				hsv.h = (rgb.g - rgb.b) / delta;
-			}
-			else if (cMax == rgb.g) {
-				hsv.h = 2.0f + ((rgb.b - rgb.r) / delta);
-			}
-			else if (cMax == rgb.b) {
-				hsv.h = 4.0f + ((rgb.r - rgb.g) / delta);
-			}
-
-			hsv.h = (hsv.h * 60.0f) * .0027777777777f;
-			if (hsv.h < 0)
-				hsv.h++;
-
-			hsv.a = rgb.a;
-			return hsv;
+			// delta is 0 whenever cMax is, so the bias only guards 0 / 0
+			return HSV(hue, delta / (cMax + 1e-20f), cMax, rgb.a);
 		}
 		HSL RGB_TO_HSL(RGB rgb)
 		{
-			HSL hsl;
-
-			float cMax = max(max(rgb.r, rgb.g), rgb.b);
-			float cMin = min(min(rgb.r, rgb.g), rgb.b);
+			float cMax, cMin;
+			float hue = float_hue(rgb.r, rgb.g, rgb.b, cMax, cMin);
 			float delta = cMax - cMin;
+			float l = (cMax + cMin) * 0.5f;
 
-			hsl.l = (cMax + cMin) * 0.5f;
-
-			if (delta == 0.0f) {
-				hsl.h = 0.0f;
-				hsl.s = 0.0f;
-			}
-			else {
-				hsl.s = delta / (1.0f - abs(2.0f * hsl.l - 1.0f));
-				if (cMax == rgb.r) {
-					hsl.h = (rgb.g - rgb.b) / delta;
-				}
-				else if (cMax == rgb.g) {
-					hsl.h = 2.0f + ((rgb.b - rgb.r) / delta);
-				}
-				else if (cMax == rgb.b) {
-					hsl.h = 4.0f + ((rgb.r - rgb.g) / delta);
-				}
-			}
-
-			hsl.h = (hsl.h * 60.0f) * .0027777777777f;
-			if (hsl.h < 0)
-				hsl.h++;
-
-			hsl.a = rgb.a;
-			return hsl;
+			// The divisor is only 0 for black and white, where delta is 0 as well
+			return HSL(hue, delta / (1.0f - fabsf(2.0f * l - 1.0f) + 1e-20f), l, rgb.a);
 		}
 		CMYK RGB_TO_CMYK(RGB rgb)
 		{
@@ -458,7 +707,8 @@ namespace ZCPP
 			float ik;
 
 			cmyk.k = 1.0f - max(max(rgb.r, rgb.g), rgb.b);
-			ik = 1.0f / (1.0f - cmyk.k);
+			// Pure black has no ink ratio; 0 instead of 0 / 0
+			ik = cmyk.k < 1.0f ? 1.0f / (1.0f - cmyk.k) : 0.0f;
 
 			cmyk.c = (1.0f - rgb.r - cmyk.k) * ik;
 			cmyk.m = (1.0f - rgb.g - cmyk.k) * ik;
@@ -493,37 +743,12 @@ namespace ZCPP
 		}
 		RGB HSV_TO_RGB(HSV hsv)
 		{
-			RGB rgb;
-
-			float h = mod(hsv.h, 1.0f) * 360.0f;
+			float r, g, b;
+			hue_channels(hsv.h, r, g, b);
 
 			float C = hsv.s * hsv.v;
-			float X = C * (1.0f - abs(mod(h * 0.01666666666f, 2) - 1.0f));
 			float m = hsv.v - C;
-
-			if (h >= 0.0f && h < 60.0f) {
-				rgb = RGB(C, X, 0.0f);
-			}
-			else if (h >= 60.0f && h < 120.0f) {
-				rgb = RGB(X, C, 0.0f);
-			}
-			else if (h >= 120.0f && h < 180.0f) {
-				rgb = RGB(0.0f, C, X);
-			}
-			else if (h >= 180.0f && h < 240.0f) {
-				rgb = RGB(0.0f, X, C);
-			}
-			else if (h >= 240.0f && h < 300.0f) {
-				rgb = RGB(X, 0.0f, C);
-			}
-			else {
-				rgb = RGB(C, 0.0f, X);
-			}
-
-			rgb = RGB(rgb.r + m, rgb.g + m, rgb.b + m);
-
-			rgb.a = hsv.a;
-			return rgb;
+			return RGB(m + C * r, m + C * g, m + C * b, hsv.a);
 		}
 		HSL HSV_TO_HSL(HSV hsv)
 		{
@@ -571,39 +796,12 @@ namespace ZCPP
 		}
 		RGB HSL_TO_RGB(HSL hsl)
 		{
-			RGB rgb;
-
-			float h = mod(hsl.h, 1.0f) * 360.0f;
-			float s = hsl.s;
-			float l = hsl.l;
-
-			float C = (1.0f - abs(2.0f * l - 1.0f)) * s;
-			float X = C * (1.0f - abs(mod(h * 0.01666666666f, 2) - 1.0f));
-			float m = l - C * 0.5f;
-
-			if (h >= 0 && h < 60) {
-				rgb = RGB(C, X, 0.0f);
-			}
-			else if (h >= 60 && h < 120) {
-				rgb = RGB(X, C, 0.0f);
-			}
-			else if (h >= 120 && h < 180) {
-				rgb = RGB(0.0f, C, X);
-			}
-			else if (h >= 180 && h < 240) {
-				rgb = RGB(0.0f, X, C);
-			}
-			else if (h >= 240 && h < 300) {
-				rgb = RGB(X, 0.0f, C);
-			}
-			else {
-				rgb = RGB(C, 0.0f, X);
-			}
+			float r, g, b;
+			hue_channels(hsl.h, r, g, b);
 
-			rgb = RGB(rgb.r + m, rgb.g + m, rgb.b + m);
-
-			rgb.a = hsl.a;
-			return rgb;
+			float C = (1.0f - abs(2.0f * hsl.l - 1.0f)) * hsl.s;
+			float m = hsl.l - C * 0.5f;
+			return RGB(m + C * r, m + C * g, m + C * b, hsl.a);
 		}
 		HSV HSL_TO_HSV(HSL hsl)
 		{
@@ -680,6 +878,69 @@ namespace ZCPP
 			return os;
 		}
 
+		// < HSV32 >
+
+		RGB32 HSV32_TO_RGB32(HSV32 hsv32)
+		{
+			int v = hsv32.v, s = hsv32.s;
+
+			if (s == 0)
+				return RGB32(hsv32.v, hsv32.v, hsv32.v, hsv32.a);
+
+			int h6 = hsv32.h * 6;
+			int f = h6 & 255;
+
+			BYTE p = static_cast<BYTE>(div255(v * (255 - s)));
+			BYTE q = static_cast<BYTE>(div255(v * (255 - div255(s * f))));
+			BYTE t = static_cast<BYTE>(div255(v * (255 - div255(s * (255 - f)))));
+
+			switch (h6 >> 8) {
+			case 0: return RGB32(hsv32.v, t, p, hsv32.a);
+			case 1: return RGB32(q, hsv32.v, p, hsv32.a);
+			case 2: return RGB32(p, hsv32.v, t, hsv32.a);
+			case 3: return RGB32(p, q, hsv32.v, hsv32.a);
+			case 4: return RGB32(t, p, hsv32.v, hsv32.a);
+			default: return RGB32(hsv32.v, p, q, hsv32.a);
+			}
+		}
+		std::ostream& operator << (std::ostream& os, const HSV32& hsv32)
+		{
+			os << "H: " << (int)hsv32.h << " S: " << (int)hsv32.s << " V: " << (int)hsv32.v << " A: " << (int)hsv32.a;
+			return os;
+		}
+
+		// < HSL32 >
+
+		RGB32 HSL32_TO_RGB32(HSL32 hsl32)
+		{
+			int l = hsl32.l;
+
+			int h6 = hsl32.h * 6;
+			int f = h6 & 255;
+
+			int C = div255((255 - std::abs(2 * l - 255)) * hsl32.s);
+			int X = div255(C * ((h6 & 256) ? 255 - f : f));
+			int m = l - ((C + 1) >> 1);
+
+			BYTE c = static_cast<BYTE>(std::clamp(C + m, 0, 255));
+			BYTE x = static_cast<BYTE>(std::clamp(X + m, 0, 255));
+			BYTE o = static_cast<BYTE>(std::clamp(m, 0, 255));
+
+			switch (h6 >> 8) {
+			case 0: return RGB32(c, x, o, hsl32.a);
+			case 1: return RGB32(x, c, o, hsl32.a);
+			case 2: return RGB32(o, c, x, hsl32.a);
+			case 3: return RGB32(o, x, c, hsl32.a);
+			case 4: return RGB32(x, o, c, hsl32.a);
+			default: return RGB32(c, o, x, hsl32.a);
+			}
+		}
+		std::ostream& operator << (std::ostream& os, const HSL32& hsl32)
+		{
+			os << "H: " << (int)hsl32.h << " S: " << (int)hsl32.s << " L: " << (int)hsl32.l << " A: " << (int)hsl32.a;
+			return os;
+		}
+
 		// < Conversions >
 
 		RGB32 To_grayscale(RGB32 rgb32) { return RGB32_TO_GRAYSCALE(rgb32); }
@@ -692,6 +953,8 @@ namespace ZCPP
 		RGB32 To_RGB32(HSV hsv) { return HSV_TO_RGB32(hsv); }
 		RGB32 To_RGB32(HSL hsl) { return HSL_TO_RGB32(hsl); }
 		RGB32 To_RGB32(CMYK cmyk) { return CMYK_TO_RGB32(cmyk); }
+		RGB32 To_RGB32(HSV32 hsv32) { return HSV32_TO_RGB32(hsv32); }
+		RGB32 To_RGB32(HSL32 hsl32) { return HSL32_TO_RGB32(hsl32); }
 
 		RGB To_RGB(RGB32 rgb32) { return RGB32_TO_RGB(rgb32); }
 		RGB To_RGB(HSV hsv) { return HSV_TO_RGB(hsv); }
@@ -712,5 +975,5111 @@ namespace ZCPP
 		CMYK To_CMYK(RGB rgb) { return RGB_TO_CMYK(rgb); }
 		CMYK To_CMYK(HSV hsv) { return HSV_TO_CMYK(hsv); }
 		CMYK To_CMYK(HSL hsl) { return HSL_TO_CMYK(hsl); }
+
+		HSV32 To_HSV32(RGB32 rgb32) { return RGB32_TO_HSV32(rgb32); }
+		HSL32 To_HSL32(RGB32 rgb32) { return RGB32_TO_HSL32(rgb32); }
+
+		Lab To_Lab(RGB32 rgb32) { return RGB32_TO_LAB(rgb32); }
+		Lab To_Lab(RGB rgb) { return RGB_TO_LAB(rgb); }
+
+		OKLab To_OKLab(RGB32 rgb32) { return RGB32_TO_OKLAB(rgb32); }
+		OKLab To_OKLab(RGB rgb) { return RGB_TO_OKLAB(rgb); }
+		OKLab To_OKLab(OKLCh oklch) { return OKLCH_TO_OKLAB(oklch); }
+
+		OKLCh To_OKLCh(RGB32 rgb32) { return OKLAB_TO_OKLCH(RGB32_TO_OKLAB(rgb32)); }
+		OKLCh To_OKLCh(RGB rgb) { return OKLAB_TO_OKLCH(RGB_TO_OKLAB(rgb)); }
+		OKLCh To_OKLCh(OKLab oklab) { return OKLAB_TO_OKLCH(oklab); }
+
+		RGB32 To_RGB32(Lab lab) { return LAB_TO_RGB32(lab); }
+		RGB32 To_RGB32(OKLab oklab) { return OKLAB_TO_RGB32(oklab); }
+		RGB32 To_RGB32(OKLCh oklch) { return OKLAB_TO_RGB32(OKLCH_TO_OKLAB(oklch)); }
+
+		RGB To_RGB(Lab lab) { return LAB_TO_RGB(lab); }
+		RGB To_RGB(OKLab oklab) { return OKLAB_TO_RGB(oklab); }
+		RGB To_RGB(OKLCh oklch) { return OKLAB_TO_RGB(OKLCH_TO_OKLAB(oklch)); }
+
+		// /-----------------------------------------------\
+		// | SIMD Lane Types                               |
+		// \-----------------------------------------------/
+
+		namespace SIMD
+		{
+#if defined(ZCPP_COLOR_AVX2)
+			// < 8 floats per register >
+			struct Float
+			{
+				__m256 v;
+				static constexpr size_t width = 8;
+
+				Float() : v(_mm256_setzero_ps()) {}
+				Float(__m256 x) : v(x) {}
+				Float(float x) : v(_mm256_set1_ps(x)) {}
+
+				static Float Load(const float* p) { return _mm256_loadu_ps(p); }
+				void Store(float* p) const { _mm256_storeu_ps(p, v); }
+			};
+
+			inline Float operator + (Float a, Float b) { return _mm256_add_ps(a.v, b.v); }
+			inline Float operator - (Float a, Float b) { return _mm256_sub_ps(a.v, b.v); }
+			inline Float operator * (Float a, Float b) { return _mm256_mul_ps(a.v, b.v); }
+			inline Float operator / (Float a, Float b) { return _mm256_div_ps(a.v, b.v); }
+			inline Float operator & (Float a, Float b) { return _mm256_and_ps(a.v, b.v); }
+			inline Float operator | (Float a, Float b) { return _mm256_or_ps(a.v, b.v); }
+
+			inline Float operator == (Float a, Float b) { return _mm256_cmp_ps(a.v, b.v, _CMP_EQ_OQ); }
+			inline Float operator < (Float a, Float b) { return _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ); }
+			inline Float operator <= (Float a, Float b) { return _mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ); }
+			inline Float operator > (Float a, Float b) { return _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ); }
+			inline Float operator >= (Float a, Float b) { return _mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ); }
+
+			// Same operand order as Color::max / Color::min
+			inline Float Max(Float a, Float b) { return _mm256_max_ps(a.v, b.v); }
+			inline Float Min(Float a, Float b) { return _mm256_min_ps(a.v, b.v); }
+			inline Float Abs(Float a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v); }
+			inline Float Trunc(Float a) { return _mm256_round_ps(a.v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC); }
+			inline Float Floor(Float a) { return _mm256_floor_ps(a.v); }
+			// mask ? a : b
+			inline Float Select(Float mask, Float a, Float b) { return _mm256_blendv_ps(b.v, a.v, mask.v); }
+#elif defined(ZCPP_COLOR_SSE2)
+			// < 4 floats per register >
+			struct Float
+			{
+				__m128 v;
+				static constexpr size_t width = 4;
+
+				Float() : v(_mm_setzero_ps()) {}
+				Float(__m128 x) : v(x) {}
+				Float(float x) : v(_mm_set1_ps(x)) {}
+
+				static Float Load(const float* p) { return _mm_loadu_ps(p); }
+				void Store(float* p) const { _mm_storeu_ps(p, v); }
+			};
+
+			inline Float operator + (Float a, Float b) { return _mm_add_ps(a.v, b.v); }
+			inline Float operator - (Float a, Float b) { return _mm_sub_ps(a.v, b.v); }
+			inline Float operator * (Float a, Float b) { return _mm_mul_ps(a.v, b.v); }
+			inline Float operator / (Float a, Float b) { return _mm_div_ps(a.v, b.v); }
+			inline Float operator & (Float a, Float b) { return _mm_and_ps(a.v, b.v); }
+			inline Float operator | (Float a, Float b) { return _mm_or_ps(a.v, b.v); }
+
+			inline Float operator == (Float a, Float b) { return _mm_cmpeq_ps(a.v, b.v); }
+			inline Float operator < (Float a, Float b) { return _mm_cmplt_ps(a.v, b.v); }
+			inline Float operator <= (Float a, Float b) { return _mm_cmple_ps(a.v, b.v); }
+			inline Float operator > (Float a, Float b) { return _mm_cmpgt_ps(a.v, b.v); }
+			inline Float operator >= (Float a, Float b) { return _mm_cmpge_ps(a.v, b.v); }
+
+			// Same operand order as Color::max / Color::min
+			inline Float Max(Float a, Float b) { return _mm_max_ps(a.v, b.v); }
+			inline Float Min(Float a, Float b) { return _mm_min_ps(a.v, b.v); }
+			inline Float Abs(Float a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v); }
+			// Only valid for |a| < 2^31, which covers every color channel
+			inline Float Trunc(Float a) { return _mm_cvtepi32_ps(_mm_cvttps_epi32(a.v)); }
+			inline Float Floor(Float a) { Float t = Trunc(a); return t - (_mm_and_ps((a < t).v, _mm_set1_ps(1.0f))); }
+			// mask ? a : b
+			inline Float Select(Float mask, Float a, Float b) { return _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v)); }
+#else
+			// < Scalar fallback, 1 float per "register" >
+			struct Float
+			{
+				float v;
+				static constexpr size_t width = 1;
+
+				Float() : v(0.0f) {}
+				Float(float x) : v(x) {}
+
+				static Float Load(const float* p) { return *p; }
+				void Store(float* p) const { *p = v; }
+			};
+
+			// Masks are 1.0f / 0.0f here, only ever consumed by Select, & and |
+			inline Float Mask(bool b) { return b ? 1.0f : 0.0f; }
+			inline bool Bit(Float a) { return a.v != 0.0f; }
+
+			inline Float operator + (Float a, Float b) { return a.v + b.v; }
+			inline Float operator - (Float a, Float b) { return a.v - b.v; }
+			inline Float operator * (Float a, Float b) { return a.v * b.v; }
+			inline Float operator / (Float a, Float b) { return a.v / b.v; }
+			inline Float operator & (Float a, Float b) { return Mask(Bit(a) && Bit(b)); }
+			inline Float operator | (Float a, Float b) { return Mask(Bit(a) || Bit(b)); }
+
+			inline Float operator == (Float a, Float b) { return Mask(a.v == b.v); }
+			inline Float operator < (Float a, Float b) { return Mask(a.v < b.v); }
+			inline Float operator <= (Float a, Float b) { return Mask(a.v <= b.v); }
+			inline Float operator > (Float a, Float b) { return Mask(a.v > b.v); }
+			inline Float operator >= (Float a, Float b) { return Mask(a.v >= b.v); }
+
+			inline Float Max(Float a, Float b) { return max(a.v, b.v); }
+			inline Float Min(Float a, Float b) { return min(a.v, b.v); }
+			inline Float Abs(Float a) { return abs(a.v); }
+			inline Float Trunc(Float a) { return truncf(a.v); }
+			inline Float Floor(Float a) { return floorf(a.v); }
+			inline Float Select(Float mask, Float a, Float b) { return Bit(mask) ? a : b; }
+#endif
+
+			// Reads one float out of every stride floats
+			inline Float Gather(const float* base, size_t stride)
+			{
+				alignas(32) float t[Float::width];
+				for (size_t i = 0; i < Float::width; i++)
+					t[i] = base[i * stride];
+				return Float::Load(t);
+			}
+
+			// Reads base[index] per lane, index holding whole numbers below 2^24
+			inline Float Gather_Index(const float* base, Float index)
+			{
+#if defined(ZCPP_COLOR_AVX2)
+				return _mm256_i32gather_ps(base, _mm256_cvttps_epi32(index.v), 4);
+#else
+				alignas(32) float t[Float::width];
+				index.Store(t);
+				for (size_t i = 0; i < Float::width; i++)
+					t[i] = base[static_cast<size_t>(t[i])];
+				return Float::Load(t);
+#endif
+			}
+
+			// Writes one float into every stride floats
+			inline void Scatter(float* base, size_t stride, Float x)
+			{
+				alignas(32) float t[Float::width];
+				x.Store(t);
+				for (size_t i = 0; i < Float::width; i++)
+					base[i * stride] = t[i];
+			}
+
+			// < Channel-per-register color blocks (Float::width pixels each) >
+
+			struct RGB { Float r, g, b, a; };
+			struct HSV { Float h, s, v, a; };
+			struct HSL { Float h, s, l, a; };
+			struct CMYK { Float c, m, y, k, a; };
+			struct Lab { Float l, a, b, alpha; };
+			struct OKLab { Float l, a, b, alpha; };
+
+			// Loads Float::width interleaved 4-float pixels into one register per channel
+			inline void Load4(const float* p, Float& x, Float& y, Float& z, Float& w)
+			{
+#if defined(ZCPP_COLOR_AVX2)
+				__m128 a0 = _mm_loadu_ps(p + 0), a1 = _mm_loadu_ps(p + 4), a2 = _mm_loadu_ps(p + 8), a3 = _mm_loadu_ps(p + 12);
+				__m128 b0 = _mm_loadu_ps(p + 16), b1 = _mm_loadu_ps(p + 20), b2 = _mm_loadu_ps(p + 24), b3 = _mm_loadu_ps(p + 28);
+				_MM_TRANSPOSE4_PS(a0, a1, a2, a3);
+				_MM_TRANSPOSE4_PS(b0, b1, b2, b3);
+				x = _mm256_set_m128(b0, a0);
+				y = _mm256_set_m128(b1, a1);
+				z = _mm256_set_m128(b2, a2);
+				w = _mm256_set_m128(b3, a3);
+#elif defined(ZCPP_COLOR_SSE2)
+				__m128 a0 = _mm_loadu_ps(p + 0), a1 = _mm_loadu_ps(p + 4), a2 = _mm_loadu_ps(p + 8), a3 = _mm_loadu_ps(p + 12);
+				_MM_TRANSPOSE4_PS(a0, a1, a2, a3);
+				x = a0; y = a1; z = a2; w = a3;
+#else
+				x = Gather(p + 0, 4); y = Gather(p + 1, 4); z = Gather(p + 2, 4); w = Gather(p + 3, 4);
+#endif
+			}
+
+			// Inverse of Load4
+			inline void Store4(float* p, Float x, Float y, Float z, Float w)
+			{
+#if defined(ZCPP_COLOR_AVX2)
+				__m128 a0 = _mm256_castps256_ps128(x.v), a1 = _mm256_castps256_ps128(y.v);
+				__m128 a2 = _mm256_castps256_ps128(z.v), a3 = _mm256_castps256_ps128(w.v);
+				__m128 b0 = _mm256_extractf128_ps(x.v, 1), b1 = _mm256_extractf128_ps(y.v, 1);
+				__m128 b2 = _mm256_extractf128_ps(z.v, 1), b3 = _mm256_extractf128_ps(w.v, 1);
+				_MM_TRANSPOSE4_PS(a0, a1, a2, a3);
+				_MM_TRANSPOSE4_PS(b0, b1, b2, b3);
+				_mm_storeu_ps(p + 0, a0); _mm_storeu_ps(p + 4, a1); _mm_storeu_ps(p + 8, a2); _mm_storeu_ps(p + 12, a3);
+				_mm_storeu_ps(p + 16, b0); _mm_storeu_ps(p + 20, b1); _mm_storeu_ps(p + 24, b2); _mm_storeu_ps(p + 28, b3);
+#elif defined(ZCPP_COLOR_SSE2)
+				__m128 a0 = x.v, a1 = y.v, a2 = z.v, a3 = w.v;
+				_MM_TRANSPOSE4_PS(a0, a1, a2, a3);
+				_mm_storeu_ps(p + 0, a0); _mm_storeu_ps(p + 4, a1); _mm_storeu_ps(p + 8, a2); _mm_storeu_ps(p + 12, a3);
+#else
+				Scatter(p + 0, 4, x); Scatter(p + 1, 4, y); Scatter(p + 2, 4, z); Scatter(p + 3, 4, w);
+#endif
+			}
+
+			static_assert(sizeof(Color::RGB) == 4 * sizeof(float), "RGB must be 4 packed floats");
+			static_assert(sizeof(Color::HSV) == 4 * sizeof(float), "HSV must be 4 packed floats");
+			static_assert(sizeof(Color::HSL) == 4 * sizeof(float), "HSL must be 4 packed floats");
+			static_assert(sizeof(Color::CMYK) == 5 * sizeof(float), "CMYK must be 5 packed floats");
+			static_assert(sizeof(Color::Lab) == 4 * sizeof(float), "Lab must be 4 packed floats");
+			static_assert(sizeof(Color::OKLab) == 4 * sizeof(float), "OKLab must be 4 packed floats");
+			static_assert(sizeof(Color::RGB32) == 4, "RGB32 must be 4 packed bytes");
+
+			// < Load / Store >
+
+			// RGB32 channels as floats in 0 - 255
+			inline RGB Load_Bytes(const Color::RGB32* p)
+			{
+				RGB c;
+#if defined(ZCPP_COLOR_AVX2)
+				__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+				__m256i m = _mm256_set1_epi32(0xFF);
+				c.r = _mm256_cvtepi32_ps(_mm256_and_si256(x, m));
+				c.g = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(x, 8), m));
+				c.b = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(x, 16), m));
+				c.a = _mm256_cvtepi32_ps(_mm256_srli_epi32(x, 24));
+#elif defined(ZCPP_COLOR_SSE2)
+				__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+				__m128i m = _mm_set1_epi32(0xFF);
+				c.r = _mm_cvtepi32_ps(_mm_and_si128(x, m));
+				c.g = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(x, 8), m));
+				c.b = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(x, 16), m));
+				c.a = _mm_cvtepi32_ps(_mm_srli_epi32(x, 24));
+#else
+				c.r = static_cast<float>(p->r); c.g = static_cast<float>(p->g);
+				c.b = static_cast<float>(p->b); c.a = static_cast<float>(p->a);
+#endif
+				return c;
+			}
+
+			// RGB32 loads straight into normalized RGB (same math as RGB32_TO_RGB)
+			inline RGB Load(const Color::RGB32* p)
+			{
+				const float i = 1.0 / 255.0;
+				RGB c = Load_Bytes(p);
+				c.r = c.r * i; c.g = c.g * i; c.b = c.b * i; c.a = c.a * i;
+				return c;
+			}
+			inline RGB Load(const Color::RGB* p) { RGB c; Load4(&p->r, c.r, c.g, c.b, c.a); return c; }
+			inline HSV Load(const Color::HSV* p) { HSV c; Load4(&p->h, c.h, c.s, c.v, c.a); return c; }
+			inline HSL Load(const Color::HSL* p) { HSL c; Load4(&p->h, c.h, c.s, c.l, c.a); return c; }
+			inline CMYK Load(const Color::CMYK* p)
+			{
+				const float* f = &p->c;
+				return CMYK{ Gather(f + 0, 5), Gather(f + 1, 5), Gather(f + 2, 5), Gather(f + 3, 5), Gather(f + 4, 5) };
+			}
+			inline Lab Load(const Color::Lab* p) { Lab c; Load4(&p->l, c.l, c.a, c.b, c.alpha); return c; }
+			inline OKLab Load(const Color::OKLab* p) { OKLab c; Load4(&p->l, c.l, c.a, c.b, c.alpha); return c; }
+
+			// Packs channels already in 0 - 255 into RGB32, truncating
+			inline void Store_Bytes(Color::RGB32* p, const RGB& c)
+			{
+#if defined(ZCPP_COLOR_AVX2)
+				__m256i x = _mm256_cvttps_epi32(c.r.v);
+				x = _mm256_or_si256(x, _mm256_slli_epi32(_mm256_cvttps_epi32(c.g.v), 8));
+				x = _mm256_or_si256(x, _mm256_slli_epi32(_mm256_cvttps_epi32(c.b.v), 16));
+				x = _mm256_or_si256(x, _mm256_slli_epi32(_mm256_cvttps_epi32(c.a.v), 24));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(p), x);
+#elif defined(ZCPP_COLOR_SSE2)
+				__m128i x = _mm_cvttps_epi32(c.r.v);
+				x = _mm_or_si128(x, _mm_slli_epi32(_mm_cvttps_epi32(c.g.v), 8));
+				x = _mm_or_si128(x, _mm_slli_epi32(_mm_cvttps_epi32(c.b.v), 16));
+				x = _mm_or_si128(x, _mm_slli_epi32(_mm_cvttps_epi32(c.a.v), 24));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(p), x);
+#else
+				*p = RGB32(static_cast<BYTE>(c.r.v), static_cast<BYTE>(c.g.v), static_cast<BYTE>(c.b.v), static_cast<BYTE>(c.a.v));
+#endif
+			}
+
+			// RGB stores into RGB32 with byte_clamp semantics (clamp, scale, truncate)
+			inline void Store(Color::RGB32* p, const RGB& c)
+			{
+				Float r = Max(Min(c.r, 1.0f), 0.0f) * 255.0f;
+				Float g = Max(Min(c.g, 1.0f), 0.0f) * 255.0f;
+				Float b = Max(Min(c.b, 1.0f), 0.0f) * 255.0f;
+				Float a = Max(Min(c.a, 1.0f), 0.0f) * 255.0f;
+				Store_Bytes(p, RGB{ r, g, b, a });
+			}
+
+			// Same as Store but rounds to the nearest byte instead of truncating
+			inline void Store_Rounded(Color::RGB32* p, const RGB& c)
+			{
+				Float r = Max(Min(c.r, 1.0f), 0.0f) * 255.0f + 0.5f;
+				Float g = Max(Min(c.g, 1.0f), 0.0f) * 255.0f + 0.5f;
+				Float b = Max(Min(c.b, 1.0f), 0.0f) * 255.0f + 0.5f;
+				Float a = Max(Min(c.a, 1.0f), 0.0f) * 255.0f + 0.5f;
+				Store_Bytes(p, RGB{ r, g, b, a });
+			}
+			inline void Store(Color::RGB* p, const RGB& c) { Store4(&p->r, c.r, c.g, c.b, c.a); }
+			inline void Store(Color::HSV* p, const HSV& c) { Store4(&p->h, c.h, c.s, c.v, c.a); }
+			inline void Store(Color::HSL* p, const HSL& c) { Store4(&p->h, c.h, c.s, c.l, c.a); }
+			inline void Store(Color::CMYK* p, const CMYK& c)
+			{
+				float* f = &p->c;
+				Scatter(f + 0, 5, c.c); Scatter(f + 1, 5, c.m); Scatter(f + 2, 5, c.y); Scatter(f + 3, 5, c.k); Scatter(f + 4, 5, c.a);
+			}
+			inline void Store(Color::Lab* p, const Lab& c) { Store4(&p->l, c.l, c.a, c.b, c.alpha); }
+			inline void Store(Color::OKLab* p, const OKLab& c) { Store4(&p->l, c.l, c.a, c.b, c.alpha); }
+
+			// < Conversion kernels (mirror the scalar functions above) >
+
+			// Mirrors float_hue
+			inline Float Hue(const RGB& c)
+			{
+				Float k = Select(c.g < c.b, -1.0f, 0.0f);
+				Float hi = Max(c.g, c.b), lo = Min(c.g, c.b);
+				k = Select(c.r < hi, -1.0f / 3.0f - k, k);
+				Float top = Max(c.r, hi), mid = Min(c.r, hi);
+				return Abs(k + (mid - lo) / (6.0f * (top - Min(mid, lo)) + 1e-20f));
+			}
+
+			// Mirrors hue_channels
+			inline RGB Hue_Channels(Float hue, Float a)
+			{
+				Float h = (hue - Floor(hue)) * 6.0f;
+				return RGB{
+					Min(Max(Abs(h - 3.0f) - 1.0f, 0.0f), 1.0f),
+					Min(Max(2.0f - Abs(h - 2.0f), 0.0f), 1.0f),
+					Min(Max(2.0f - Abs(h - 4.0f), 0.0f), 1.0f),
+					a };
+			}
+
+			inline HSV RGB_TO_HSV(const RGB& c)
+			{
+				Float cMax = Max(Max(c.r, c.g), c.b);
+				Float cMin = Min(Min(c.r, c.g), c.b);
+				Float delta = cMax - cMin;
+				return HSV{ Hue(c), delta / (cMax + 1e-20f), cMax, c.a };
+			}
+			inline HSL RGB_TO_HSL(const RGB& c)
+			{
+				Float cMax = Max(Max(c.r, c.g), c.b);
+				Float cMin = Min(Min(c.r, c.g), c.b);
+				Float delta = cMax - cMin;
+				Float l = (cMax + cMin) * 0.5f;
+				return HSL{ Hue(c), delta / (1.0f - Abs(2.0f * l - 1.0f) + 1e-20f), l, c.a };
+			}
+			inline CMYK RGB_TO_CMYK(const RGB& c)
+			{
+				Float k = 1.0f - Max(Max(c.r, c.g), c.b);
+				Float ik = Select(k < 1.0f, 1.0f / (1.0f - k), Float(0.0f));
+				return CMYK{ (1.0f - c.r - k) * ik, (1.0f - c.g - k) * ik, (1.0f - c.b - k) * ik, k, c.a };
+			}
+			inline RGB HSV_TO_RGB(const HSV& c)
+			{
+				RGB hue = Hue_Channels(c.h, c.a);
+				Float C = c.s * c.v;
+				Float m = c.v - C;
+				return RGB{ m + C * hue.r, m + C * hue.g, m + C * hue.b, c.a };
+			}
+			inline HSL HSV_TO_HSL(const HSV& c)
+			{
+				Float l = (2.0f - c.s) * c.v;
+				Float s = c.s * c.v;
+				s = Select(l <= 1.0f, s / l, s / (2.0f - l));
+				return HSL{ c.h, s, l * 0.5f, c.a };
+			}
+			inline RGB HSL_TO_RGB(const HSL& c)
+			{
+				RGB hue = Hue_Channels(c.h, c.a);
+				Float C = (1.0f - Abs(2.0f * c.l - 1.0f)) * c.s;
+				Float m = c.l - C * 0.5f;
+				return RGB{ m + C * hue.r, m + C * hue.g, m + C * hue.b, c.a };
+			}
+			inline HSV HSL_TO_HSV(const HSL& c)
+			{
+				Float l = c.l * 2.0f;
+				Float s = Select(l <= 1.0f, c.s * l, c.s * (2.0f - l));
+				return HSV{ c.h, (2.0f * s) / (l + s), (l + s) * 0.5f, c.a };
+			}
+			inline RGB CMYK_TO_RGB(const CMYK& c)
+			{
+				Float ik = 1.0f - c.k;
+				return RGB{ (1.0f - c.c) * ik, (1.0f - c.m) * ik, (1.0f - c.y) * ik, c.a };
+			}
+		}
+
+		// /-----------------------------------------------\
+		// | Bulk Conversions                              |
+		// \-----------------------------------------------/
+
+		// Converts min(src.size(), dst.size()) pixels, SIMD::Float::width at a time.
+		// The tail falls back to the scalar function, so results match it within float rounding.
+		template<typename From, typename To, typename Scalar, typename Vector>
+		void Convert_Batch(std::span<const From> src, std::span<To> dst, Scalar scalar, Vector vector)
+		{
+			const size_t count = std::min(src.size(), dst.size());
+			const size_t width = SIMD::Float::width;
+			size_t i = 0;
+
+			if (width > 1) {
+				for (; i + width <= count; i += width)
+					SIMD::Store(dst.data() + i, vector(SIMD::Load(src.data() + i)));
+			}
+
+			for (; i < count; i++)
+				dst[i] = scalar(src[i]);
+		}
+
+		// < RGB32 >
+
+		inline void Convert(std::span<const RGB32> src, std::span<RGB> dst) { Convert_Batch(src, dst, RGB32_TO_RGB, [](const SIMD::RGB& c) { return c; }); }
+		inline void Convert(std::span<const RGB32> src, std::span<HSV> dst) { Convert_Batch(src, dst, RGB32_TO_HSV, SIMD::RGB_TO_HSV); }
+		inline void Convert(std::span<const RGB32> src, std::span<HSL> dst) { Convert_Batch(src, dst, RGB32_TO_HSL, SIMD::RGB_TO_HSL); }
+		inline void Convert(std::span<const RGB32> src, std::span<CMYK> dst) { Convert_Batch(src, dst, RGB32_TO_CMYK, SIMD::RGB_TO_CMYK); }
+
+		// < RGB >
+
+		inline void Convert(std::span<const RGB> src, std::span<RGB32> dst) { Convert_Batch(src, dst, RGB_TO_RGB32, [](const SIMD::RGB& c) { return c; }); }
+		inline void Convert(std::span<const RGB> src, std::span<HSV> dst) { Convert_Batch(src, dst, RGB_TO_HSV, SIMD::RGB_TO_HSV); }
+		inline void Convert(std::span<const RGB> src, std::span<HSL> dst) { Convert_Batch(src, dst, RGB_TO_HSL, SIMD::RGB_TO_HSL); }
+		inline void Convert(std::span<const RGB> src, std::span<CMYK> dst) { Convert_Batch(src, dst, RGB_TO_CMYK, SIMD::RGB_TO_CMYK); }
+
+		// < HSV >
+
+		inline void Convert(std::span<const HSV> src, std::span<RGB32> dst) { Convert_Batch(src, dst, HSV_TO_RGB32, SIMD::HSV_TO_RGB); }
+		inline void Convert(std::span<const HSV> src, std::span<RGB> dst) { Convert_Batch(src, dst, HSV_TO_RGB, SIMD::HSV_TO_RGB); }
+		inline void Convert(std::span<const HSV> src, std::span<HSL> dst) { Convert_Batch(src, dst, HSV_TO_HSL, SIMD::HSV_TO_HSL); }
+		inline void Convert(std::span<const HSV> src, std::span<CMYK> dst) { Convert_Batch(src, dst, HSV_TO_CMYK, [](const SIMD::HSV& c) { return SIMD::RGB_TO_CMYK(SIMD::HSV_TO_RGB(c)); }); }
+
+		// < HSL >
+
+		inline void Convert(std::span<const HSL> src, std::span<RGB32> dst) { Convert_Batch(src, dst, HSL_TO_RGB32, SIMD::HSL_TO_RGB); }
+		inline void Convert(std::span<const HSL> src, std::span<RGB> dst) { Convert_Batch(src, dst, HSL_TO_RGB, SIMD::HSL_TO_RGB); }
+		inline void Convert(std::span<const HSL> src, std::span<HSV> dst) { Convert_Batch(src, dst, HSL_TO_HSV, SIMD::HSL_TO_HSV); }
+		inline void Convert(std::span<const HSL> src, std::span<CMYK> dst) { Convert_Batch(src, dst, HSL_TO_CMYK, [](const SIMD::HSL& c) { return SIMD::RGB_TO_CMYK(SIMD::HSL_TO_RGB(c)); }); }
+
+		// < CMYK >
+
+		inline void Convert(std::span<const CMYK> src, std::span<RGB32> dst) { Convert_Batch(src, dst, CMYK_TO_RGB32, SIMD::CMYK_TO_RGB); }
+		inline void Convert(std::span<const CMYK> src, std::span<RGB> dst) { Convert_Batch(src, dst, CMYK_TO_RGB, SIMD::CMYK_TO_RGB); }
+		inline void Convert(std::span<const CMYK> src, std::span<HSV> dst) { Convert_Batch(src, dst, CMYK_TO_HSV, [](const SIMD::CMYK& c) { return SIMD::RGB_TO_HSV(SIMD::CMYK_TO_RGB(c)); }); }
+		inline void Convert(std::span<const CMYK> src, std::span<HSL> dst) { Convert_Batch(src, dst, CMYK_TO_HSL, [](const SIMD::CMYK& c) { return SIMD::RGB_TO_HSL(SIMD::CMYK_TO_RGB(c)); }); }
+
+		// < 8bit integer paths >
+
+		// Integer-only conversions need no float lanes; plain loops the compiler is free to unroll
+		template<typename From, typename To, typename Scalar>
+		void Convert_Each(std::span<const From> src, std::span<To> dst, Scalar scalar)
+		{
+			const size_t count = std::min(src.size(), dst.size());
+			for (size_t i = 0; i < count; i++)
+				dst[i] = scalar(src[i]);
+		}
+
+		inline void Convert(std::span<const RGB32> src, std::span<HSV32> dst) { Convert_Each(src, dst, RGB32_TO_HSV32); }
+		inline void Convert(std::span<const RGB32> src, std::span<HSL32> dst) { Convert_Each(src, dst, RGB32_TO_HSL32); }
+		inline void Convert(std::span<const HSV32> src, std::span<RGB32> dst) { Convert_Each(src, dst, HSV32_TO_RGB32); }
+		inline void Convert(std::span<const HSL32> src, std::span<RGB32> dst) { Convert_Each(src, dst, HSL32_TO_RGB32); }
+
+		// Q16 grayscale over a whole buffer, identical to RGB32_TO_GRAYSCALE per pixel
+		inline void To_grayscale(std::span<const RGB32> src, std::span<RGB32> dst)
+		{
+			const size_t count = std::min(src.size(), dst.size());
+			size_t i = 0;
+#if defined(ZCPP_COLOR_AVX2)
+			const __m256i mask = _mm256_set1_epi32(0xFF);
+			const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+			const __m256i wr = _mm256_set1_epi32(LUMA_R_Q16);
+			const __m256i wg = _mm256_set1_epi32(LUMA_G_Q16);
+			const __m256i wb = _mm256_set1_epi32(LUMA_B_Q16);
+			const __m256i splat = _mm256_set1_epi32(0x010101);
+
+			for (; i + 8 <= count; i += 8) {
+				__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src.data() + i));
+				__m256i y = _mm256_mullo_epi32(_mm256_and_si256(x, mask), wr);
+				y = _mm256_add_epi32(y, _mm256_mullo_epi32(_mm256_and_si256(_mm256_srli_epi32(x, 8), mask), wg));
+				y = _mm256_add_epi32(y, _mm256_mullo_epi32(_mm256_and_si256(_mm256_srli_epi32(x, 16), mask), wb));
+				y = _mm256_mullo_epi32(_mm256_srli_epi32(y, 16), splat);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst.data() + i), _mm256_or_si256(y, _mm256_and_si256(x, alpha)));
+			}
+#endif
+			for (; i < count; i++)
+				dst[i] = RGB32_TO_GRAYSCALE(src[i]);
+		}
+
+		// /-----------------------------------------------\
+		// | Planar Images                                 |
+		// \-----------------------------------------------/
+
+		// < Allocator handing out Alignment-byte aligned storage >
+		template<typename Type, size_t Alignment = 64>
+		class Aligned_Allocator
+		{
+		public:
+			typedef Type value_type;
+
+			template<typename Other>
+			struct rebind { typedef Aligned_Allocator<Other, Alignment> other; };
+
+			Aligned_Allocator() {}
+			template<typename Other>
+			Aligned_Allocator(const Aligned_Allocator<Other, Alignment>&) {}
+
+			Type* allocate(size_t count) { return static_cast<Type*>(::operator new(count * sizeof(Type), std::align_val_t(Alignment))); }
+			void deallocate(Type* p, size_t) { ::operator delete(p, std::align_val_t(Alignment)); }
+
+			template<typename Other>
+			bool operator == (const Aligned_Allocator<Other, Alignment>&) const { return true; }
+			template<typename Other>
+			bool operator != (const Aligned_Allocator<Other, Alignment>&) const { return false; }
+		};
+
+		// < Channel layout of each float color class >
+		template<typename ColorSpace>
+		struct Planar_Traits;
+
+		template<>
+		struct Planar_Traits<RGB>
+		{
+			typedef SIMD::RGB Block;
+			static constexpr size_t channels = 4;
+			static constexpr float RGB::* scalar[channels] = { &RGB::r, &RGB::g, &RGB::b, &RGB::a };
+			static constexpr SIMD::Float Block::* vector[channels] = { &Block::r, &Block::g, &Block::b, &Block::a };
+
+			static Block From_RGB(const SIMD::RGB& c) { return c; }
+			static SIMD::RGB To_RGB(const Block& c) { return c; }
+			static RGB From_RGB32(RGB32 c) { return RGB32_TO_RGB(c); }
+			static RGB32 To_RGB32(RGB c) { return RGB_TO_RGB32(c); }
+		};
+
+		template<>
+		struct Planar_Traits<HSV>
+		{
+			typedef SIMD::HSV Block;
+			static constexpr size_t channels = 4;
+			static constexpr float HSV::* scalar[channels] = { &HSV::h, &HSV::s, &HSV::v, &HSV::a };
+			static constexpr SIMD::Float Block::* vector[channels] = { &Block::h, &Block::s, &Block::v, &Block::a };
+
+			static Block From_RGB(const SIMD::RGB& c) { return SIMD::RGB_TO_HSV(c); }
+			static SIMD::RGB To_RGB(const Block& c) { return SIMD::HSV_TO_RGB(c); }
+			static HSV From_RGB32(RGB32 c) { return RGB32_TO_HSV(c); }
+			static RGB32 To_RGB32(HSV c) { return HSV_TO_RGB32(c); }
+		};
+
+		template<>
+		struct Planar_Traits<HSL>
+		{
+			typedef SIMD::HSL Block;
+			static constexpr size_t channels = 4;
+			static constexpr float HSL::* scalar[channels] = { &HSL::h, &HSL::s, &HSL::l, &HSL::a };
+			static constexpr SIMD::Float Block::* vector[channels] = { &Block::h, &Block::s, &Block::l, &Block::a };
+
+			static Block From_RGB(const SIMD::RGB& c) { return SIMD::RGB_TO_HSL(c); }
+			static SIMD::RGB To_RGB(const Block& c) { return SIMD::HSL_TO_RGB(c); }
+			static HSL From_RGB32(RGB32 c) { return RGB32_TO_HSL(c); }
+			static RGB32 To_RGB32(HSL c) { return HSL_TO_RGB32(c); }
+		};
+
+		template<>
+		struct Planar_Traits<CMYK>
+		{
+			typedef SIMD::CMYK Block;
+			static constexpr size_t channels = 5;
+			static constexpr float CMYK::* scalar[channels] = { &CMYK::c, &CMYK::m, &CMYK::y, &CMYK::k, &CMYK::a };
+			static constexpr SIMD::Float Block::* vector[channels] = { &Block::c, &Block::m, &Block::y, &Block::k, &Block::a };
+
+			static Block From_RGB(const SIMD::RGB& c) { return SIMD::RGB_TO_CMYK(c); }
+			static SIMD::RGB To_RGB(const Block& c) { return SIMD::CMYK_TO_RGB(c); }
+			static CMYK From_RGB32(RGB32 c) { return RGB32_TO_CMYK(c); }
+			static RGB32 To_RGB32(CMYK c) { return CMYK_TO_RGB32(c); }
+		};
+
+		// < Structure-of-arrays image, one 64 byte aligned plane per channel >
+		// Each plane is padded to a whole number of cache lines, so kernels
+		// can always run full SIMD::Float registers without a scalar tail.
+		template<typename ColorSpace>
+		class PlanarImage
+		{
+		public:
+			typedef Planar_Traits<ColorSpace> Traits;
+			typedef typename Traits::Block Block;
+			static constexpr size_t channels = Traits::channels;
+			static constexpr size_t alignment = 64;
+
+		private:
+			size_t width;
+			size_t height;
+			size_t stride;
+			std::vector<float, Aligned_Allocator<float, alignment>> data;
+
+		public:
+			PlanarImage() : width(0), height(0), stride(0) {}
+			PlanarImage(size_t width, size_t height) { Resize(width, height); }
+
+			void Resize(size_t width, size_t height)
+			{
+				const size_t line = alignment / sizeof(float);
+				this->width = width;
+				this->height = height;
+				this->stride = (width * height + line - 1) / line * line;
+				this->data.assign(channels * stride, 0.0f);
+			}
+
+			size_t Width() const { return width; }
+			size_t Height() const { return height; }
+			// Pixel count
+			size_t Size() const { return width * height; }
+			// Floats per plane, including padding
+			size_t Stride() const { return stride; }
+
+			float* Plane(size_t channel) { return data.data() + channel * stride; }
+			const float* Plane(size_t channel) const { return data.data() + channel * stride; }
+
+			ColorSpace Get(size_t index) const
+			{
+				ColorSpace c;
+				for (size_t ch = 0; ch < channels; ch++)
+					c.*Traits::scalar[ch] = Plane(ch)[index];
+				return c;
+			}
+			ColorSpace Get(size_t x, size_t y) const { return Get(y * width + x); }
+
+			void Set(size_t index, const ColorSpace& c)
+			{
+				for (size_t ch = 0; ch < channels; ch++)
+					Plane(ch)[index] = c.*Traits::scalar[ch];
+			}
+			void Set(size_t x, size_t y, const ColorSpace& c) { Set(y * width + x, c); }
+
+			// Loads SIMD::Float::width pixels starting at index (may reach into the padding)
+			Block Load(size_t index) const
+			{
+				Block b;
+				for (size_t ch = 0; ch < channels; ch++)
+					b.*Traits::vector[ch] = SIMD::Float::Load(Plane(ch) + index);
+				return b;
+			}
+
+			void Store(size_t index, const Block& b)
+			{
+				for (size_t ch = 0; ch < channels; ch++)
+					(b.*Traits::vector[ch]).Store(Plane(ch) + index);
+			}
+
+			// Runs fn(Block) -> Block over every register of the image, padding included
+			template<typename Function>
+			void Apply(Function fn)
+			{
+				for (size_t i = 0; i < stride; i += SIMD::Float::width)
+					Store(i, fn(Load(i)));
+			}
+		};
+
+		// < RGB32 interleave / deinterleave >
+
+		// Splits interleaved RGB32 pixels into planes, converting to the image's color space on the way
+		template<typename ColorSpace>
+		void Deinterleave(std::span<const RGB32> src, PlanarImage<ColorSpace>& dst)
+		{
+			typedef Planar_Traits<ColorSpace> Traits;
+			const size_t count = std::min(src.size(), dst.Size());
+			const size_t width = SIMD::Float::width;
+			size_t i = 0;
+
+			for (; i + width <= count; i += width)
+				dst.Store(i, Traits::From_RGB(SIMD::Load(src.data() + i)));
+
+			for (; i < count; i++)
+				dst.Set(i, Traits::From_RGB32(src[i]));
+		}
+
+		// Packs planes back into interleaved RGB32 pixels
+		template<typename ColorSpace>
+		void Interleave(const PlanarImage<ColorSpace>& src, std::span<RGB32> dst)
+		{
+			typedef Planar_Traits<ColorSpace> Traits;
+			const size_t count = std::min(src.Size(), dst.size());
+			const size_t width = SIMD::Float::width;
+			size_t i = 0;
+
+			for (; i + width <= count; i += width)
+				SIMD::Store(dst.data() + i, Traits::To_RGB(src.Load(i)));
+
+			for (; i < count; i++)
+				dst[i] = Traits::To_RGB32(src.Get(i));
+		}
+
+		// < Planar conversions >
+
+		// Converts between color spaces plane to plane; dst is resized to match src.
+		// HSV <-> HSL go direct, every other pair goes through RGB like the scalar table.
+		template<typename From, typename To>
+		void Convert(const PlanarImage<From>& src, PlanarImage<To>& dst)
+		{
+			if (dst.Width() != src.Width() || dst.Height() != src.Height())
+				dst.Resize(src.Width(), src.Height());
+
+			for (size_t i = 0; i < src.Stride(); i += SIMD::Float::width) {
+				if constexpr (std::is_same<From, HSV>::value && std::is_same<To, HSL>::value)
+					dst.Store(i, SIMD::HSV_TO_HSL(src.Load(i)));
+				else if constexpr (std::is_same<From, HSL>::value && std::is_same<To, HSV>::value)
+					dst.Store(i, SIMD::HSL_TO_HSV(src.Load(i)));
+				else
+					dst.Store(i, Planar_Traits<To>::From_RGB(Planar_Traits<From>::To_RGB(src.Load(i))));
+			}
+		}
+
+		// /-----------------------------------------------\
+		// | Threading                                     |
+		// \-----------------------------------------------/
+
+		// Splits [0, count) into one contiguous range per hardware thread and runs fn(begin, end) on each.
+		// Range boundaries are multiples of grain, so SIMD loops only ever see one tail, at the very end.
+		template<typename Function>
+		void Parallel_For(size_t count, size_t grain, Function fn)
+		{
+			grain = std::max<size_t>(grain, 1);
+			size_t threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+			threads = std::min(threads, (count + grain - 1) / grain);
+
+			if (threads <= 1) {
+				fn(static_cast<size_t>(0), count);
+				return;
+			}
+
+			size_t chunk = (count + threads - 1) / threads;
+			chunk = (chunk + grain - 1) / grain * grain;
+
+			std::vector<std::thread> workers;
+			for (size_t begin = chunk; begin < count; begin += chunk)
+				workers.emplace_back(fn, begin, std::min(begin + chunk, count));
+
+			fn(static_cast<size_t>(0), std::min(chunk, count));
+
+			for (std::thread& worker : workers)
+				worker.join();
+		}
+
+		// /-----------------------------------------------\
+		// | 3D LUT Color Grading                          |
+		// \-----------------------------------------------/
+
+		enum class LUT_Interpolation
+		{
+			Trilinear,		// 8 corners per lookup
+			Tetrahedral		// 4 corners per lookup, sharper along the neutral axis
+		};
+
+		// < Size^3 RGB lattice, red varying fastest (same order as .cube files) >
+		class LUT3D
+		{
+		private:
+			size_t size;
+			std::vector<RGB, Aligned_Allocator<RGB>> table;
+			RGB domain_min;
+			RGB domain_max;
+
+			// Lattice coordinate in [0, size - 1] for one channel
+			float Coordinate(float x, float lo, float hi) const
+			{
+				float n = static_cast<float>(size - 1);
+				return std::clamp((x - lo) * (n / (hi - lo)), 0.0f, n);
+			}
+
+			SIMD::Float Coordinate(SIMD::Float x, float lo, float hi) const
+			{
+				float n = static_cast<float>(size - 1);
+				return SIMD::Max(SIMD::Min((x - lo) * (n / (hi - lo)), n), 0.0f);
+			}
+
+			SIMD::RGB Corner(SIMD::Float index) const
+			{
+				const float* base = &table[0].r;
+				SIMD::Float offset = index * 4.0f;
+				return SIMD::RGB{ SIMD::Gather_Index(base + 0, offset), SIMD::Gather_Index(base + 1, offset), SIMD::Gather_Index(base + 2, offset), SIMD::Float(0.0f) };
+			}
+
+		public:
+			// Identity LUT with size^3 entries (size >= 2), 2 by default so Sample() always has a lattice
+			LUT3D() : LUT3D(2) {}
+			explicit LUT3D(size_t size) : domain_min(0.0f, 0.0f, 0.0f), domain_max(1.0f, 1.0f, 1.0f) { Resize(size); }
+
+			void Resize(size_t size)
+			{
+				this->size = std::max<size_t>(size, 2);
+				table.resize(this->size * this->size * this->size);
+
+				float i = 1.0f / static_cast<float>(this->size - 1);
+				for (size_t b = 0; b < this->size; b++)
+					for (size_t g = 0; g < this->size; g++)
+						for (size_t r = 0; r < this->size; r++)
+							At(r, g, b) = RGB(r * i, g * i, b * i);
+			}
+
+			size_t Size() const { return size; }
+			RGB& At(size_t r, size_t g, size_t b) { return table[(b * size + g) * size + r]; }
+			const RGB& At(size_t r, size_t g, size_t b) const { return table[(b * size + g) * size + r]; }
+
+			// Bakes any RGB -> RGB function (a whole grading chain) into a size^3 LUT, one slice per thread
+			template<typename Function>
+			static LUT3D Bake(size_t size, Function fn)
+			{
+				LUT3D lut(size);
+				size_t n = lut.Size();
+				Parallel_For(n, 1, [&](size_t begin, size_t end) {
+					for (size_t b = begin; b < end; b++)
+						for (size_t g = 0; g < n; g++)
+							for (size_t r = 0; r < n; r++) {
+								RGB c = fn(lut.At(r, g, b));
+								lut.At(r, g, b) = RGB(c.r, c.g, c.b);
+							}
+				});
+				return lut;
+			}
+
+			// Reads an Adobe / Resolve .cube 3D LUT, returns false if the stream isn't one
+			bool Load_Cube(std::istream& in)
+			{
+				size_t cube = 0, read = 0;
+				RGB lo(0.0f, 0.0f, 0.0f), hi(1.0f, 1.0f, 1.0f);
+				std::vector<RGB, Aligned_Allocator<RGB>> entries;
+				std::string line;
+
+				while (std::getline(in, line)) {
+					std::istringstream words(line);
+					std::string key;
+					if (!(words >> key) || key[0] == '#')
+						continue;
+
+					if (key == "LUT_3D_SIZE") {
+						// The Adobe spec allows 2 to 256, anything else is a corrupt or hostile file
+						if (cube != 0 || !(words >> cube) || cube < 2 || cube > 256)
+							return false;
+						entries.resize(cube * cube * cube);
+					}
+					else if (key == "DOMAIN_MIN") {
+						if (!(words >> lo.r >> lo.g >> lo.b))
+							return false;
+					}
+					else if (key == "DOMAIN_MAX") {
+						if (!(words >> hi.r >> hi.g >> hi.b))
+							return false;
+					}
+					else if (key == "LUT_1D_SIZE")
+						return false;
+					else if (key == "TITLE" || key == "LUT_3D_INPUT_RANGE")
+						continue;
+					else {
+						RGB c;
+						std::istringstream values(line);
+						if (!(values >> c.r >> c.g >> c.b) || read >= entries.size())
+							return false;
+						entries[read++] = c;
+					}
+				}
+
+				if (cube == 0 || read != entries.size())
+					return false;
+				// Coordinate() divides by hi - lo
+				if (!(lo.r < hi.r && lo.g < hi.g && lo.b < hi.b))
+					return false;
+
+				size = cube;
+				table.swap(entries);
+				domain_min = lo;
+				domain_max = hi;
+				return true;
+			}
+
+			bool Load_Cube(const std::string& path)
+			{
+				std::ifstream file(path);
+				return file && Load_Cube(file);
+			}
+
+			// < Sampling >
+
+			RGB Sample(RGB c, LUT_Interpolation mode = LUT_Interpolation::Tetrahedral) const
+			{
+				float x = Coordinate(c.r, domain_min.r, domain_max.r);
+				float y = Coordinate(c.g, domain_min.g, domain_max.g);
+				float z = Coordinate(c.b, domain_min.b, domain_max.b);
+
+				float n = static_cast<float>(size - 2);
+				float ix = min(floorf(x), n), iy = min(floorf(y), n), iz = min(floorf(z), n);
+				float fx = x - ix, fy = y - iy, fz = z - iz;
+
+				const size_t dx = 1, dy = size, dz = size * size;
+				const RGB* c000 = &table[static_cast<size_t>(ix) + static_cast<size_t>(iy) * dy + static_cast<size_t>(iz) * dz];
+				RGB out;
+
+				if (mode == LUT_Interpolation::Trilinear) {
+					auto lerp = [](const RGB& a, const RGB& b, float t) { return RGB(a.r + (b.r - a.r) * t, a.g + (b.g - a.g) * t, a.b + (b.b - a.b) * t); };
+					RGB x00 = lerp(c000[0], c000[dx], fx);
+					RGB x10 = lerp(c000[dy], c000[dx + dy], fx);
+					RGB x01 = lerp(c000[dz], c000[dx + dz], fx);
+					RGB x11 = lerp(c000[dy + dz], c000[dx + dy + dz], fx);
+					out = lerp(lerp(x00, x10, fy), lerp(x01, x11, fy), fz);
+				}
+				else {
+					// Largest fraction picks corner A, the two largest pick corner B
+					size_t a, bc;
+					float w1, w2, w3;
+					if (fx >= fy && fx >= fz) { a = dx; if (fy >= fz) { bc = dx + dy; w1 = fx; w2 = fy; w3 = fz; } else { bc = dx + dz; w1 = fx; w2 = fz; w3 = fy; } }
+					else if (fy >= fz) { a = dy; if (fx >= fz) { bc = dx + dy; w1 = fy; w2 = fx; w3 = fz; } else { bc = dy + dz; w1 = fy; w2 = fz; w3 = fx; } }
+					else { a = dz; if (fx >= fy) { bc = dx + dz; w1 = fz; w2 = fx; w3 = fy; } else { bc = dy + dz; w1 = fz; w2 = fy; w3 = fx; } }
+
+					const RGB& p0 = c000[0];
+					const RGB& p1 = c000[a];
+					const RGB& p2 = c000[bc];
+					const RGB& p3 = c000[dx + dy + dz];
+					float k0 = 1.0f - w1, k1 = w1 - w2, k2 = w2 - w3;
+					out = RGB(p0.r * k0 + p1.r * k1 + p2.r * k2 + p3.r * w3,
+						p0.g * k0 + p1.g * k1 + p2.g * k2 + p3.g * w3,
+						p0.b * k0 + p1.b * k1 + p2.b * k2 + p3.b * w3);
+				}
+
+				out.a = c.a;
+				return out;
+			}
+
+			SIMD::RGB Sample(const SIMD::RGB& c, LUT_Interpolation mode = LUT_Interpolation::Tetrahedral) const
+			{
+				using SIMD::Float;
+				using SIMD::Select;
+
+				Float x = Coordinate(c.r, domain_min.r, domain_max.r);
+				Float y = Coordinate(c.g, domain_min.g, domain_max.g);
+				Float z = Coordinate(c.b, domain_min.b, domain_max.b);
+
+				Float n = static_cast<float>(size - 2);
+				Float ix = SIMD::Min(SIMD::Floor(x), n), iy = SIMD::Min(SIMD::Floor(y), n), iz = SIMD::Min(SIMD::Floor(z), n);
+				Float fx = x - ix, fy = y - iy, fz = z - iz;
+
+				const float dx = 1.0f, dy = static_cast<float>(size), dz = static_cast<float>(size * size);
+				Float base = ix + iy * dy + iz * dz;
+				SIMD::RGB out;
+
+				if (mode == LUT_Interpolation::Trilinear) {
+					auto lerp = [](const SIMD::RGB& a, const SIMD::RGB& b, Float t) { return SIMD::RGB{ a.r + (b.r - a.r) * t, a.g + (b.g - a.g) * t, a.b + (b.b - a.b) * t, a.a }; };
+					SIMD::RGB x00 = lerp(Corner(base), Corner(base + dx), fx);
+					SIMD::RGB x10 = lerp(Corner(base + dy), Corner(base + (dx + dy)), fx);
+					SIMD::RGB x01 = lerp(Corner(base + dz), Corner(base + (dx + dz)), fx);
+					SIMD::RGB x11 = lerp(Corner(base + (dy + dz)), Corner(base + (dx + dy + dz)), fx);
+					out = lerp(lerp(x00, x10, fy), lerp(x01, x11, fy), fz);
+				}
+				else {
+					// Same tie-breaking as the scalar Sample
+					Float xMax = (fx >= fy) & (fx >= fz);
+					Float yMax = fy >= fz;
+					Float xy = fx >= fy, xz = fx >= fz, yz = fy >= fz;
+
+					Float a = Select(xMax, dx, Select(yMax, dy, dz));
+					Float w1 = Select(xMax, fx, Select(yMax, fy, fz));
+					// Second largest: whichever of the remaining two is bigger
+					Float bx = Select(xMax, Select(yz, dy, dz), Select(yMax, Select(xz, dx, dz), Select(xy, dx, dy)));
+					Float w2 = Select(xMax, Select(yz, fy, fz), Select(yMax, Select(xz, fx, fz), Select(xy, fx, fy)));
+					Float w3 = Select(xMax, Select(yz, fz, fy), Select(yMax, Select(xz, fz, fx), Select(xy, fy, fx)));
+
+					SIMD::RGB p0 = Corner(base);
+					SIMD::RGB p1 = Corner(base + a);
+					SIMD::RGB p2 = Corner(base + a + bx);
+					SIMD::RGB p3 = Corner(base + (dx + dy + dz));
+					Float k0 = 1.0f - w1, k1 = w1 - w2, k2 = w2 - w3;
+					out.r = p0.r * k0 + p1.r * k1 + p2.r * k2 + p3.r * w3;
+					out.g = p0.g * k0 + p1.g * k1 + p2.g * k2 + p3.g * w3;
+					out.b = p0.b * k0 + p1.b * k1 + p2.b * k2 + p3.b * w3;
+				}
+
+				out.a = c.a;
+				return out;
+			}
+
+			// < Bulk application (SIMD lanes, one range per thread) >
+
+			void Apply(std::span<const RGB32> src, std::span<RGB32> dst, LUT_Interpolation mode = LUT_Interpolation::Tetrahedral) const
+			{
+				Apply_Batch(src, dst, mode, [this, mode](RGB32 c) { return RGB_TO_RGB32(Sample(RGB32_TO_RGB(c), mode)); });
+			}
+
+			void Apply(std::span<const RGB> src, std::span<RGB> dst, LUT_Interpolation mode = LUT_Interpolation::Tetrahedral) const
+			{
+				Apply_Batch(src, dst, mode, [this, mode](RGB c) { return Sample(c, mode); });
+			}
+
+		private:
+			template<typename Type, typename Scalar>
+			void Apply_Batch(std::span<const Type> src, std::span<Type> dst, LUT_Interpolation mode, Scalar scalar) const
+			{
+				const size_t count = std::min(src.size(), dst.size());
+				const size_t width = SIMD::Float::width;
+
+				Parallel_For(count, 4096, [&](size_t begin, size_t end) {
+					size_t i = begin;
+					if (width > 1) {
+						for (; i + width <= end; i += width)
+							SIMD::Store(dst.data() + i, Sample(SIMD::Load(src.data() + i), mode));
+					}
+					for (; i < end; i++)
+						dst[i] = scalar(src[i]);
+				});
+			}
+		};
+
+		// /-----------------------------------------------\
+		// | sRGB Transfer Functions                       |
+		// \-----------------------------------------------/
+
+		// < Exact IEC 61966-2-1 curves >
+
+		inline float SRGB_TO_LINEAR(float x) { return x <= 0.04045f ? x * (1.0f / 12.92f) : powf((x + 0.055f) * (1.0f / 1.055f), 2.4f); }
+		inline float LINEAR_TO_SRGB(float x) { return x <= 0.0031308f ? x * 12.92f : 1.055f * powf(x, 1.0f / 2.4f) - 0.055f; }
+
+		inline RGB SRGB_TO_LINEAR(RGB rgb) { return RGB(SRGB_TO_LINEAR(rgb.r), SRGB_TO_LINEAR(rgb.g), SRGB_TO_LINEAR(rgb.b), rgb.a); }
+		inline RGB LINEAR_TO_SRGB(RGB rgb) { return RGB(LINEAR_TO_SRGB(rgb.r), LINEAR_TO_SRGB(rgb.g), LINEAR_TO_SRGB(rgb.b), rgb.a); }
+
+		// < Tables >
+
+		// Encoded byte -> linear float, exact
+		inline const std::array<float, 256> SRGB_DECODE = [] {
+			std::array<float, 256> table{};
+			for (int i = 0; i < 256; i++)
+				table[i] = SRGB_TO_LINEAR(BYTE_TO_FLOAT[i]);
+			return table;
+		}();
+
+		// 4096 linear segments over [0, 1] (plus an end point), interpolated error < 2e-5
+		inline constexpr size_t SRGB_TABLE_SEGMENTS = 4096;
+
+		inline const std::array<float, SRGB_TABLE_SEGMENTS + 1> SRGB_ENCODE = [] {
+			std::array<float, SRGB_TABLE_SEGMENTS + 1> table{};
+			for (size_t i = 0; i <= SRGB_TABLE_SEGMENTS; i++)
+				table[i] = LINEAR_TO_SRGB(static_cast<float>(i) / SRGB_TABLE_SEGMENTS);
+			return table;
+		}();
+
+		inline const std::array<float, SRGB_TABLE_SEGMENTS + 1> SRGB_DECODE_FLOAT = [] {
+			std::array<float, SRGB_TABLE_SEGMENTS + 1> table{};
+			for (size_t i = 0; i <= SRGB_TABLE_SEGMENTS; i++)
+				table[i] = SRGB_TO_LINEAR(static_cast<float>(i) / SRGB_TABLE_SEGMENTS);
+			return table;
+		}();
+
+		// Piecewise linear lookup of a [0, 1] -> [0, 1] curve table, input clamped
+		inline float Curve_Lookup(const std::array<float, SRGB_TABLE_SEGMENTS + 1>& table, float x)
+		{
+			x = std::clamp(x, 0.0f, 1.0f) * SRGB_TABLE_SEGMENTS;
+			float i = min(floorf(x), SRGB_TABLE_SEGMENTS - 1.0f);
+			size_t n = static_cast<size_t>(i);
+			return table[n] + (table[n + 1] - table[n]) * (x - i);
+		}
+
+		namespace SIMD
+		{
+			inline Float Curve_Lookup(const std::array<float, SRGB_TABLE_SEGMENTS + 1>& table, Float x)
+			{
+				x = Max(Min(x, 1.0f), 0.0f) * static_cast<float>(SRGB_TABLE_SEGMENTS);
+				Float i = Min(Floor(x), SRGB_TABLE_SEGMENTS - 1.0f);
+				Float a = Gather_Index(table.data(), i);
+				Float b = Gather_Index(table.data() + 1, i);
+				return a + (b - a) * (x - i);
+			}
+
+			// RGB32 -> linear RGB through the exact 256 entry table
+			inline RGB Load_Linear(const Color::RGB32* p)
+			{
+				RGB c = Load_Bytes(p);
+				return RGB{ Gather_Index(SRGB_DECODE.data(), c.r), Gather_Index(SRGB_DECODE.data(), c.g), Gather_Index(SRGB_DECODE.data(), c.b), c.a * static_cast<float>(1.0 / 255.0) };
+			}
+
+			// Linear RGB -> RGB32, rounded so RGB32 -> linear -> RGB32 is lossless
+			inline void Store_Linear(Color::RGB32* p, const RGB& c)
+			{
+				Store_Rounded(p, RGB{ Curve_Lookup(SRGB_ENCODE, c.r), Curve_Lookup(SRGB_ENCODE, c.g), Curve_Lookup(SRGB_ENCODE, c.b), c.a });
+			}
+		}
+
+		// < Fast scalar paths (same tables as the SIMD paths) >
+
+		inline RGB RGB32_TO_LINEAR(RGB32 rgb32)
+		{
+			return RGB(SRGB_DECODE[rgb32.r], SRGB_DECODE[rgb32.g], SRGB_DECODE[rgb32.b], BYTE_TO_FLOAT[rgb32.a]);
+		}
+		inline RGB32 LINEAR_TO_RGB32(RGB rgb)
+		{
+			auto round = [](float x) { return static_cast<BYTE>(std::clamp(x, 0.0f, 1.0f) * 255.0f + 0.5f); };
+			return RGB32(round(Curve_Lookup(SRGB_ENCODE, rgb.r)), round(Curve_Lookup(SRGB_ENCODE, rgb.g)), round(Curve_Lookup(SRGB_ENCODE, rgb.b)), round(rgb.a));
+		}
+
+		// < Bulk transfer >
+
+		// Decodes sRGB RGB32 pixels to linear-light RGB (alpha is never curved)
+		inline void Decode_SRGB(std::span<const RGB32> src, std::span<RGB> dst)
+		{
+			const size_t count = std::min(src.size(), dst.size());
+			const size_t width = SIMD::Float::width;
+			size_t i = 0;
+
+			if (width > 1) {
+				for (; i + width <= count; i += width)
+					SIMD::Store(dst.data() + i, SIMD::Load_Linear(src.data() + i));
+			}
+
+			for (; i < count; i++)
+				dst[i] = RGB32_TO_LINEAR(src[i]);
+		}
+
+		// Encodes linear-light RGB to sRGB RGB32 pixels
+		inline void Encode_SRGB(std::span<const RGB> src, std::span<RGB32> dst)
+		{
+			const size_t count = std::min(src.size(), dst.size());
+			const size_t width = SIMD::Float::width;
+			size_t i = 0;
+
+			if (width > 1) {
+				for (; i + width <= count; i += width)
+					SIMD::Store_Linear(dst.data() + i, SIMD::Load(src.data() + i));
+			}
+
+			for (; i < count; i++)
+				dst[i] = LINEAR_TO_RGB32(src[i]);
+		}
+
+		// In place float conversions, through the interpolated tables
+		inline void To_Linear(std::span<RGB> rgb)
+		{
+			Convert_Batch(std::span<const RGB>(rgb), rgb,
+				[](RGB c) { return RGB(Curve_Lookup(SRGB_DECODE_FLOAT, c.r), Curve_Lookup(SRGB_DECODE_FLOAT, c.g), Curve_Lookup(SRGB_DECODE_FLOAT, c.b), c.a); },
+				[](const SIMD::RGB& c) { return SIMD::RGB{ SIMD::Curve_Lookup(SRGB_DECODE_FLOAT, c.r), SIMD::Curve_Lookup(SRGB_DECODE_FLOAT, c.g), SIMD::Curve_Lookup(SRGB_DECODE_FLOAT, c.b), c.a }; });
+		}
+		inline void To_SRGB(std::span<RGB> rgb)
+		{
+			Convert_Batch(std::span<const RGB>(rgb), rgb,
+				[](RGB c) { return RGB(Curve_Lookup(SRGB_ENCODE, c.r), Curve_Lookup(SRGB_ENCODE, c.g), Curve_Lookup(SRGB_ENCODE, c.b), c.a); },
+				[](const SIMD::RGB& c) { return SIMD::RGB{ SIMD::Curve_Lookup(SRGB_ENCODE, c.r), SIMD::Curve_Lookup(SRGB_ENCODE, c.g), SIMD::Curve_Lookup(SRGB_ENCODE, c.b), c.a }; });
+		}
+
+		// < Linear-light pipeline >
+
+		// Encoded treats channel values as-is (the classic ZCPP math), Linear decodes sRGB first
+		// and re-encodes afterwards, so weights and blends act on physical light
+		enum class Light_Mode
+		{
+			Encoded,
+			Linear
+		};
+
+		// Runs vector(SIMD::RGB) -> SIMD::RGB per register over RGB32 spans in the chosen light mode, across threads.
+		// scalar is the matching RGB -> RGB function for the tail.
+		template<typename Scalar, typename Vector>
+		void Light_Pass(std::span<const RGB32> src, std::span<RGB32> dst, Light_Mode mode, Scalar scalar, Vector vector)
+		{
+			const size_t count = std::min(src.size(), dst.size());
+			const size_t width = SIMD::Float::width;
+
+			Parallel_For(count, 4096, [&](size_t begin, size_t end) {
+				size_t i = begin;
+				if (mode == Light_Mode::Linear) {
+					if (width > 1) {
+						for (; i + width <= end; i += width)
+							SIMD::Store_Linear(dst.data() + i, vector(SIMD::Load_Linear(src.data() + i)));
+					}
+					for (; i < end; i++)
+						dst[i] = LINEAR_TO_RGB32(scalar(RGB32_TO_LINEAR(src[i])));
+				}
+				else {
+					if (width > 1) {
+						for (; i + width <= end; i += width)
+							SIMD::Store(dst.data() + i, vector(SIMD::Load(src.data() + i)));
+					}
+					for (; i < end; i++)
+						dst[i] = RGB_TO_RGB32(scalar(RGB32_TO_RGB(src[i])));
+				}
+			});
+		}
+
+		// Rec.709 luminance; only physically correct in Light_Mode::Linear
+		inline void To_grayscale(std::span<const RGB32> src, std::span<RGB32> dst, Light_Mode mode)
+		{
+			if (mode == Light_Mode::Encoded) {
+				To_grayscale(src, dst);
+				return;
+			}
+
+			Light_Pass(src, dst, mode, RGB_TO_GRAYSCALE, [](const SIMD::RGB& c) {
+				SIMD::Float y = 0.2126f * c.r + 0.7152f * c.g + 0.0722f * c.b;
+				return SIMD::RGB{ y, y, y, c.a };
+			});
+		}
+
+		// dst = a + (b - a) * t per channel, alpha always mixed as stored
+		inline void Mix(std::span<const RGB32> a, std::span<const RGB32> b, std::span<RGB32> dst, float t, Light_Mode mode = Light_Mode::Linear)
+		{
+			const size_t count = std::min({ a.size(), b.size(), dst.size() });
+			const size_t width = SIMD::Float::width;
+			const bool linear = mode == Light_Mode::Linear;
+
+			auto mix = [t](const RGB& x, const RGB& y) { return RGB(x.r + (y.r - x.r) * t, x.g + (y.g - x.g) * t, x.b + (y.b - x.b) * t, x.a + (y.a - x.a) * t); };
+			auto mixv = [t](const SIMD::RGB& x, const SIMD::RGB& y) { return SIMD::RGB{ x.r + (y.r - x.r) * t, x.g + (y.g - x.g) * t, x.b + (y.b - x.b) * t, x.a + (y.a - x.a) * t }; };
+
+			Parallel_For(count, 4096, [&](size_t begin, size_t end) {
+				size_t i = begin;
+				if (width > 1) {
+					for (; i + width <= end; i += width) {
+						if (linear)
+							SIMD::Store_Linear(dst.data() + i, mixv(SIMD::Load_Linear(a.data() + i), SIMD::Load_Linear(b.data() + i)));
+						else
+							SIMD::Store(dst.data() + i, mixv(SIMD::Load(a.data() + i), SIMD::Load(b.data() + i)));
+					}
+				}
+				for (; i < end; i++) {
+					if (linear)
+						dst[i] = LINEAR_TO_RGB32(mix(RGB32_TO_LINEAR(a[i]), RGB32_TO_LINEAR(b[i])));
+					else
+						dst[i] = RGB_TO_RGB32(mix(RGB32_TO_RGB(a[i]), RGB32_TO_RGB(b[i])));
+				}
+			});
+		}
+
+		// /-----------------------------------------------\
+		// | Alpha Compositing                             |
+		// \-----------------------------------------------/
+
+		// < Porter-Duff operators, result = src * Fa + dst * Fb on premultiplied colors >
+		enum class Composite_Op
+		{
+			Over,	// Fa = 1,        Fb = 1 - src.a
+			In,		// Fa = dst.a,    Fb = 0
+			Out,	// Fa = 1 - dst.a, Fb = 0
+			Atop,	// Fa = dst.a,    Fb = 1 - src.a
+			Xor		// Fa = 1 - dst.a, Fb = 1 - src.a
+		};
+
+		// < Separable blend modes, B(dst, src) on straight colors >
+		enum class Blend_Mode
+		{
+			Multiply,	// dst * src
+			Screen,		// dst + src - dst * src
+			Overlay,	// multiply or screen by dst, doubled
+			Additive	// min(dst + src, 1)
+		};
+
+		// Reciprocal alpha in Q16, round((255 << 16) / a) (0 at a = 0)
+		inline constexpr std::array<int, 256> UNPREMULTIPLY_Q16 = [] {
+			std::array<int, 256> table{};
+			for (int i = 1; i < 256; i++)
+				table[i] = ((255 << 16) + i / 2) / i;
+			return table;
+		}();
+
+		// < Premultiplied alpha >
+
+		inline RGB32 Premultiply(RGB32 rgb32)
+		{
+			return RGB32(div255(rgb32.r * rgb32.a), div255(rgb32.g * rgb32.a), div255(rgb32.b * rgb32.a), rgb32.a);
+		}
+		inline RGB32 Unpremultiply(RGB32 rgb32)
+		{
+			// Channels above alpha are not valid premultiplied values; they clamp to 255 either way and
+			// would overflow x * i at small alpha
+			const int a = rgb32.a, i = UNPREMULTIPLY_Q16[a];
+			auto channel = [a, i](int x) { return static_cast<BYTE>(std::min((std::min(x, a) * i + 32768) >> 16, 255)); };
+			return RGB32(channel(rgb32.r), channel(rgb32.g), channel(rgb32.b), rgb32.a);
+		}
+		inline RGB Premultiply(RGB rgb) { return RGB(rgb.r * rgb.a, rgb.g * rgb.a, rgb.b * rgb.a, rgb.a); }
+		inline RGB Unpremultiply(RGB rgb)
+		{
+			float i = rgb.a > 0.0f ? 1.0f / rgb.a : 0.0f;
+			return RGB(rgb.r * i, rgb.g * i, rgb.b * i, rgb.a);
+		}
+
+		// < Scalar operators >
+
+		// 8bit Porter-Duff factors for op, in 0 - 255
+		inline void Composite_Factors(Composite_Op op, int srcAlpha, int dstAlpha, int& fa, int& fb)
+		{
+			switch (op) {
+			case Composite_Op::Over: fa = 255; fb = 255 - srcAlpha; break;
+			case Composite_Op::In: fa = dstAlpha; fb = 0; break;
+			case Composite_Op::Out: fa = 255 - dstAlpha; fb = 0; break;
+			case Composite_Op::Atop: fa = dstAlpha; fb = 255 - srcAlpha; break;
+			default: fa = 255 - dstAlpha; fb = 255 - srcAlpha; break;
+			}
+		}
+
+		// Premultiplied src OP dst with exact rounded division by 255
+		inline RGB32 Composite(RGB32 src, RGB32 dst, Composite_Op op = Composite_Op::Over)
+		{
+			int fa, fb;
+			Composite_Factors(op, src.a, dst.a, fa, fb);
+			auto channel = [fa, fb](int s, int d) { return static_cast<BYTE>(div255(std::min(s * fa + d * fb, 255 * 255))); };
+			return RGB32(channel(src.r, dst.r), channel(src.g, dst.g), channel(src.b, dst.b), channel(src.a, dst.a));
+		}
+
+		inline RGB Composite(RGB src, RGB dst, Composite_Op op = Composite_Op::Over)
+		{
+			float fa, fb;
+			switch (op) {
+			case Composite_Op::Over: fa = 1.0f; fb = 1.0f - src.a; break;
+			case Composite_Op::In: fa = dst.a; fb = 0.0f; break;
+			case Composite_Op::Out: fa = 1.0f - dst.a; fb = 0.0f; break;
+			case Composite_Op::Atop: fa = dst.a; fb = 1.0f - src.a; break;
+			default: fa = 1.0f - dst.a; fb = 1.0f - src.a; break;
+			}
+			return RGB(src.r * fa + dst.r * fb, src.g * fa + dst.g * fb, src.b * fa + dst.b * fb, src.a * fa + dst.a * fb);
+		}
+
+		inline float Blend_Channel(float d, float s, Blend_Mode mode)
+		{
+			switch (mode) {
+			case Blend_Mode::Multiply: return d * s;
+			case Blend_Mode::Screen: return d + s - d * s;
+			case Blend_Mode::Overlay: return d <= 0.5f ? 2.0f * d * s : 1.0f - 2.0f * (1.0f - d) * (1.0f - s);
+			default: return min(d + s, 1.0f);
+			}
+		}
+
+		// Straight-alpha src blended onto dst, then composited source-over (W3C compositing model)
+		inline RGB Blend(RGB src, RGB dst, Blend_Mode mode)
+		{
+			float both = src.a * dst.a;
+			float onlySrc = src.a - both;
+			float onlyDst = dst.a - both;
+			float a = src.a + onlyDst;
+			float i = a > 0.0f ? 1.0f / a : 0.0f;
+
+			auto channel = [&](float s, float d) { return (onlySrc * s + onlyDst * d + both * Blend_Channel(d, s, mode)) * i; };
+			return RGB(channel(src.r, dst.r), channel(src.g, dst.g), channel(src.b, dst.b), a);
+		}
+
+		inline RGB32 Blend(RGB32 src, RGB32 dst, Blend_Mode mode)
+		{
+			RGB c = Blend(RGB32_TO_RGB(src), RGB32_TO_RGB(dst), mode);
+			auto round = [](float x) { return static_cast<BYTE>(std::clamp(x, 0.0f, 1.0f) * 255.0f + 0.5f); };
+			return RGB32(round(c.r), round(c.g), round(c.b), round(c.a));
+		}
+
+		namespace SIMD
+		{
+#if defined(ZCPP_COLOR_SSE2)
+			// Rounded x / 255 on 16bit lanes, identical to div255 after clamping x to 255 * 255
+			inline __m128i Div255_Epi16(__m128i x)
+			{
+				x = _mm_sub_epi16(x, _mm_subs_epu16(x, _mm_set1_epi16(static_cast<short>(255 * 255))));
+				x = _mm_add_epi16(x, _mm_set1_epi16(128));
+				return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+			}
+
+			// Copies each pixel's alpha word into its other three words
+			inline __m128i Broadcast_Alpha_Epi16(__m128i x)
+			{
+				return _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+			}
+
+			// Two RGB32 pixels (as 16bit words) composited with exact div255
+			inline __m128i Composite_Epi16(__m128i s, __m128i d, Composite_Op op)
+			{
+				const __m128i full = _mm_set1_epi16(255);
+				__m128i as = Broadcast_Alpha_Epi16(s);
+				__m128i ad = Broadcast_Alpha_Epi16(d);
+				__m128i fa, fb;
+
+				switch (op) {
+				case Composite_Op::Over: fa = full; fb = _mm_sub_epi16(full, as); break;
+				case Composite_Op::In: fa = ad; fb = _mm_setzero_si128(); break;
+				case Composite_Op::Out: fa = _mm_sub_epi16(full, ad); fb = _mm_setzero_si128(); break;
+				case Composite_Op::Atop: fa = ad; fb = _mm_sub_epi16(full, as); break;
+				default: fa = _mm_sub_epi16(full, ad); fb = _mm_sub_epi16(full, as); break;
+				}
+
+				return Div255_Epi16(_mm_adds_epu16(_mm_mullo_epi16(s, fa), _mm_mullo_epi16(d, fb)));
+			}
+#endif
+
+			inline Float Blend_Channel(Float d, Float s, Blend_Mode mode)
+			{
+				switch (mode) {
+				case Blend_Mode::Multiply: return d * s;
+				case Blend_Mode::Screen: return d + s - d * s;
+				case Blend_Mode::Overlay: return Select(d <= 0.5f, 2.0f * d * s, 1.0f - 2.0f * (1.0f - d) * (1.0f - s));
+				default: return Min(d + s, 1.0f);
+				}
+			}
+
+			inline RGB Blend(const RGB& src, const RGB& dst, Blend_Mode mode)
+			{
+				Float both = src.a * dst.a;
+				Float onlySrc = src.a - both;
+				Float onlyDst = dst.a - both;
+				Float a = src.a + onlyDst;
+				Float i = Select(a > 0.0f, 1.0f / a, 0.0f);
+
+				auto channel = [&](Float s, Float d) { return (onlySrc * s + onlyDst * d + both * Blend_Channel(d, s, mode)) * i; };
+				return RGB{ channel(src.r, dst.r), channel(src.g, dst.g), channel(src.b, dst.b), a };
+			}
+
+			inline RGB Composite(const RGB& src, const RGB& dst, Composite_Op op)
+			{
+				Float fa, fb;
+				switch (op) {
+				case Composite_Op::Over: fa = 1.0f; fb = 1.0f - src.a; break;
+				case Composite_Op::In: fa = dst.a; fb = 0.0f; break;
+				case Composite_Op::Out: fa = 1.0f - dst.a; fb = 0.0f; break;
+				case Composite_Op::Atop: fa = dst.a; fb = 1.0f - src.a; break;
+				default: fa = 1.0f - dst.a; fb = 1.0f - src.a; break;
+				}
+				return RGB{ src.r * fa + dst.r * fb, src.g * fa + dst.g * fb, src.b * fa + dst.b * fb, src.a * fa + dst.a * fb };
+			}
+		}
+
+		// < Bulk operators >
+
+		inline void Premultiply(std::span<RGB32> rgb32)
+		{
+			size_t i = 0;
+#if defined(ZCPP_COLOR_SSE2)
+			const __m128i zero = _mm_setzero_si128();
+			// Alpha word keeps a factor of 255 so it survives the divide unchanged
+			const __m128i keep = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+			for (; i + 4 <= rgb32.size(); i += 4) {
+				__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb32.data() + i));
+				__m128i lo = _mm_unpacklo_epi8(x, zero), hi = _mm_unpackhi_epi8(x, zero);
+				lo = SIMD::Div255_Epi16(_mm_mullo_epi16(lo, _mm_or_si128(_mm_andnot_si128(keep, SIMD::Broadcast_Alpha_Epi16(lo)), keep)));
+				hi = SIMD::Div255_Epi16(_mm_mullo_epi16(hi, _mm_or_si128(_mm_andnot_si128(keep, SIMD::Broadcast_Alpha_Epi16(hi)), keep)));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(rgb32.data() + i), _mm_packus_epi16(lo, hi));
+			}
+#endif
+			for (; i < rgb32.size(); i++)
+				rgb32[i] = Premultiply(rgb32[i]);
+		}
+
+		inline void Unpremultiply(std::span<RGB32> rgb32)
+		{
+			for (RGB32& c : rgb32)
+				c = Unpremultiply(c);
+		}
+
+		inline void Premultiply(std::span<RGB> rgb)
+		{
+			Convert_Batch(std::span<const RGB>(rgb), rgb, [](RGB c) { return Premultiply(c); },
+				[](const SIMD::RGB& c) { return SIMD::RGB{ c.r * c.a, c.g * c.a, c.b * c.a, c.a }; });
+		}
+
+		inline void Unpremultiply(std::span<RGB> rgb)
+		{
+			Convert_Batch(std::span<const RGB>(rgb), rgb, [](RGB c) { return Unpremultiply(c); },
+				[](const SIMD::RGB& c) {
+					SIMD::Float i = SIMD::Select(c.a > 0.0f, 1.0f / c.a, 0.0f);
+					return SIMD::RGB{ c.r * i, c.g * i, c.b * i, c.a };
+				});
+		}
+
+		// dst = src OP dst over premultiplied RGB32 layers, 8bit exact
+		inline void Composite(std::span<const RGB32> src, std::span<RGB32> dst, Composite_Op op = Composite_Op::Over)
+		{
+			const size_t count = std::min(src.size(), dst.size());
+			size_t i = 0;
+#if defined(ZCPP_COLOR_SSE2)
+			const __m128i zero = _mm_setzero_si128();
+			for (; i + 4 <= count; i += 4) {
+				__m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src.data() + i));
+				__m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst.data() + i));
+				__m128i lo = SIMD::Composite_Epi16(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero), op);
+				__m128i hi = SIMD::Composite_Epi16(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero), op);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst.data() + i), _mm_packus_epi16(lo, hi));
+			}
+#endif
+			for (; i < count; i++)
+				dst[i] = Composite(src[i], dst[i], op);
+		}
+
+		// dst = src OP dst over premultiplied float layers
+		inline void Composite(std::span<const RGB> src, std::span<RGB> dst, Composite_Op op = Composite_Op::Over)
+		{
+			const size_t count = std::min(src.size(), dst.size());
+			const size_t width = SIMD::Float::width;
+			size_t i = 0;
+
+			if (width > 1) {
+				for (; i + width <= count; i += width)
+					SIMD::Store(dst.data() + i, SIMD::Composite(SIMD::Load(src.data() + i), SIMD::Load(dst.data() + i), op));
+			}
+
+			for (; i < count; i++)
+				dst[i] = Composite(src[i], dst[i], op);
+		}
+
+		// Blends straight-alpha src onto dst in place
+		inline void Blend(std::span<const RGB32> src, std::span<RGB32> dst, Blend_Mode mode)
+		{
+			const size_t count = std::min(src.size(), dst.size());
+			const size_t width = SIMD::Float::width;
+			size_t i = 0;
+
+			if (width > 1) {
+				for (; i + width <= count; i += width)
+					SIMD::Store_Rounded(dst.data() + i, SIMD::Blend(SIMD::Load(src.data() + i), SIMD::Load(dst.data() + i), mode));
+			}
+
+			for (; i < count; i++)
+				dst[i] = Blend(src[i], dst[i], mode);
+		}
+
+		inline void Blend(std::span<const RGB> src, std::span<RGB> dst, Blend_Mode mode)
+		{
+			const size_t count = std::min(src.size(), dst.size());
+			const size_t width = SIMD::Float::width;
+			size_t i = 0;
+
+			if (width > 1) {
+				for (; i + width <= count; i += width)
+					SIMD::Store(dst.data() + i, SIMD::Blend(SIMD::Load(src.data() + i), SIMD::Load(dst.data() + i), mode));
+			}
+
+			for (; i < count; i++)
+				dst[i] = Blend(src[i], dst[i], mode);
+		}
+
+		// /-----------------------------------------------\
+		// | Fused Pipelines                               |
+		// \-----------------------------------------------/
+
+		// < Planar scratch for one tile, shared by every stage of a pipeline >
+		class Pipeline_Tile
+		{
+		private:
+			size_t capacity;
+			std::vector<float, Aligned_Allocator<float>> data;
+
+		public:
+			// Room for capacity pixels in up to 5 planes (CMYK), capacity a multiple of SIMD::Float::width
+			explicit Pipeline_Tile(size_t capacity) : capacity(capacity), data(5 * capacity, 0.0f) {}
+
+			size_t Capacity() const { return capacity; }
+			float* Plane(size_t channel) { return data.data() + channel * capacity; }
+			const float* Plane(size_t channel) const { return data.data() + channel * capacity; }
+
+			template<typename ColorSpace>
+			typename Planar_Traits<ColorSpace>::Block Load(size_t index) const
+			{
+				typedef Planar_Traits<ColorSpace> Traits;
+				typename Traits::Block b;
+				for (size_t ch = 0; ch < Traits::channels; ch++)
+					b.*Traits::vector[ch] = SIMD::Float::Load(Plane(ch) + index);
+				return b;
+			}
+
+			template<typename ColorSpace>
+			void Store(size_t index, const typename Planar_Traits<ColorSpace>::Block& b)
+			{
+				typedef Planar_Traits<ColorSpace> Traits;
+				for (size_t ch = 0; ch < Traits::channels; ch++)
+					(b.*Traits::vector[ch]).Store(Plane(ch) + index);
+			}
+		};
+
+		// < Chain of conversion / adjustment stages run tile by tile >
+		// Every stage sees the whole tile before the next one starts, and the tile
+		// (5 planes of tile pixels) is sized to stay in L1 / L2, so intermediates
+		// never reach memory: each pixel is read once and written once.
+		class Pipeline
+		{
+		public:
+			typedef std::function<void(Pipeline_Tile&, size_t)> Stage;
+
+		private:
+			enum class Space { RGB, HSV, HSL, CMYK };
+
+			std::vector<Stage> stages;
+			Space current = Space::RGB;
+
+			template<typename ColorSpace>
+			static constexpr Space Space_Of()
+			{
+				if constexpr (std::is_same<ColorSpace, HSV>::value) return Space::HSV;
+				else if constexpr (std::is_same<ColorSpace, HSL>::value) return Space::HSL;
+				else if constexpr (std::is_same<ColorSpace, CMYK>::value) return Space::CMYK;
+				else return Space::RGB;
+			}
+
+			template<typename From, typename To>
+			static void Convert_Tile(Pipeline_Tile& tile, size_t count)
+			{
+				for (size_t i = 0; i < count; i += SIMD::Float::width) {
+					if constexpr (std::is_same<From, HSV>::value && std::is_same<To, HSL>::value)
+						tile.Store<To>(i, SIMD::HSV_TO_HSL(tile.Load<From>(i)));
+					else if constexpr (std::is_same<From, HSL>::value && std::is_same<To, HSV>::value)
+						tile.Store<To>(i, SIMD::HSL_TO_HSV(tile.Load<From>(i)));
+					else
+						tile.Store<To>(i, Planar_Traits<To>::From_RGB(Planar_Traits<From>::To_RGB(tile.Load<From>(i))));
+				}
+			}
+
+			template<typename To>
+			static Stage Convert_Stage(Space from)
+			{
+				switch (from) {
+				case Space::HSV: return Convert_Tile<HSV, To>;
+				case Space::HSL: return Convert_Tile<HSL, To>;
+				case Space::CMYK: return Convert_Tile<CMYK, To>;
+				default: return Convert_Tile<RGB, To>;
+				}
+			}
+
+		public:
+			// Converts the working color space (a no-op if already there)
+			template<typename ColorSpace>
+			Pipeline& To()
+			{
+				if (current != Space_Of<ColorSpace>()) {
+					stages.push_back(Convert_Stage<ColorSpace>(current));
+					current = Space_Of<ColorSpace>();
+				}
+				return *this;
+			}
+
+			// Adds fn(SIMD block) -> SIMD block in ColorSpace, converting into it first when needed
+			template<typename ColorSpace, typename Function>
+			Pipeline& Adjust(Function fn)
+			{
+				To<ColorSpace>();
+				stages.push_back([fn](Pipeline_Tile& tile, size_t count) {
+					for (size_t i = 0; i < count; i += SIMD::Float::width)
+						tile.Store<ColorSpace>(i, fn(tile.Load<ColorSpace>(i)));
+				});
+				return *this;
+			}
+
+			// Adds a 3D LUT lookup (in RGB); the LUT must outlive the pipeline
+			Pipeline& Apply(const LUT3D& lut, LUT_Interpolation mode = LUT_Interpolation::Tetrahedral)
+			{
+				return Adjust<RGB>([&lut, mode](const SIMD::RGB& c) { return lut.Sample(c, mode); });
+			}
+
+			size_t Stages() const { return stages.size(); }
+
+			// Runs every stage over src into dst, one tile at a time per thread.
+			// tile is in pixels; 1024 keeps 5 float planes (20KB) inside a 32KB L1.
+			void Run(std::span<const RGB32> src, std::span<RGB32> dst, size_t tile = 1024) const
+			{
+				const size_t count = std::min(src.size(), dst.size());
+				const size_t width = SIMD::Float::width;
+				tile = std::max((tile + width - 1) / width * width, width);
+
+				std::vector<Stage> chain = stages;
+				if (current != Space::RGB)
+					chain.push_back(Convert_Stage<RGB>(current));
+
+				Parallel_For(count, tile, [&](size_t begin, size_t end) {
+					Pipeline_Tile scratch(tile);
+
+					for (size_t start = begin; start < end; start += tile) {
+						const size_t n = std::min(tile, end - start);
+						const size_t full = n / width * width;
+						const size_t padded = (n + width - 1) / width * width;
+
+						// Deinterleave into RGB planes, scalar for the last partial register
+						for (size_t i = 0; i < full; i += width)
+							scratch.Store<RGB>(i, SIMD::Load(src.data() + start + i));
+						for (size_t i = full; i < padded; i++) {
+							RGB c = i < n ? RGB32_TO_RGB(src[start + i]) : RGB();
+							scratch.Plane(0)[i] = c.r; scratch.Plane(1)[i] = c.g; scratch.Plane(2)[i] = c.b; scratch.Plane(3)[i] = c.a;
+						}
+
+						for (const Stage& stage : chain)
+							stage(scratch, padded);
+
+						for (size_t i = 0; i < full; i += width)
+							SIMD::Store(dst.data() + start + i, scratch.Load<RGB>(i));
+						for (size_t i = full; i < n; i++)
+							dst[start + i] = RGB_TO_RGB32(RGB(scratch.Plane(0)[i], scratch.Plane(1)[i], scratch.Plane(2)[i], scratch.Plane(3)[i]));
+					}
+				});
+			}
+		};
+
+		// /-----------------------------------------------\
+		// | Palette Quantization                          |
+		// \-----------------------------------------------/
+
+		// < 15bit (5 bits per channel) color histogram with exact per-bin means >
+		class Palette_Histogram
+		{
+		public:
+			static constexpr size_t bins = 32 * 32 * 32;
+
+			struct Bin
+			{
+				unsigned long long count = 0;
+				unsigned long long r = 0, g = 0, b = 0;
+			};
+
+			std::vector<Bin> data;
+
+			Palette_Histogram() : data(bins) {}
+
+			static size_t Index(RGB32 c) { return (static_cast<size_t>(c.r >> 3) << 10) | (static_cast<size_t>(c.g >> 3) << 5) | static_cast<size_t>(c.b >> 3); }
+
+			void Add(RGB32 c)
+			{
+				Bin& bin = data[Index(c)];
+				bin.count++; bin.r += c.r; bin.g += c.g; bin.b += c.b;
+			}
+
+			void Merge(const Palette_Histogram& other)
+			{
+				for (size_t i = 0; i < bins; i++) {
+					data[i].count += other.data[i].count;
+					data[i].r += other.data[i].r; data[i].g += other.data[i].g; data[i].b += other.data[i].b;
+				}
+			}
+
+			// Mean color of a non-empty bin
+			RGB32 Mean(size_t i) const
+			{
+				const Bin& bin = data[i];
+				unsigned long long half = bin.count / 2;
+				return RGB32(static_cast<BYTE>((bin.r + half) / bin.count), static_cast<BYTE>((bin.g + half) / bin.count), static_cast<BYTE>((bin.b + half) / bin.count));
+			}
+
+			// Histogram of every step-th pixel, one partial histogram per thread merged at the end
+			static Palette_Histogram Build(std::span<const RGB32> pixels, size_t step = 1)
+			{
+				step = std::max<size_t>(step, 1);
+				const size_t samples = (pixels.size() + step - 1) / step;
+
+				std::vector<Palette_Histogram> partial;
+				std::mutex lock;
+				Parallel_For(samples, 65536, [&](size_t begin, size_t end) {
+					Palette_Histogram local;
+					for (size_t i = begin; i < end; i++)
+						local.Add(pixels[i * step]);
+					std::lock_guard<std::mutex> guard(lock);
+					partial.push_back(std::move(local));
+				});
+
+				Palette_Histogram total;
+				for (const Palette_Histogram& h : partial)
+					total.Merge(h);
+				return total;
+			}
+		};
+
+		// < Up to 256 colors plus a 15bit inverse color map for O(1) nearest lookups >
+		class Palette
+		{
+		private:
+			std::vector<BYTE> inverse;
+
+			static int Distance(RGB32 x, RGB32 y)
+			{
+				int dr = x.r - y.r, dg = x.g - y.g, db = x.b - y.b;
+				return dr * dr + dg * dg + db * db;
+			}
+
+		public:
+			static constexpr size_t max_colors = 256;
+
+			// Colors past max_colors are dropped by Build_Map, since indices are one byte
+			std::vector<RGB32> colors;
+
+			Palette() { Build_Map(); }
+			explicit Palette(std::vector<RGB32> colors) : colors(std::move(colors)) { Build_Map(); }
+
+			size_t Size() const { return colors.size(); }
+
+			// Exact nearest palette index by brute force (ignores alpha), 0 for an empty palette
+			BYTE Nearest(RGB32 c) const
+			{
+				int best = INT_MAX;
+				BYTE index = 0;
+				for (size_t i = 0; i < std::min(colors.size(), max_colors); i++) {
+					int d = Distance(c, colors[i]);
+					if (d < best) { best = d; index = static_cast<BYTE>(i); }
+				}
+				return index;
+			}
+
+			// Rebuilds the inverse map; call after editing colors by hand
+			void Build_Map()
+			{
+				if (colors.size() > max_colors)
+					colors.resize(max_colors);
+				inverse.assign(Palette_Histogram::bins, 0);
+				if (colors.empty())
+					return;
+
+				Parallel_For(Palette_Histogram::bins, 1024, [&](size_t begin, size_t end) {
+					for (size_t i = begin; i < end; i++) {
+						// Center of the 8x8x8 cell
+						RGB32 c(static_cast<BYTE>(((i >> 10) & 31) * 8 + 4), static_cast<BYTE>(((i >> 5) & 31) * 8 + 4), static_cast<BYTE>((i & 31) * 8 + 4));
+						inverse[i] = Nearest(c);
+					}
+				});
+			}
+
+			// Nearest index through the inverse map (exact to within the 8 level cell)
+			BYTE Index(RGB32 c) const { return inverse[Palette_Histogram::Index(c)]; }
+
+			// Writes one palette index per pixel, split across threads
+			void Map(std::span<const RGB32> src, std::span<BYTE> dst) const
+			{
+				const size_t count = std::min(src.size(), dst.size());
+				const BYTE* map = inverse.data();
+				Parallel_For(count, 65536, [&](size_t begin, size_t end) {
+					for (size_t i = begin; i < end; i++)
+						dst[i] = map[Palette_Histogram::Index(src[i])];
+				});
+			}
+
+			// Expands indices back into colors, out of range indices take the last color (RGB32() if empty)
+			void Unmap(std::span<const BYTE> src, std::span<RGB32> dst) const
+			{
+				const size_t count = std::min(src.size(), dst.size());
+				if (colors.empty()) {
+					std::fill(dst.begin(), dst.begin() + count, RGB32());
+					return;
+				}
+				for (size_t i = 0; i < count; i++)
+					dst[i] = colors[std::min<size_t>(src[i], colors.size() - 1)];
+			}
+
+			// < Generation >
+
+			// Median cut over the sampled histogram, splitting the box with the largest weight x extent
+			// along its widest channel
+			static Palette Median_Cut(std::span<const RGB32> pixels, size_t count = 256, size_t step = 1)
+			{
+				return Median_Cut(Palette_Histogram::Build(pixels, step), count);
+			}
+
+			static Palette Median_Cut(const Palette_Histogram& histogram, size_t count = 256)
+			{
+				struct Entry { RGB32 color; unsigned long long weight; };
+				struct Box { size_t begin, end; unsigned long long weight; int channel, range; };
+
+				count = std::clamp<size_t>(count, 1, 256);
+
+				std::vector<Entry> entries;
+				for (size_t i = 0; i < Palette_Histogram::bins; i++)
+					if (histogram.data[i].count)
+						entries.push_back({ histogram.Mean(i), histogram.data[i].count });
+
+				auto channel = [](const RGB32& c, int ch) { return ch == 0 ? c.r : ch == 1 ? c.g : c.b; };
+				auto measure = [&](Box& box) {
+					int lo[3] = { 255, 255, 255 }, hi[3] = { 0, 0, 0 };
+					box.weight = 0;
+					for (size_t i = box.begin; i < box.end; i++) {
+						box.weight += entries[i].weight;
+						for (int ch = 0; ch < 3; ch++) {
+							lo[ch] = std::min<int>(lo[ch], channel(entries[i].color, ch));
+							hi[ch] = std::max<int>(hi[ch], channel(entries[i].color, ch));
+						}
+					}
+					box.channel = 0;
+					for (int ch = 1; ch < 3; ch++)
+						if (hi[ch] - lo[ch] > hi[box.channel] - lo[box.channel])
+							box.channel = ch;
+					box.range = hi[box.channel] - lo[box.channel];
+				};
+
+				std::vector<Box> boxes;
+				if (!entries.empty()) {
+					boxes.push_back({ 0, entries.size(), 0, 0, 0 });
+					measure(boxes[0]);
+				}
+
+				while (boxes.size() < count) {
+					// Box with the largest weight x extent that can still be split: weight alone would keep
+					// cutting one dominant flat color, extent alone would waste entries on rare outliers
+					Box* target = nullptr;
+					for (Box& box : boxes)
+						if (box.end - box.begin > 1 && box.range > 0 && (!target || box.weight * box.range > target->weight * target->range))
+							target = &box;
+					if (!target)
+						break;
+
+					int ch = target->channel;
+					std::sort(entries.begin() + target->begin, entries.begin() + target->end,
+						[&](const Entry& x, const Entry& y) { return channel(x.color, ch) < channel(y.color, ch); });
+
+					// Weighted median, keeping at least one entry per side
+					unsigned long long half = target->weight / 2, seen = 0;
+					size_t split = target->begin;
+					while (split < target->end - 1 && seen + entries[split].weight <= half)
+						seen += entries[split++].weight;
+					split = std::clamp(split, target->begin + 1, target->end - 1);
+
+					Box upper = { split, target->end, 0, 0, 0 };
+					target->end = split;
+					measure(*target);
+					measure(upper);
+					boxes.push_back(upper);
+				}
+
+				std::vector<RGB32> colors;
+				for (const Box& box : boxes) {
+					unsigned long long r = 0, g = 0, b = 0;
+					for (size_t i = box.begin; i < box.end; i++) {
+						r += entries[i].color.r * entries[i].weight;
+						g += entries[i].color.g * entries[i].weight;
+						b += entries[i].color.b * entries[i].weight;
+					}
+					unsigned long long w = std::max<unsigned long long>(box.weight, 1);
+					colors.push_back(RGB32(static_cast<BYTE>((r + w / 2) / w), static_cast<BYTE>((g + w / 2) / w), static_cast<BYTE>((b + w / 2) / w)));
+				}
+				return Palette(std::move(colors));
+			}
+
+			// K-means (Lloyd) over the sampled histogram, seeded by median cut, assignment split across threads
+			static Palette K_Means(std::span<const RGB32> pixels, size_t count = 256, size_t iterations = 8, size_t step = 1)
+			{
+				Palette_Histogram histogram = Palette_Histogram::Build(pixels, step);
+				Palette palette = Median_Cut(histogram, count);
+
+				std::vector<size_t> used;
+				for (size_t i = 0; i < Palette_Histogram::bins; i++)
+					if (histogram.data[i].count)
+						used.push_back(i);
+
+				struct Sum { unsigned long long r = 0, g = 0, b = 0, n = 0; };
+
+				for (size_t it = 0; it < iterations && palette.Size() > 0; it++) {
+					std::vector<std::vector<Sum>> partial;
+					std::mutex lock;
+
+					Parallel_For(used.size(), 1024, [&](size_t begin, size_t end) {
+						std::vector<Sum> local(palette.Size());
+						for (size_t u = begin; u < end; u++) {
+							const Palette_Histogram::Bin& bin = histogram.data[used[u]];
+							Sum& s = local[palette.Nearest(histogram.Mean(used[u]))];
+							s.r += bin.r; s.g += bin.g; s.b += bin.b; s.n += bin.count;
+						}
+						std::lock_guard<std::mutex> guard(lock);
+						partial.push_back(std::move(local));
+					});
+
+					bool moved = false;
+					for (size_t k = 0; k < palette.Size(); k++) {
+						Sum total;
+						for (const std::vector<Sum>& p : partial) {
+							total.r += p[k].r; total.g += p[k].g; total.b += p[k].b; total.n += p[k].n;
+						}
+						if (total.n == 0)
+							continue;
+						RGB32 c(static_cast<BYTE>((total.r + total.n / 2) / total.n), static_cast<BYTE>((total.g + total.n / 2) / total.n), static_cast<BYTE>((total.b + total.n / 2) / total.n));
+						moved |= !(c == palette.colors[k]);
+						palette.colors[k] = c;
+					}
+					if (!moved)
+						break;
+				}
+
+				palette.Build_Map();
+				return palette;
+			}
+		};
+
+		// /-----------------------------------------------\
+		// | Histograms & Statistics                       |
+		// \-----------------------------------------------/
+
+		enum class Histogram_Channel
+		{
+			Red,
+			Green,
+			Blue,
+			Alpha,
+			Luma,		// RGB32_TO_GRAYSCALE value
+			Hue			// HSV32 hue, achromatic pixels are not counted
+		};
+
+		// < 256 bin histograms of every channel of an RGB32 image >
+		class Color_Histogram
+		{
+		public:
+			static constexpr size_t channels = 6;
+			static constexpr size_t lanes = 4;
+
+			typedef std::array<unsigned long long, 256> Bins;
+
+		private:
+			std::array<Bins, channels> bins{};
+
+			// Independent copies per lane, so neighbouring pixels with the same value
+			// never wait on each other's increment of one counter. Counter is signed
+			// for in-place updates, which add and remove pixels in the same partial.
+			template<typename Counter>
+			struct Partial
+			{
+				std::array<std::array<std::array<Counter, 256>, lanes>, channels> counts{};
+
+				// Counts n pixels with weight Delta (+1 adds, -1 removes)
+				template<int Delta>
+				void Count(const RGB32* p, size_t n)
+				{
+					for (size_t i = 0; i < n; i++) {
+						const RGB32 c = p[i];
+						const size_t lane = i & (lanes - 1);
+						counts[0][lane][c.r] += Delta;
+						counts[1][lane][c.g] += Delta;
+						counts[2][lane][c.b] += Delta;
+						counts[3][lane][c.a] += Delta;
+						counts[4][lane][(LUMA_R_Q16 * c.r + LUMA_G_Q16 * c.g + LUMA_B_Q16 * c.b) >> 16] += Delta;
+
+						int cMax = std::max({ c.r, c.g, c.b });
+						int delta = cMax - std::min({ c.r, c.g, c.b });
+						if (delta)
+							counts[5][lane][byte_hue(c.r, c.g, c.b, cMax, delta)] += Delta;
+					}
+				}
+			};
+
+			// Runs count(partial, row) over rows split across threads, each row touching at most
+			// row_pixels pixels. Partials hold 32bit counts, so a thread starts a new one before
+			// they could overflow.
+			template<typename Counter, typename Function>
+			static std::vector<std::unique_ptr<Partial<Counter>>> Count_Rows(size_t rows, size_t row_pixels, Function count)
+			{
+				const size_t flush = std::max<size_t>((size_t(1) << 31) / std::max<size_t>(row_pixels, 1), 1);
+				std::vector<std::unique_ptr<Partial<Counter>>> partial;
+				std::mutex lock;
+
+				Parallel_For(rows, std::max<size_t>(16384 / std::max<size_t>(row_pixels, 1), 1), [&](size_t begin, size_t end) {
+					std::vector<std::unique_ptr<Partial<Counter>>> done;
+					for (size_t start = begin; start < end; start += flush) {
+						done.emplace_back(new Partial<Counter>);
+						for (size_t row = start; row < std::min(start + flush, end); row++)
+							count(*done.back(), row);
+					}
+
+					std::lock_guard<std::mutex> guard(lock);
+					for (std::unique_ptr<Partial<Counter>>& p : done)
+						partial.push_back(std::move(p));
+				});
+				return partial;
+			}
+
+			// Adds sign times the sum of the partials to the bins. A handful of partials is
+			// only ~6K additions each, so this stays on the calling thread.
+			template<typename Counter>
+			void Merge(const std::vector<std::unique_ptr<Partial<Counter>>>& partial, int sign)
+			{
+				for (size_t ch = 0; ch < channels; ch++)
+					for (size_t bin = 0; bin < 256; bin++) {
+						long long total = 0;
+						for (const std::unique_ptr<Partial<Counter>>& p : partial)
+							for (size_t lane = 0; lane < lanes; lane++)
+								total += static_cast<long long>(p->counts[ch][lane][bin]);
+						total *= sign;
+						// Removing pixels that were never added is a caller bug, not something to clamp away
+						assert(total >= 0 || static_cast<unsigned long long>(-total) <= bins[ch][bin]);
+						bins[ch][bin] += static_cast<unsigned long long>(total);
+					}
+			}
+
+			// sign = +1 adds, -1 removes (the pixels must have been added before)
+			void Accumulate(std::span<const RGB32> pixels, int sign)
+			{
+				const size_t row = 16384;
+				Merge(Count_Rows<unsigned int>((pixels.size() + row - 1) / row, row, [&](Partial<unsigned int>& p, size_t i) {
+					p.Count<1>(pixels.data() + i * row, std::min(row, pixels.size() - i * row));
+				}), sign);
+			}
+
+		public:
+			Color_Histogram() {}
+			explicit Color_Histogram(std::span<const RGB32> pixels) { Add(pixels); }
+
+			void Clear() { bins = {}; }
+
+			void Add(std::span<const RGB32> pixels) { Accumulate(pixels, 1); }
+			void Remove(std::span<const RGB32> pixels) { Accumulate(pixels, -1); }
+
+			// Incremental update when pixels change from before to after
+			void Update(std::span<const RGB32> before, std::span<const RGB32> after)
+			{
+				const size_t count = std::min(before.size(), after.size());
+				Update_Region(before.first(count), after.first(count), count, 0, 0, count, count ? 1 : 0);
+			}
+
+			// Incremental update of a dirty rectangle, images stored row-major with stride pixels per row.
+			// Every row is counted into one set of signed partials (before removed, after added) and
+			// merged once, so the cost follows the rectangle, not the number of rows.
+			void Update_Region(std::span<const RGB32> before, std::span<const RGB32> after, size_t stride, size_t x, size_t y, size_t width, size_t height)
+			{
+				// Rows past the end of either image are dropped
+				const size_t size = std::min(before.size(), after.size());
+				if (width == 0 || x + width > stride || x + width > size || y > (size - x - width) / stride)
+					return;
+				height = std::min(height, (size - x - width) / stride - y + 1);
+
+				Merge(Count_Rows<int>(height, 2 * width, [&](Partial<int>& p, size_t row) {
+					const size_t offset = (y + row) * stride + x;
+					p.Count<-1>(before.data() + offset, width);
+					p.Count<1>(after.data() + offset, width);
+				}), 1);
+			}
+
+			// < Queries >
+
+			const Bins& Get(Histogram_Channel channel) const { return bins[static_cast<size_t>(channel)]; }
+
+			unsigned long long Count(Histogram_Channel channel) const
+			{
+				unsigned long long total = 0;
+				for (unsigned long long n : Get(channel))
+					total += n;
+				return total;
+			}
+
+			// Smallest / largest value present, 0 when empty
+			BYTE Min(Histogram_Channel channel) const
+			{
+				const Bins& h = Get(channel);
+				for (size_t i = 0; i < 256; i++)
+					if (h[i]) return static_cast<BYTE>(i);
+				return 0;
+			}
+
+			BYTE Max(Histogram_Channel channel) const
+			{
+				const Bins& h = Get(channel);
+				for (size_t i = 256; i-- > 0;)
+					if (h[i]) return static_cast<BYTE>(i);
+				return 0;
+			}
+
+			float Mean(Histogram_Channel channel) const
+			{
+				const Bins& h = Get(channel);
+				unsigned long long total = 0, sum = 0;
+				for (size_t i = 0; i < 256; i++) {
+					total += h[i];
+					sum += h[i] * i;
+				}
+				return total ? static_cast<float>(static_cast<double>(sum) / total) : 0.0f;
+			}
+
+			// Smallest value v with at least p (0.0 - 1.0) of the pixels <= v
+			BYTE Percentile(Histogram_Channel channel, float p) const
+			{
+				const Bins& h = Get(channel);
+				const unsigned long long total = Count(channel);
+				if (total == 0)
+					return 0;
+
+				const unsigned long long target = std::max<unsigned long long>(static_cast<unsigned long long>(ceil(std::clamp(p, 0.0f, 1.0f) * static_cast<double>(total))), 1);
+				unsigned long long seen = 0;
+				for (size_t i = 0; i < 256; i++) {
+					seen += h[i];
+					if (seen >= target)
+						return static_cast<BYTE>(i);
+				}
+				return 255;
+			}
+
+			BYTE Median(Histogram_Channel channel) const { return Percentile(channel, 0.5f); }
+		};
+
+		// /-----------------------------------------------\
+		// | Perceptual Color Spaces                       |
+		// \-----------------------------------------------/
+
+		inline constexpr double COLOR_PI = 3.14159265358979323846;
+
+		// < CIE Lab, D65 white, through linear sRGB and XYZ >
+
+		inline constexpr float LAB_WHITE_X = 0.95047f;
+		inline constexpr float LAB_WHITE_Z = 1.08883f;
+		inline constexpr float LAB_EPSILON = 216.0f / 24389.0f;
+		inline constexpr float LAB_KAPPA = 24389.0f / 27.0f;
+
+		inline float lab_f(float t) { return t > LAB_EPSILON ? cbrtf(t) : (LAB_KAPPA * t + 16.0f) / 116.0f; }
+		inline float lab_f_inverse(float f) { float t = f * f * f; return t > LAB_EPSILON ? t : (116.0f * f - 16.0f) / LAB_KAPPA; }
+
+		// Linear RGB -> Lab
+		inline Lab LINEAR_TO_LAB(RGB rgb)
+		{
+			float x = (0.4124564f * rgb.r + 0.3575761f * rgb.g + 0.1804375f * rgb.b) / LAB_WHITE_X;
+			float y = 0.2126729f * rgb.r + 0.7151522f * rgb.g + 0.0721750f * rgb.b;
+			float z = (0.0193339f * rgb.r + 0.1191920f * rgb.g + 0.9503041f * rgb.b) / LAB_WHITE_Z;
+
+			float fx = lab_f(x), fy = lab_f(y), fz = lab_f(z);
+			return Lab(116.0f * fy - 16.0f, 500.0f * (fx - fy), 200.0f * (fy - fz), rgb.a);
+		}
+
+		// Lab -> linear RGB, unclamped
+		inline RGB LAB_TO_LINEAR(Lab lab)
+		{
+			float fy = (lab.l + 16.0f) / 116.0f;
+			float x = lab_f_inverse(fy + lab.a / 500.0f) * LAB_WHITE_X;
+			float y = lab_f_inverse(fy);
+			float z = lab_f_inverse(fy - lab.b / 200.0f) * LAB_WHITE_Z;
+
+			return RGB(3.2404542f * x - 1.5371385f * y - 0.4985314f * z,
+				-0.9692660f * x + 1.8760108f * y + 0.0415560f * z,
+				0.0556434f * x - 0.2040259f * y + 1.0572252f * z, lab.alpha);
+		}
+
+		inline Lab RGB_TO_LAB(RGB rgb) { return LINEAR_TO_LAB(SRGB_TO_LINEAR(rgb)); }
+		inline Lab RGB32_TO_LAB(RGB32 rgb32) { return LINEAR_TO_LAB(RGB32_TO_LINEAR(rgb32)); }
+		inline RGB LAB_TO_RGB(Lab lab) { return LINEAR_TO_SRGB(LAB_TO_LINEAR(lab)); }
+		inline RGB32 LAB_TO_RGB32(Lab lab) { return LINEAR_TO_RGB32(LAB_TO_LINEAR(lab)); }
+
+		std::ostream& operator << (std::ostream& os, const Lab& lab)
+		{
+			os << "L: " << lab.l << " a: " << lab.a << " b: " << lab.b << " A: " << lab.alpha;
+			return os;
+		}
+
+		// < OKLab / OKLCh >
+
+		// Linear RGB -> OKLab
+		inline OKLab LINEAR_TO_OKLAB(RGB rgb)
+		{
+			float l = cbrtf(0.4122214708f * rgb.r + 0.5363325363f * rgb.g + 0.0514459929f * rgb.b);
+			float m = cbrtf(0.2119034982f * rgb.r + 0.6806995451f * rgb.g + 0.1073969566f * rgb.b);
+			float s = cbrtf(0.0883024619f * rgb.r + 0.2817188376f * rgb.g + 0.6299787005f * rgb.b);
+
+			return OKLab(0.2104542553f * l + 0.7936177850f * m - 0.0040720468f * s,
+				1.9779984951f * l - 2.4285922050f * m + 0.4505937099f * s,
+				0.0259040371f * l + 0.7827717662f * m - 0.8086757660f * s, rgb.a);
+		}
+
+		// OKLab -> linear RGB, unclamped
+		inline RGB OKLAB_TO_LINEAR(OKLab oklab)
+		{
+			float l = oklab.l + 0.3963377774f * oklab.a + 0.2158037573f * oklab.b;
+			float m = oklab.l - 0.1055613458f * oklab.a - 0.0638541728f * oklab.b;
+			float s = oklab.l - 0.0894841775f * oklab.a - 1.2914855480f * oklab.b;
+			l = l * l * l; m = m * m * m; s = s * s * s;
+
+			return RGB(4.0767416621f * l - 3.3077115913f * m + 0.2309699292f * s,
+				-1.2684380046f * l + 2.6097574011f * m - 0.3413193965f * s,
+				-0.0041960863f * l - 0.7034186147f * m + 1.7076147010f * s, oklab.alpha);
+		}
+
+		inline OKLab RGB_TO_OKLAB(RGB rgb) { return LINEAR_TO_OKLAB(SRGB_TO_LINEAR(rgb)); }
+		inline OKLab RGB32_TO_OKLAB(RGB32 rgb32) { return LINEAR_TO_OKLAB(RGB32_TO_LINEAR(rgb32)); }
+		inline RGB OKLAB_TO_RGB(OKLab oklab) { return LINEAR_TO_SRGB(OKLAB_TO_LINEAR(oklab)); }
+		inline RGB32 OKLAB_TO_RGB32(OKLab oklab) { return LINEAR_TO_RGB32(OKLAB_TO_LINEAR(oklab)); }
+
+		inline OKLCh OKLAB_TO_OKLCH(OKLab oklab)
+		{
+			float h = atan2f(oklab.b, oklab.a) * static_cast<float>(0.5 / COLOR_PI);
+			if (h < 0.0f)
+				h++;
+			return OKLCh(oklab.l, sqrtf(oklab.a * oklab.a + oklab.b * oklab.b), h, oklab.alpha);
+		}
+		inline OKLab OKLCH_TO_OKLAB(OKLCh oklch)
+		{
+			float h = oklch.h * static_cast<float>(2.0 * COLOR_PI);
+			return OKLab(oklch.l, oklch.c * cosf(h), oklch.c * sinf(h), oklch.alpha);
+		}
+
+		std::ostream& operator << (std::ostream& os, const OKLab& oklab)
+		{
+			os << "L: " << oklab.l << " a: " << oklab.a << " b: " << oklab.b << " A: " << oklab.alpha;
+			return os;
+		}
+		std::ostream& operator << (std::ostream& os, const OKLCh& oklch)
+		{
+			os << "L: " << oklch.l << " C: " << oklch.c << " H: " << oklch.h << " A: " << oklch.alpha;
+			return os;
+		}
+
+		// < Color difference >
+
+		// Euclidean distance in OKLab
+		inline float Delta_EOK(OKLab x, OKLab y)
+		{
+			float dl = x.l - y.l, da = x.a - y.a, db = x.b - y.b;
+			return sqrtf(dl * dl + da * da + db * db);
+		}
+
+		// CIEDE2000 (Sharma, Wu, Dalal 2005), kL = kC = kH = 1
+		inline float Delta_E2000(Lab x, Lab y)
+		{
+			const float pi = static_cast<float>(COLOR_PI), radians = pi / 180.0f;
+			const float pow25_7 = 6103515625.0f;
+
+			float C1 = sqrtf(x.a * x.a + x.b * x.b), C2 = sqrtf(y.a * y.a + y.b * y.b);
+			float C = (C1 + C2) * 0.5f, C7 = C * C * C; C7 = C7 * C7 * C;
+			float G = 0.5f * (1.0f - sqrtf(C7 / (C7 + pow25_7)));
+
+			float a1 = (1.0f + G) * x.a, a2 = (1.0f + G) * y.a;
+			float c1 = sqrtf(a1 * a1 + x.b * x.b), c2 = sqrtf(a2 * a2 + y.b * y.b);
+			float h1 = atan2f(x.b, a1), h2 = atan2f(y.b, a2);
+			if (h1 < 0.0f) h1 += 2.0f * pi;
+			if (h2 < 0.0f) h2 += 2.0f * pi;
+
+			float dL = y.l - x.l, dC = c2 - c1;
+			float dh = h2 - h1;
+			if (dh > pi) dh -= 2.0f * pi;
+			else if (dh < -pi) dh += 2.0f * pi;
+			if (c1 * c2 == 0.0f) dh = 0.0f;
+			float dH = 2.0f * sqrtf(c1 * c2) * sinf(dh * 0.5f);
+
+			float L = (x.l + y.l) * 0.5f, c = (c1 + c2) * 0.5f;
+			float h = h1 + h2;
+			if (c1 * c2 != 0.0f) {
+				if (fabsf(h1 - h2) > pi)
+					h += h < 2.0f * pi ? 2.0f * pi : -2.0f * pi;
+				h *= 0.5f;
+			}
+
+			float T = 1.0f - 0.17f * cosf(h - 30.0f * radians) + 0.24f * cosf(2.0f * h)
+				+ 0.32f * cosf(3.0f * h + 6.0f * radians) - 0.20f * cosf(4.0f * h - 63.0f * radians);
+			float q = (h / radians - 275.0f) / 25.0f;
+			float theta = 30.0f * radians * expf(-q * q);
+			float c7 = c * c * c; c7 = c7 * c7 * c;
+			float RT = -2.0f * sqrtf(c7 / (c7 + pow25_7)) * sinf(2.0f * theta);
+
+			float l50 = (L - 50.0f) * (L - 50.0f);
+			float SL = 1.0f + 0.015f * l50 / sqrtf(20.0f + l50);
+			float SC = 1.0f + 0.045f * c;
+			float SH = 1.0f + 0.015f * c * T;
+
+			float tL = dL / SL, tC = dC / SC, tH = dH / SH;
+			return sqrtf(tL * tL + tC * tC + tH * tH + RT * tC * tH);
+		}
+
+		// < SIMD math (polynomial approximations, relative error ~1e-6) >
+
+		namespace SIMD
+		{
+#if defined(ZCPP_COLOR_AVX2)
+			inline Float Sqrt(Float x) { return _mm256_sqrt_ps(x.v); }
+
+			// Exponent bits / 3 plus the bias correction, about 3% off
+			inline Float Cbrt_Estimate(Float x)
+			{
+				__m256i i = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_castps_si256(x.v)), _mm256_set1_ps(1.0f / 3.0f)));
+				return _mm256_castsi256_ps(_mm256_add_epi32(i, _mm256_set1_epi32(0x2a514067)));
+			}
+
+			// 2^n for whole n in [-126, 127]
+			inline Float Exp2_Int(Float n) { return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(_mm256_cvttps_epi32(n.v), _mm256_set1_epi32(127)), 23)); }
+#elif defined(ZCPP_COLOR_SSE2)
+			inline Float Sqrt(Float x) { return _mm_sqrt_ps(x.v); }
+
+			inline Float Cbrt_Estimate(Float x)
+			{
+				__m128i i = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(_mm_castps_si128(x.v)), _mm_set1_ps(1.0f / 3.0f)));
+				return _mm_castsi128_ps(_mm_add_epi32(i, _mm_set1_epi32(0x2a514067)));
+			}
+
+			inline Float Exp2_Int(Float n) { return _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(_mm_cvttps_epi32(n.v), _mm_set1_epi32(127)), 23)); }
+#else
+			inline Float Sqrt(Float x) { return sqrtf(x.v); }
+
+			inline Float Cbrt_Estimate(Float x)
+			{
+				unsigned int i;
+				memcpy(&i, &x.v, sizeof(i));
+				i = static_cast<unsigned int>(static_cast<float>(i) * (1.0f / 3.0f)) + 0x2a514067u;
+				float y;
+				memcpy(&y, &i, sizeof(y));
+				return y;
+			}
+
+			inline Float Exp2_Int(Float n) { return ldexpf(1.0f, static_cast<int>(n.v)); }
+#endif
+
+			// Bit-trick estimate refined by two Newton steps, odd so negative inputs work too
+			inline Float Cbrt(Float x)
+			{
+				Float ax = Abs(x);
+				Float y = Cbrt_Estimate(ax);
+				y = (y + y + ax / (y * y)) * (1.0f / 3.0f);
+				y = (y + y + ax / (y * y)) * (1.0f / 3.0f);
+				y = Select(ax == 0.0f, 0.0f, y);
+				return Select(x < 0.0f, 0.0f - y, y);
+			}
+
+			// e^x, flushing to 0 below about -87
+			inline Float Exp(Float x)
+			{
+				Float t = Max(x * 1.44269504f, -126.0f);
+				Float n = Floor(t);
+				Float f = (t - n) * 0.69314718f;
+				Float p = 1.0f + f * (1.0f + f * (0.5f + f * (1.0f / 6.0f + f * (1.0f / 24.0f + f * (1.0f / 120.0f + f * (1.0f / 720.0f + f * (1.0f / 5040.0f)))))));
+				return Select(x < -87.0f, 0.0f, p * Exp2_Int(n));
+			}
+
+			// Reduced to [-pi/2, pi/2] around the nearest multiple of pi
+			inline Float Sin(Float x)
+			{
+				Float k = Floor(x * static_cast<float>(1.0 / COLOR_PI) + 0.5f);
+				Float r = (x - k * 3.140625f) - k * 9.67653589793e-4f;
+				Float s = r * r;
+				Float p = r * (1.0f + s * (-1.0f / 6.0f + s * (1.0f / 120.0f + s * (-1.0f / 5040.0f + s * (1.0f / 362880.0f + s * (-1.0f / 39916800.0f))))));
+				Float odd = k - 2.0f * Floor(k * 0.5f);
+				return Select(odd == 1.0f, 0.0f - p, p);
+			}
+
+			inline Float Cos(Float x) { return Sin(x + static_cast<float>(COLOR_PI / 2.0)); }
+
+			// Same range and quadrant rules as atan2f
+			inline Float Atan2(Float y, Float x)
+			{
+				Float ax = Abs(x), ay = Abs(y);
+				Float hi = Max(ax, ay), lo = Min(ax, ay);
+				Float t = Select(hi == 0.0f, 0.0f, lo / hi);
+				Float s = t * t;
+				Float r = t * (0.99999934f + s * (-0.33329856f + s * (0.19946536f + s * (-0.13908534f + s * (0.09642004f + s * (-0.05590987f + s * (0.02186123f + s * -0.00405401f)))))));
+				r = Select(ay > ax, static_cast<float>(COLOR_PI / 2.0) - r, r);
+				r = Select(x < 0.0f, static_cast<float>(COLOR_PI) - r, r);
+				return Select(y < 0.0f, 0.0f - r, r);
+			}
+
+			// < Kernels >
+
+			inline Float Lab_F(Float t) { return Select(t > LAB_EPSILON, Cbrt(t), (LAB_KAPPA * t + 16.0f) * (1.0f / 116.0f)); }
+			inline Float Lab_F_Inverse(Float f) { Float t = f * f * f; return Select(t > LAB_EPSILON, t, (116.0f * f - 16.0f) * (1.0f / LAB_KAPPA)); }
+
+			inline Lab LINEAR_TO_LAB(const RGB& c)
+			{
+				Float x = (0.4124564f * c.r + 0.3575761f * c.g + 0.1804375f * c.b) * (1.0f / LAB_WHITE_X);
+				Float y = 0.2126729f * c.r + 0.7151522f * c.g + 0.0721750f * c.b;
+				Float z = (0.0193339f * c.r + 0.1191920f * c.g + 0.9503041f * c.b) * (1.0f / LAB_WHITE_Z);
+
+				Float fx = Lab_F(x), fy = Lab_F(y), fz = Lab_F(z);
+				return Lab{ 116.0f * fy - 16.0f, 500.0f * (fx - fy), 200.0f * (fy - fz), c.a };
+			}
+
+			inline RGB LAB_TO_LINEAR(const Lab& c)
+			{
+				Float fy = (c.l + 16.0f) * (1.0f / 116.0f);
+				Float x = Lab_F_Inverse(fy + c.a * (1.0f / 500.0f)) * LAB_WHITE_X;
+				Float y = Lab_F_Inverse(fy);
+				Float z = Lab_F_Inverse(fy - c.b * (1.0f / 200.0f)) * LAB_WHITE_Z;
+
+				return RGB{ 3.2404542f * x - 1.5371385f * y - 0.4985314f * z,
+					-0.9692660f * x + 1.8760108f * y + 0.0415560f * z,
+					0.0556434f * x - 0.2040259f * y + 1.0572252f * z, c.alpha };
+			}
+
+			inline OKLab LINEAR_TO_OKLAB(const RGB& c)
+			{
+				Float l = Cbrt(0.4122214708f * c.r + 0.5363325363f * c.g + 0.0514459929f * c.b);
+				Float m = Cbrt(0.2119034982f * c.r + 0.6806995451f * c.g + 0.1073969566f * c.b);
+				Float s = Cbrt(0.0883024619f * c.r + 0.2817188376f * c.g + 0.6299787005f * c.b);
+
+				return OKLab{ 0.2104542553f * l + 0.7936177850f * m - 0.0040720468f * s,
+					1.9779984951f * l - 2.4285922050f * m + 0.4505937099f * s,
+					0.0259040371f * l + 0.7827717662f * m - 0.8086757660f * s, c.a };
+			}
+
+			inline RGB OKLAB_TO_LINEAR(const OKLab& c)
+			{
+				Float l = c.l + 0.3963377774f * c.a + 0.2158037573f * c.b;
+				Float m = c.l - 0.1055613458f * c.a - 0.0638541728f * c.b;
+				Float s = c.l - 0.0894841775f * c.a - 1.2914855480f * c.b;
+				l = l * l * l; m = m * m * m; s = s * s * s;
+
+				return RGB{ 4.0767416621f * l - 3.3077115913f * m + 0.2309699292f * s,
+					-1.2684380046f * l + 2.6097574011f * m - 0.3413193965f * s,
+					-0.0041960863f * l - 0.7034186147f * m + 1.7076147010f * s, c.alpha };
+			}
+
+			inline RGB Decode(const RGB& c) { return RGB{ Curve_Lookup(SRGB_DECODE_FLOAT, c.r), Curve_Lookup(SRGB_DECODE_FLOAT, c.g), Curve_Lookup(SRGB_DECODE_FLOAT, c.b), c.a }; }
+			inline RGB Encode(const RGB& c) { return RGB{ Curve_Lookup(SRGB_ENCODE, c.r), Curve_Lookup(SRGB_ENCODE, c.g), Curve_Lookup(SRGB_ENCODE, c.b), c.a }; }
+
+			inline Float Delta_EOK(const OKLab& x, const OKLab& y)
+			{
+				Float dl = x.l - y.l, da = x.a - y.a, db = x.b - y.b;
+				return Sqrt(dl * dl + da * da + db * db);
+			}
+
+			// Branch-free mirror of Color::Delta_E2000
+			inline Float Delta_E2000(const Lab& x, const Lab& y)
+			{
+				const float pi = static_cast<float>(COLOR_PI), radians = pi / 180.0f;
+				const float pow25_7 = 6103515625.0f;
+
+				Float C1 = Sqrt(x.a * x.a + x.b * x.b), C2 = Sqrt(y.a * y.a + y.b * y.b);
+				Float C = (C1 + C2) * 0.5f, C7 = C * C * C; C7 = C7 * C7 * C;
+				Float G = 0.5f * (1.0f - Sqrt(C7 / (C7 + pow25_7)));
+
+				Float a1 = (1.0f + G) * x.a, a2 = (1.0f + G) * y.a;
+				Float c1 = Sqrt(a1 * a1 + x.b * x.b), c2 = Sqrt(a2 * a2 + y.b * y.b);
+				Float h1 = Atan2(x.b, a1), h2 = Atan2(y.b, a2);
+				h1 = Select(h1 < 0.0f, h1 + 2.0f * pi, h1);
+				h2 = Select(h2 < 0.0f, h2 + 2.0f * pi, h2);
+
+				Float zero_chroma = (c1 * c2) == 0.0f;
+				Float dL = y.l - x.l, dC = c2 - c1;
+				Float dh = h2 - h1;
+				dh = Select(dh > pi, dh - 2.0f * pi, Select(dh < -pi, dh + 2.0f * pi, dh));
+				dh = Select(zero_chroma, 0.0f, dh);
+				Float dH = 2.0f * Sqrt(c1 * c2) * Sin(dh * 0.5f);
+
+				Float L = (x.l + y.l) * 0.5f, c = (c1 + c2) * 0.5f;
+				Float h = h1 + h2;
+				Float wrap = Abs(h1 - h2) > pi;
+				Float hm = Select(wrap, Select(h < 2.0f * pi, h + 2.0f * pi, h - 2.0f * pi), h) * 0.5f;
+				h = Select(zero_chroma, h, hm);
+
+				Float T = 1.0f - 0.17f * Cos(h - 30.0f * radians) + 0.24f * Cos(2.0f * h)
+					+ 0.32f * Cos(3.0f * h + 6.0f * radians) - 0.20f * Cos(4.0f * h - 63.0f * radians);
+				Float q = (h * (1.0f / radians) - 275.0f) * (1.0f / 25.0f);
+				Float theta = 30.0f * radians * Exp(0.0f - q * q);
+				Float c7 = c * c * c; c7 = c7 * c7 * c;
+				Float RT = -2.0f * Sqrt(c7 / (c7 + pow25_7)) * Sin(2.0f * theta);
+
+				Float l50 = (L - 50.0f) * (L - 50.0f);
+				Float SL = 1.0f + 0.015f * l50 / Sqrt(20.0f + l50);
+				Float SC = 1.0f + 0.045f * c;
+				Float SH = 1.0f + 0.015f * c * T;
+
+				Float tL = dL / SL, tC = dC / SC, tH = dH / SH;
+				return Sqrt(Max(tL * tL + tC * tC + tH * tH + RT * tC * tH, 0.0f));
+			}
+		}
+
+		// < Bulk conversion >
+
+		inline void Convert(std::span<const RGB32> src, std::span<Lab> dst)
+		{
+			const size_t count = std::min(src.size(), dst.size());
+			const size_t width = SIMD::Float::width;
+			size_t i = 0;
+
+			if (width > 1) {
+				for (; i + width <= count; i += width)
+					SIMD::Store(dst.data() + i, SIMD::LINEAR_TO_LAB(SIMD::Load_Linear(src.data() + i)));
+			}
+
+			for (; i < count; i++)
+				dst[i] = RGB32_TO_LAB(src[i]);
+		}
+
+		inline void Convert(std::span<const RGB32> src, std::span<OKLab> dst)
+		{
+			const size_t count = std::min(src.size(), dst.size());
+			const size_t width = SIMD::Float::width;
+			size_t i = 0;
+
+			if (width > 1) {
+				for (; i + width <= count; i += width)
+					SIMD::Store(dst.data() + i, SIMD::LINEAR_TO_OKLAB(SIMD::Load_Linear(src.data() + i)));
+			}
+
+			for (; i < count; i++)
+				dst[i] = RGB32_TO_OKLAB(src[i]);
+		}
+
+		inline void Convert(std::span<const Lab> src, std::span<RGB32> dst)
+		{
+			const size_t count = std::min(src.size(), dst.size());
+			const size_t width = SIMD::Float::width;
+			size_t i = 0;
+
+			if (width > 1) {
+				for (; i + width <= count; i += width)
+					SIMD::Store_Linear(dst.data() + i, SIMD::LAB_TO_LINEAR(SIMD::Load(src.data() + i)));
+			}
+
+			for (; i < count; i++)
+				dst[i] = LAB_TO_RGB32(src[i]);
+		}
+
+		inline void Convert(std::span<const OKLab> src, std::span<RGB32> dst)
+		{
+			const size_t count = std::min(src.size(), dst.size());
+			const size_t width = SIMD::Float::width;
+			size_t i = 0;
+
+			if (width > 1) {
+				for (; i + width <= count; i += width)
+					SIMD::Store_Linear(dst.data() + i, SIMD::OKLAB_TO_LINEAR(SIMD::Load(src.data() + i)));
+			}
+
+			for (; i < count; i++)
+				dst[i] = OKLAB_TO_RGB32(src[i]);
+		}
+
+		inline void Convert(std::span<const RGB> src, std::span<Lab> dst) { Convert_Batch(src, dst, RGB_TO_LAB, [](const SIMD::RGB& c) { return SIMD::LINEAR_TO_LAB(SIMD::Decode(c)); }); }
+		inline void Convert(std::span<const RGB> src, std::span<OKLab> dst) { Convert_Batch(src, dst, RGB_TO_OKLAB, [](const SIMD::RGB& c) { return SIMD::LINEAR_TO_OKLAB(SIMD::Decode(c)); }); }
+		inline void Convert(std::span<const Lab> src, std::span<RGB> dst) { Convert_Batch(src, dst, LAB_TO_RGB, [](const SIMD::Lab& c) { return SIMD::Encode(SIMD::LAB_TO_LINEAR(c)); }); }
+		inline void Convert(std::span<const OKLab> src, std::span<RGB> dst) { Convert_Batch(src, dst, OKLAB_TO_RGB, [](const SIMD::OKLab& c) { return SIMD::Encode(SIMD::OKLAB_TO_LINEAR(c)); }); }
+
+		inline void Convert(std::span<const OKLab> src, std::span<OKLCh> dst) { Convert_Each(src, dst, OKLAB_TO_OKLCH); }
+		inline void Convert(std::span<const OKLCh> src, std::span<OKLab> dst) { Convert_Each(src, dst, OKLCH_TO_OKLAB); }
+
+		// < One-to-many color difference >
+
+		// Distance from target to every candidate, written to out
+		template<typename ColorSpace, typename Scalar, typename Vector>
+		void Delta_E_Batch(const ColorSpace& target, std::span<const ColorSpace> candidates, std::span<float> out, Scalar scalar, Vector vector)
+		{
+			const size_t count = std::min(candidates.size(), out.size());
+			const size_t width = SIMD::Float::width;
+			size_t i = 0;
+
+			if (width > 1) {
+				ColorSpace broadcast[SIMD::Float::width];
+				std::fill(broadcast, broadcast + width, target);
+				const auto t = SIMD::Load(broadcast);
+				for (; i + width <= count; i += width)
+					vector(t, SIMD::Load(candidates.data() + i)).Store(out.data() + i);
+			}
+
+			for (; i < count; i++)
+				out[i] = scalar(target, candidates[i]);
+		}
+
+		inline void Delta_E2000(const Lab& target, std::span<const Lab> candidates, std::span<float> out) { Delta_E_Batch(target, candidates, out, static_cast<float(*)(Lab, Lab)>(Delta_E2000), SIMD::Delta_E2000); }
+		inline void Delta_EOK(const OKLab& target, std::span<const OKLab> candidates, std::span<float> out) { Delta_E_Batch(target, candidates, out, static_cast<float(*)(OKLab, OKLab)>(Delta_EOK), SIMD::Delta_EOK); }
+
+		// Index of the closest candidate (ΔE2000 for Lab, ΔEOK for OKLab), candidates.size() when empty
+		template<typename ColorSpace>
+		size_t Nearest(const ColorSpace& target, std::span<const ColorSpace> candidates)
+		{
+			const size_t block = 256;
+			float distance[block];
+			float best = INFINITY;
+			size_t index = candidates.size();
+
+			for (size_t start = 0; start < candidates.size(); start += block) {
+				const size_t n = std::min(block, candidates.size() - start);
+				if constexpr (std::is_same<ColorSpace, Lab>::value)
+					Delta_E2000(target, candidates.subspan(start, n), std::span<float>(distance, n));
+				else
+					Delta_EOK(target, candidates.subspan(start, n), std::span<float>(distance, n));
+
+				for (size_t i = 0; i < n; i++)
+					if (distance[i] < best) { best = distance[i]; index = start + i; }
+			}
+			return index;
+		}
+
+		// /-----------------------------------------------\
+		// | YCbCr Video Frames                            |
+		// \-----------------------------------------------/
+
+		enum class YCbCr_Matrix
+		{
+			BT601,		// SD video, JPEG
+			BT709		// HD video
+		};
+
+		enum class YCbCr_Range
+		{
+			Limited,	// Y 16 - 235, CbCr 16 - 240 (what encoders expect)
+			Full		// 0 - 255
+		};
+
+		enum class Chroma_Subsampling
+		{
+			YUV444,		// One CbCr pair per pixel
+			YUV422,		// One per 2x1 pixels
+			YUV420		// One per 2x2 pixels
+		};
+
+		enum class YCbCr_Layout
+		{
+			Planar,		// Y, Cb, Cr planes (I420 / I422 / I444)
+			Semi_Planar	// Y plane, then interleaved CbCr (NV12 / NV16 / NV24)
+		};
+
+		// < Fixed point coefficients, Q15 for encoding and Q13 for decoding >
+		// Chroma is always computed from the sum of 4 samples (a 2x2 block, with
+		// duplicates for 4:2:2 / 4:4:4 / odd edges), so every layout rounds the same way.
+		struct YCbCr_Coefficients
+		{
+			int y_r, y_g, y_b, y_offset;
+			int cb_r, cb_g, cb_b;
+			int cr_r, cr_g, cr_b;
+			int r_cr, g_cb, g_cr, b_cb, y_scale;
+
+			YCbCr_Coefficients(YCbCr_Matrix matrix, YCbCr_Range range)
+			{
+				const double kr = matrix == YCbCr_Matrix::BT601 ? 0.299 : 0.2126;
+				const double kb = matrix == YCbCr_Matrix::BT601 ? 0.114 : 0.0722;
+				const double kg = 1.0 - kr - kb;
+				const bool limited = range == YCbCr_Range::Limited;
+				const double ys = (limited ? 219.0 : 255.0) / 255.0, cs = (limited ? 224.0 : 255.0) / 255.0;
+
+				auto q = [](double x, double one) { return static_cast<int>(lround(x * one)); };
+
+				// Rows sum to the exact scale, so white / gray never drift
+				y_offset = limited ? 16 : 0;
+				y_r = q(kr * ys, 32768.0); y_b = q(kb * ys, 32768.0); y_g = q(ys, 32768.0) - y_r - y_b;
+				cb_b = q(0.5 * cs, 32768.0); cb_r = q(-0.5 * kr / (1.0 - kb) * cs, 32768.0); cb_g = -cb_b - cb_r;
+				cr_r = q(0.5 * cs, 32768.0); cr_b = q(-0.5 * kb / (1.0 - kr) * cs, 32768.0); cr_g = -cr_r - cr_b;
+
+				y_scale = q(1.0 / ys, 8192.0);
+				r_cr = q(2.0 * (1.0 - kr) / cs, 8192.0);
+				b_cb = q(2.0 * (1.0 - kb) / cs, 8192.0);
+				g_cb = q(-2.0 * kb * (1.0 - kb) / kg / cs, 8192.0);
+				g_cr = q(-2.0 * kr * (1.0 - kr) / kg / cs, 8192.0);
+			}
+
+			BYTE Luma(RGB32 c) const
+			{
+				return static_cast<BYTE>(std::clamp(((y_r * c.r + y_g * c.g + y_b * c.b + (1 << 14)) >> 15) + y_offset, 0, 255));
+			}
+
+			// r, g, b are sums of 4 samples
+			BYTE Cb(int r, int g, int b) const { return static_cast<BYTE>(std::clamp(((cb_r * r + cb_g * g + cb_b * b + (1 << 16)) >> 17) + 128, 0, 255)); }
+			BYTE Cr(int r, int g, int b) const { return static_cast<BYTE>(std::clamp(((cr_r * r + cr_g * g + cr_b * b + (1 << 16)) >> 17) + 128, 0, 255)); }
+
+			RGB32 To_RGB32(BYTE y, BYTE cb, BYTE cr) const
+			{
+				int l = (y - y_offset) * y_scale + 4096;
+				int u = cb - 128, v = cr - 128;
+				return RGB32(static_cast<BYTE>(std::clamp((l + r_cr * v) >> 13, 0, 255)),
+					static_cast<BYTE>(std::clamp((l + g_cb * u + g_cr * v) >> 13, 0, 255)),
+					static_cast<BYTE>(std::clamp((l + b_cb * u) >> 13, 0, 255)));
+			}
+		};
+
+		// < One contiguous buffer: Y plane followed by the chroma plane(s), rows tightly packed >
+		class YCbCr_Image
+		{
+		private:
+			size_t width = 0, height = 0;
+			Chroma_Subsampling subsampling = Chroma_Subsampling::YUV420;
+			YCbCr_Layout layout = YCbCr_Layout::Planar;
+			YCbCr_Matrix matrix = YCbCr_Matrix::BT709;
+			YCbCr_Range range = YCbCr_Range::Limited;
+			std::vector<BYTE> data;
+
+		public:
+			YCbCr_Image() {}
+			YCbCr_Image(size_t width, size_t height, Chroma_Subsampling subsampling = Chroma_Subsampling::YUV420, YCbCr_Layout layout = YCbCr_Layout::Planar,
+				YCbCr_Matrix matrix = YCbCr_Matrix::BT709, YCbCr_Range range = YCbCr_Range::Limited)
+			{
+				Resize(width, height, subsampling, layout, matrix, range);
+			}
+
+			void Resize(size_t width, size_t height, Chroma_Subsampling subsampling = Chroma_Subsampling::YUV420, YCbCr_Layout layout = YCbCr_Layout::Planar,
+				YCbCr_Matrix matrix = YCbCr_Matrix::BT709, YCbCr_Range range = YCbCr_Range::Limited)
+			{
+				this->width = width; this->height = height;
+				this->subsampling = subsampling; this->layout = layout;
+				this->matrix = matrix; this->range = range;
+				data.assign(width * height + 2 * Chroma_Width() * Chroma_Height(), 0);
+			}
+
+			size_t Width() const { return width; }
+			size_t Height() const { return height; }
+			Chroma_Subsampling Subsampling() const { return subsampling; }
+			YCbCr_Layout Layout() const { return layout; }
+			YCbCr_Matrix Matrix() const { return matrix; }
+			YCbCr_Range Range() const { return range; }
+
+			// Pixels per chroma sample horizontally / vertically
+			size_t Chroma_X() const { return subsampling == Chroma_Subsampling::YUV444 ? 1 : 2; }
+			size_t Chroma_Y() const { return subsampling == Chroma_Subsampling::YUV420 ? 2 : 1; }
+			size_t Chroma_Width() const { return (width + Chroma_X() - 1) / Chroma_X(); }
+			size_t Chroma_Height() const { return (height + Chroma_Y() - 1) / Chroma_Y(); }
+
+			// Distance between consecutive Cb (or Cr) bytes in a row: 1 planar, 2 semi-planar
+			size_t Chroma_Step() const { return layout == YCbCr_Layout::Planar ? 1 : 2; }
+			size_t Chroma_Stride() const { return Chroma_Width() * Chroma_Step(); }
+
+			BYTE* Y(size_t row = 0) { return data.data() + row * width; }
+			const BYTE* Y(size_t row = 0) const { return data.data() + row * width; }
+			BYTE* Cb(size_t row = 0) { return data.data() + width * height + row * Chroma_Stride(); }
+			const BYTE* Cb(size_t row = 0) const { return data.data() + width * height + row * Chroma_Stride(); }
+			BYTE* Cr(size_t row = 0) { return layout == YCbCr_Layout::Planar ? Cb(row) + Chroma_Width() * Chroma_Height() : Cb(row) + 1; }
+			const BYTE* Cr(size_t row = 0) const { return layout == YCbCr_Layout::Planar ? Cb(row) + Chroma_Width() * Chroma_Height() : Cb(row) + 1; }
+
+			// The whole frame, ready for an encoder
+			std::span<BYTE> Data() { return data; }
+			std::span<const BYTE> Data() const { return data; }
+		};
+
+#if defined(ZCPP_COLOR_SSE2)
+		namespace SIMD
+		{
+			// < SSE2 integer kernels (also used by AVX2 builds) >
+
+			// 4 x (c0 * r + c1 * g + c2 * b) for 4 RGB32 pixels, coef = { c0, c1, c2, 0 } x 2 as int16
+			inline __m128i Dot_RGB32(__m128i px, __m128i coef)
+			{
+				const __m128i zero = _mm_setzero_si128();
+				__m128 lo = _mm_castsi128_ps(_mm_madd_epi16(_mm_unpacklo_epi8(px, zero), coef));
+				__m128 hi = _mm_castsi128_ps(_mm_madd_epi16(_mm_unpackhi_epi8(px, zero), coef));
+				__m128i even = _mm_castps_si128(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)));
+				__m128i odd = _mm_castps_si128(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1)));
+				return _mm_add_epi32(even, odd);
+			}
+
+			// Channel sums of the two 2x2 blocks in 4 pixels of row0 and row1, as { r, g, b, a } x 2 int16
+			inline __m128i Block_Sums(__m128i row0, __m128i row1)
+			{
+				const __m128i zero = _mm_setzero_si128();
+				__m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(row0, zero), _mm_unpacklo_epi8(row1, zero));
+				__m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(row0, zero), _mm_unpackhi_epi8(row1, zero));
+				lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+				hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+				return _mm_unpacklo_epi64(lo, hi);
+			}
+
+			// 4 chroma values from the block sums of 8 pixels (two Block_Sums results)
+			inline __m128i Block_Chroma(__m128i sums0, __m128i sums1, __m128i coef)
+			{
+				__m128 a = _mm_castsi128_ps(_mm_madd_epi16(sums0, coef));
+				__m128 b = _mm_castsi128_ps(_mm_madd_epi16(sums1, coef));
+				__m128i even = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+				__m128i odd = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+				__m128i sum = _mm_add_epi32(_mm_add_epi32(even, odd), _mm_set1_epi32(1 << 16));
+				return _mm_add_epi32(_mm_srai_epi32(sum, 17), _mm_set1_epi32(128));
+			}
+
+			// Packs 4 int32 to 4 clamped bytes in the low 32 bits
+			inline __m128i Pack_Bytes(__m128i x) { x = _mm_packs_epi32(x, x); return _mm_packus_epi16(x, x); }
+
+			inline __m128i Coefficients(int c0, int c1, int c2) { return _mm_setr_epi16(c0, c1, c2, 0, c0, c1, c2, 0); }
+		}
+#endif
+
+		// One row (or row pair) of RGB32 into Y and chroma. row1 == row0 unless 4:2:0.
+		inline void YCbCr_Encode_Row(const YCbCr_Coefficients& k, const RGB32* row0, const RGB32* row1, size_t width, size_t chroma_x,
+			BYTE* y0, BYTE* y1, BYTE* cb, BYTE* cr, size_t step)
+		{
+			size_t x = 0;
+#if defined(ZCPP_COLOR_SSE2)
+			const __m128i y_coef = SIMD::Coefficients(k.y_r, k.y_g, k.y_b);
+			const __m128i y_bias = _mm_set1_epi32(1 << 14), y_offset = _mm_set1_epi32(k.y_offset);
+
+			auto luma = [&](const RGB32* src, BYTE* dst) {
+				__m128i a = SIMD::Dot_RGB32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)), y_coef);
+				__m128i b = SIMD::Dot_RGB32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4)), y_coef);
+				a = _mm_add_epi32(_mm_srai_epi32(_mm_add_epi32(a, y_bias), 15), y_offset);
+				b = _mm_add_epi32(_mm_srai_epi32(_mm_add_epi32(b, y_bias), 15), y_offset);
+				__m128i w = _mm_packs_epi32(a, b);
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(dst), _mm_packus_epi16(w, w));
+			};
+
+			for (; x + 8 <= width; x += 8) {
+				luma(row0 + x, y0 + x);
+				if (y1)
+					luma(row1 + x, y1 + x);
+			}
+#endif
+			for (; x < width; x++) {
+				y0[x] = k.Luma(row0[x]);
+				if (y1)
+					y1[x] = k.Luma(row1[x]);
+			}
+
+			const size_t chroma_width = (width + chroma_x - 1) / chroma_x;
+			size_t c = 0;
+#if defined(ZCPP_COLOR_SSE2)
+			const __m128i cb_coef = SIMD::Coefficients(k.cb_r, k.cb_g, k.cb_b);
+			const __m128i cr_coef = SIMD::Coefficients(k.cr_r, k.cr_g, k.cr_b);
+
+			for (; (c + 4) * chroma_x <= width; c += 4) {
+				__m128i u, v;
+				if (chroma_x == 2) {
+					const __m128i* a = reinterpret_cast<const __m128i*>(row0 + 2 * c);
+					const __m128i* b = reinterpret_cast<const __m128i*>(row1 + 2 * c);
+					__m128i s0 = SIMD::Block_Sums(_mm_loadu_si128(a), _mm_loadu_si128(b));
+					__m128i s1 = SIMD::Block_Sums(_mm_loadu_si128(a + 1), _mm_loadu_si128(b + 1));
+					u = SIMD::Pack_Bytes(SIMD::Block_Chroma(s0, s1, cb_coef));
+					v = SIMD::Pack_Bytes(SIMD::Block_Chroma(s0, s1, cr_coef));
+				}
+				else {
+					// (4 * dot + 2^16) >> 17 == (dot + 2^14) >> 15
+					__m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + c));
+					const __m128i bias = _mm_set1_epi32(1 << 14), mid = _mm_set1_epi32(128);
+					u = SIMD::Pack_Bytes(_mm_add_epi32(_mm_srai_epi32(_mm_add_epi32(SIMD::Dot_RGB32(px, cb_coef), bias), 15), mid));
+					v = SIMD::Pack_Bytes(_mm_add_epi32(_mm_srai_epi32(_mm_add_epi32(SIMD::Dot_RGB32(px, cr_coef), bias), 15), mid));
+				}
+
+				if (step == 1) {
+					int ui = _mm_cvtsi128_si32(u), vi = _mm_cvtsi128_si32(v);
+					memcpy(cb + c, &ui, 4);
+					memcpy(cr + c, &vi, 4);
+				}
+				else
+					_mm_storel_epi64(reinterpret_cast<__m128i*>(cb + 2 * c), _mm_unpacklo_epi8(u, v));
+			}
+#endif
+			for (; c < chroma_width; c++) {
+				const size_t xa = c * chroma_x, xb = std::min(xa + chroma_x - 1, width - 1);
+				const RGB32 p0 = row0[xa], p1 = row0[xb], p2 = row1[xa], p3 = row1[xb];
+				const int r = p0.r + p1.r + p2.r + p3.r, g = p0.g + p1.g + p2.g + p3.g, b = p0.b + p1.b + p2.b + p3.b;
+				cb[c * step] = k.Cb(r, g, b);
+				cr[c * step] = k.Cr(r, g, b);
+			}
+		}
+
+		// One row of Y plus its chroma row into RGB32 (alpha 255), chroma replicated across its block
+		inline void YCbCr_Decode_Row(const YCbCr_Coefficients& k, const BYTE* y, const BYTE* cb, const BYTE* cr, size_t step, size_t chroma_x, RGB32* dst, size_t width)
+		{
+			size_t x = 0;
+#if defined(ZCPP_COLOR_SSE2)
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i offset = _mm_set1_epi16(static_cast<short>(k.y_offset)), mid = _mm_set1_epi16(128);
+			// Two int16 coefficients per int32 lane: lo multiplies Y, hi multiplies the chroma
+			auto pair = [](int lo, int hi) { return _mm_set1_epi32(static_cast<int>((static_cast<unsigned>(hi) << 16) | (static_cast<unsigned>(lo) & 0xFFFF))); };
+			const __m128i r_coef = pair(k.y_scale, k.r_cr), b_coef = pair(k.y_scale, k.b_cb);
+			const __m128i g_coef = pair(k.y_scale, k.g_cb), g_cr = pair(0, k.g_cr);
+			const __m128i bias = _mm_set1_epi32(4096);
+
+			auto finish = [&](__m128i a, __m128i b) {
+				a = _mm_srai_epi32(_mm_add_epi32(a, bias), 13);
+				b = _mm_srai_epi32(_mm_add_epi32(b, bias), 13);
+				__m128i w = _mm_packs_epi32(a, b);
+				return _mm_packus_epi16(w, w);
+			};
+
+			for (; x + 8 <= width; x += 8) {
+				__m128i l = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(y + x)), zero), offset);
+				__m128i u, v;
+				const size_t c = x / chroma_x;
+
+				if (step == 2) {
+					// Interleaved CbCr as little endian words: cb | cr << 8
+					__m128i uv = chroma_x == 2 ? _mm_loadl_epi64(reinterpret_cast<const __m128i*>(cb + 2 * c)) : _mm_loadu_si128(reinterpret_cast<const __m128i*>(cb + 2 * c));
+					if (chroma_x == 2)
+						uv = _mm_unpacklo_epi16(uv, uv);
+					u = _mm_and_si128(uv, _mm_set1_epi16(0xFF));
+					v = _mm_srli_epi16(uv, 8);
+				}
+				else {
+					int ui, vi;
+					if (chroma_x == 2) {
+						memcpy(&ui, cb + c, 4); memcpy(&vi, cr + c, 4);
+						u = _mm_cvtsi32_si128(ui); v = _mm_cvtsi32_si128(vi);
+						u = _mm_unpacklo_epi8(u, u); v = _mm_unpacklo_epi8(v, v);
+					}
+					else {
+						u = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(cb + c));
+						v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(cr + c));
+					}
+					u = _mm_unpacklo_epi8(u, zero); v = _mm_unpacklo_epi8(v, zero);
+				}
+				u = _mm_sub_epi16(u, mid);
+				v = _mm_sub_epi16(v, mid);
+
+				// (y, cb) and (y, cr) pairs for pmaddwd
+				__m128i lu_lo = _mm_unpacklo_epi16(l, u), lu_hi = _mm_unpackhi_epi16(l, u);
+				__m128i lv_lo = _mm_unpacklo_epi16(l, v), lv_hi = _mm_unpackhi_epi16(l, v);
+
+				__m128i r = finish(_mm_madd_epi16(lv_lo, r_coef), _mm_madd_epi16(lv_hi, r_coef));
+				__m128i g = finish(_mm_add_epi32(_mm_madd_epi16(lu_lo, g_coef), _mm_madd_epi16(lv_lo, g_cr)),
+					_mm_add_epi32(_mm_madd_epi16(lu_hi, g_coef), _mm_madd_epi16(lv_hi, g_cr)));
+				__m128i b = finish(_mm_madd_epi16(lu_lo, b_coef), _mm_madd_epi16(lu_hi, b_coef));
+
+				__m128i rg = _mm_unpacklo_epi8(r, g);
+				__m128i ba = _mm_unpacklo_epi8(b, _mm_set1_epi8(static_cast<char>(0xFF)));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), _mm_unpacklo_epi16(rg, ba));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x + 4), _mm_unpackhi_epi16(rg, ba));
+			}
+#endif
+			for (; x < width; x++) {
+				const size_t c = (x / chroma_x) * step;
+				dst[x] = k.To_RGB32(y[x], cb[c], cr[c]);
+			}
+		}
+
+		// < Frame conversion, rows split across threads >
+
+		// RGB32 (width * height, row-major) -> YCbCr, chroma averaged over each block in the same pass
+		inline bool Convert(std::span<const RGB32> src, YCbCr_Image& dst)
+		{
+			const size_t width = dst.Width(), height = dst.Height();
+			if (src.size() < width * height)
+				return false;
+
+			const YCbCr_Coefficients k(dst.Matrix(), dst.Range());
+			const size_t cx = dst.Chroma_X(), cy = dst.Chroma_Y();
+
+			Parallel_For(dst.Chroma_Height(), 8, [&](size_t begin, size_t end) {
+				for (size_t row = begin; row < end; row++) {
+					const size_t r0 = row * cy, r1 = std::min(r0 + cy - 1, height - 1);
+					YCbCr_Encode_Row(k, src.data() + r0 * width, src.data() + r1 * width, width, cx,
+						dst.Y(r0), r1 != r0 ? dst.Y(r1) : nullptr, dst.Cb(row), dst.Cr(row), dst.Chroma_Step());
+				}
+			});
+			return true;
+		}
+
+		// YCbCr -> RGB32 (width * height, row-major), chroma replicated (nearest) over each block
+		inline bool Convert(const YCbCr_Image& src, std::span<RGB32> dst)
+		{
+			const size_t width = src.Width(), height = src.Height();
+			if (dst.size() < width * height)
+				return false;
+
+			const YCbCr_Coefficients k(src.Matrix(), src.Range());
+			const size_t cx = src.Chroma_X(), cy = src.Chroma_Y();
+
+			Parallel_For(height, 16, [&](size_t begin, size_t end) {
+				for (size_t row = begin; row < end; row++)
+					YCbCr_Decode_Row(k, src.Y(row), src.Cb(row / cy), src.Cr(row / cy), src.Chroma_Step(), cx, dst.data() + row * width, width);
+			});
+			return true;
+		}
+
+		// /-----------------------------------------------\
+		// | Dithering                                     |
+		// \-----------------------------------------------/
+
+		enum class Dither_Pattern
+		{
+			Bayer,		// 8x8 recursive Bayer matrix, cheap and regular
+			Blue_Noise	// 64x64 void-and-cluster ranks, no visible grid
+		};
+
+		// < Tiled threshold matrix, values in [0, 1) >
+		// Every row is stored with its first 8 entries repeated after the end, so a
+		// register of thresholds can be loaded at any x without wrapping.
+		class Dither_Matrix
+		{
+		private:
+			size_t size;
+			std::vector<float> data;
+
+		public:
+			// ranks holds a permutation of 0 .. size * size - 1, row-major
+			Dither_Matrix(size_t size, const std::vector<size_t>& ranks) : size(size), data(size * (size + 8))
+			{
+				const float scale = 1.0f / static_cast<float>(size * size);
+				for (size_t y = 0; y < size; y++)
+					for (size_t x = 0; x < size + 8; x++)
+						data[y * (size + 8) + x] = (static_cast<float>(ranks[y * size + x % size]) + 0.5f) * scale;
+			}
+
+			size_t Size() const { return size; }
+			const float* Row(size_t y) const { return data.data() + (y % size) * (size + 8); }
+			float At(size_t x, size_t y) const { return Row(y)[x % size]; }
+
+			static Dither_Matrix Bayer()
+			{
+				std::vector<size_t> ranks(64);
+				for (size_t y = 0; y < 8; y++)
+					for (size_t x = 0; x < 8; x++) {
+						// Interleave the bits of x ^ y and y, most significant level last
+						size_t v = 0, a = x ^ y, b = y;
+						for (size_t bit = 0; bit < 3; bit++)
+							v |= (((a >> bit) & 1) << (2 * (2 - bit) + 1)) | (((b >> bit) & 1) << (2 * (2 - bit)));
+						ranks[y * 8 + x] = v;
+					}
+				return Dither_Matrix(8, ranks);
+			}
+
+			// Ranks by repeatedly filling the largest void (lowest Gaussian energy, sigma 1.5, toroidal)
+			static Dither_Matrix Blue_Noise(size_t size = 64)
+			{
+				const size_t n = size * size;
+				std::vector<float> weight(n), energy(n);
+				for (size_t dy = 0; dy < size; dy++)
+					for (size_t dx = 0; dx < size; dx++) {
+						float x = static_cast<float>(std::min(dx, size - dx)), y = static_cast<float>(std::min(dy, size - dy));
+						weight[dy * size + dx] = expf(-(x * x + y * y) / (2.0f * 1.5f * 1.5f));
+					}
+
+				// Tiny deterministic jitter so ties do not fall into a regular grid
+				for (size_t i = 0; i < n; i++)
+					energy[i] = static_cast<float>((i * 2654435761u) % 1024) * 1e-7f;
+
+				std::vector<size_t> ranks(n);
+				std::vector<bool> set(n, false);
+				for (size_t rank = 0; rank < n; rank++) {
+					size_t best = 0;
+					float low = INFINITY;
+					for (size_t i = 0; i < n; i++)
+						if (!set[i] && energy[i] < low) { low = energy[i]; best = i; }
+
+					set[best] = true;
+					ranks[best] = rank;
+
+					const size_t bx = best % size, by = best / size;
+					for (size_t y = 0; y < size; y++) {
+						const float* w = weight.data() + ((y + size - by) % size) * size;
+						float* e = energy.data() + y * size;
+						for (size_t x = 0; x < size; x++)
+							e[x] += w[(x + size - bx) % size];
+					}
+				}
+				return Dither_Matrix(size, ranks);
+			}
+		};
+
+		// Shared matrices, built on first use
+		inline const Dither_Matrix& Dither_Thresholds(Dither_Pattern pattern)
+		{
+			static const Dither_Matrix bayer = Dither_Matrix::Bayer();
+			if (pattern == Dither_Pattern::Bayer)
+				return bayer;
+			static const Dither_Matrix blue = Dither_Matrix::Blue_Noise();
+			return blue;
+		}
+
+		// < Ordered dithering >
+
+		// RGB -> RGB32 with floor(c * 255 + threshold) per channel, alpha rounded. src is width pixels per row.
+		inline void Dither(std::span<const RGB> src, std::span<RGB32> dst, size_t width, Dither_Pattern pattern = Dither_Pattern::Bayer)
+		{
+			const size_t count = std::min(src.size(), dst.size());
+			if (width == 0)
+				return;
+
+			const Dither_Matrix& matrix = Dither_Thresholds(pattern);
+			const size_t size = matrix.Size();
+			const size_t width_simd = SIMD::Float::width;
+
+			Parallel_For((count + width - 1) / width, 16, [&](size_t begin, size_t end) {
+				for (size_t y = begin; y < end; y++) {
+					const RGB* s = src.data() + y * width;
+					RGB32* d = dst.data() + y * width;
+					const size_t n = std::min(width, count - y * width);
+					const float* t = matrix.Row(y);
+					size_t x = 0;
+
+					if (width_simd > 1 && width_simd <= 8) {
+						for (; x + width_simd <= n; x += width_simd) {
+							SIMD::RGB c = SIMD::Load(s + x);
+							SIMD::Float th = SIMD::Float::Load(t + x % size);
+							auto level = [&](SIMD::Float v) { return SIMD::Min(SIMD::Max(v, 0.0f) * 255.0f + th, 255.0f); };
+							SIMD::Store_Bytes(d + x, SIMD::RGB{ level(c.r), level(c.g), level(c.b), SIMD::Max(SIMD::Min(c.a, 1.0f), 0.0f) * 255.0f + 0.5f });
+						}
+					}
+
+					for (; x < n; x++) {
+						const float th = t[x % size];
+						auto level = [th](float v) { return static_cast<BYTE>(min(max(v, 0.0f) * 255.0f + th, 255.0f)); };
+						d[x] = RGB32(level(s[x].r), level(s[x].g), level(s[x].b), static_cast<BYTE>(std::clamp(s[x].a, 0.0f, 1.0f) * 255.0f + 0.5f));
+					}
+				}
+			});
+		}
+
+		// RGB -> palette indices; each channel is offset by (threshold - 0.5) * spread before the lookup
+		inline void Dither(std::span<const RGB> src, std::span<BYTE> dst, size_t width, const Palette& palette, Dither_Pattern pattern = Dither_Pattern::Bayer, float spread = 0.125f)
+		{
+			const size_t count = std::min(src.size(), dst.size());
+			if (width == 0 || palette.Size() == 0)
+				return;
+
+			const Dither_Matrix& matrix = Dither_Thresholds(pattern);
+
+			Parallel_For((count + width - 1) / width, 16, [&](size_t begin, size_t end) {
+				for (size_t y = begin; y < end; y++) {
+					const size_t n = std::min(width, count - y * width);
+					for (size_t x = 0; x < n; x++) {
+						const RGB& c = src[y * width + x];
+						const float offset = (matrix.At(x, y) - 0.5f) * spread;
+						dst[y * width + x] = palette.Index(RGB_TO_RGB32(RGB(c.r + offset, c.g + offset, c.b + offset, c.a)));
+					}
+				}
+			});
+		}
+
+		// < Floyd-Steinberg error diffusion >
+
+		// Runs quantize(x, y, value) -> quantized value over every pixel in Floyd-Steinberg order,
+		// pushing the error 7/16 right, 3/16 down-left, 5/16 down, 1/16 down-right.
+		// Rows are dealt round-robin to threads, each row trailing the one above by two pixels
+		// (a wavefront), which respects every dependency, so the result equals a serial pass.
+		template<typename Quantize>
+		void Error_Diffusion(std::span<const RGB> src, size_t width, size_t height, Quantize quantize)
+		{
+			if (width == 0 || height == 0)
+				return;
+
+			const size_t chunk = 64;
+			const size_t threads = std::max<size_t>(std::min<size_t>(std::thread::hardware_concurrency(), height), 1);
+			const size_t ring = 2 * threads + 2;
+
+			// Incoming error per row (r, g, b), reused every ring rows
+			std::vector<float> errors(ring * (width + 2) * 3, 0.0f);
+			std::vector<std::atomic<size_t>> progress(height);
+			for (std::atomic<size_t>& p : progress)
+				p.store(0, std::memory_order_relaxed);
+
+			auto row_errors = [&](size_t y) { return errors.data() + (y % ring) * (width + 2) * 3 + 3; };
+
+			auto worker = [&](size_t first) {
+				for (size_t y = first; y < height; y += threads) {
+					float* in = row_errors(y);
+					float* out = row_errors(y + 1);
+					const RGB* s = src.data() + y * width;
+
+					// Slot -1 and 0 of the next row are the only ones never assigned before an add
+					out[-3] = out[-2] = out[-1] = 0.0f;
+					out[0] = out[1] = out[2] = 0.0f;
+
+					float carry[3] = { 0.0f, 0.0f, 0.0f };
+					for (size_t x0 = 0; x0 < width; x0 += chunk) {
+						const size_t x1 = std::min(x0 + chunk, width);
+
+						// Pixel x reads the error row y - 1 leaves at x + 1
+						if (y > 0) {
+							const size_t need = std::min(x1 + 1, width);
+							while (progress[y - 1].load(std::memory_order_acquire) < need)
+								std::this_thread::yield();
+						}
+
+						for (size_t x = x0; x < x1; x++) {
+							float* e = in + 3 * x;
+							RGB value(s[x].r * 255.0f + e[0] + carry[0], s[x].g * 255.0f + e[1] + carry[1], s[x].b * 255.0f + e[2] + carry[2], s[x].a);
+							RGB q = quantize(x, y, value);
+							float err[3] = { value.r - q.r, value.g - q.g, value.b - q.b };
+
+							float* o = out + 3 * x;
+							for (size_t ch = 0; ch < 3; ch++) {
+								carry[ch] = err[ch] * (7.0f / 16.0f);
+								o[ch + 3] = err[ch] * (1.0f / 16.0f);
+								o[ch] += err[ch] * (5.0f / 16.0f);
+								o[ch - 3] += err[ch] * (3.0f / 16.0f);
+							}
+						}
+						progress[y].store(x1, std::memory_order_release);
+					}
+				}
+			};
+
+			std::vector<std::thread> workers;
+			for (size_t t = 1; t < threads; t++)
+				workers.emplace_back(worker, t);
+			worker(0);
+			for (std::thread& w : workers)
+				w.join();
+		}
+
+		// RGB -> RGB32 with errors diffused to the nearest byte, alpha rounded. src is width pixels per row.
+		inline void Error_Diffuse(std::span<const RGB> src, std::span<RGB32> dst, size_t width)
+		{
+			const size_t count = std::min(src.size(), dst.size());
+			if (width == 0)
+				return;
+
+			Error_Diffusion(src.first(count), width, count / width, [&](size_t x, size_t y, const RGB& v) {
+				auto level = [](float c) { return static_cast<BYTE>(std::clamp(c, 0.0f, 255.0f) + 0.5f); };
+				RGB32 q(level(v.r), level(v.g), level(v.b), static_cast<BYTE>(std::clamp(v.a, 0.0f, 1.0f) * 255.0f + 0.5f));
+				dst[y * width + x] = q;
+				return RGB(q.r, q.g, q.b, v.a);
+			});
+
+			// A partial last row is only rounded
+			auto round = [](float c) { return static_cast<BYTE>(std::clamp(c, 0.0f, 1.0f) * 255.0f + 0.5f); };
+			for (size_t i = count / width * width; i < count; i++)
+				dst[i] = RGB32(round(src[i].r), round(src[i].g), round(src[i].b), round(src[i].a));
+		}
+
+		// RGB -> palette indices with errors diffused against the chosen palette colors
+		inline void Error_Diffuse(std::span<const RGB> src, std::span<BYTE> dst, size_t width, const Palette& palette)
+		{
+			const size_t count = std::min(src.size(), dst.size());
+			if (width == 0 || palette.Size() == 0)
+				return;
+
+			Error_Diffusion(src.first(count), width, count / width, [&](size_t x, size_t y, const RGB& v) {
+				auto level = [](float c) { return static_cast<BYTE>(std::clamp(c, 0.0f, 255.0f) + 0.5f); };
+				BYTE index = palette.Index(RGB32(level(v.r), level(v.g), level(v.b)));
+				dst[y * width + x] = index;
+				const RGB32& q = palette.colors[index];
+				return RGB(q.r, q.g, q.b, v.a);
+			});
+
+			for (size_t i = count / width * width; i < count; i++)
+				dst[i] = palette.Index(RGB_TO_RGB32(src[i]));
+		}
+
+		// /-----------------------------------------------\
+		// | Convolution                                   |
+		// \-----------------------------------------------/
+
+		// < Odd length 1D filter, taps[Radius()] is the center >
+		class Kernel
+		{
+		public:
+			std::vector<float> taps;
+
+			Kernel() : taps{ 1.0f } {}
+			// Taps are used as given; an even count gets a zero tap appended so it has a center
+			explicit Kernel(std::vector<float> taps) : taps(std::move(taps))
+			{
+				if (this->taps.empty() || this->taps.size() % 2 == 0)
+					this->taps.push_back(0.0f);
+			}
+
+			size_t Radius() const { return taps.size() / 2; }
+
+			static Kernel Box(size_t radius)
+			{
+				return Kernel(std::vector<float>(2 * radius + 1, 1.0f / static_cast<float>(2 * radius + 1)));
+			}
+
+			// radius 0 picks ceil(3 * sigma), the taps are normalized to sum to 1
+			static Kernel Gaussian(float sigma, size_t radius = 0)
+			{
+				if (sigma <= 0.0f)
+					return Kernel();
+				if (radius == 0)
+					radius = static_cast<size_t>(ceilf(3.0f * sigma));
+
+				std::vector<float> taps(2 * radius + 1);
+				float sum = 0.0f;
+				for (size_t i = 0; i < taps.size(); i++) {
+					const float x = static_cast<float>(i) - static_cast<float>(radius);
+					sum += taps[i] = expf(-x * x / (2.0f * sigma * sigma));
+				}
+				for (float& t : taps)
+					t /= sum;
+				return Kernel(std::move(taps));
+			}
+
+			// Q12 taps padded to an even count, rounded so they still sum to the rounded total
+			// (the 8bit path needs the sum of |taps| below 8)
+			std::vector<short> Fixed() const
+			{
+				std::vector<short> q(taps.size() + 1, 0);
+				float total = 0.0f;
+				int sum = 0;
+				for (size_t i = 0; i < taps.size(); i++) {
+					total += taps[i];
+					sum += q[i] = static_cast<short>(lrintf(taps[i] * 4096.0f));
+				}
+				q[Radius()] += static_cast<short>(lrintf(total * 4096.0f) - sum);
+				return q;
+			}
+		};
+
+		// < Intermediate pixel of the 8bit path, every channel in Q6 (value * 64) >
+		// Leaves room for the over / undershoot of sharpening kernels down to -512 and up to 511.
+		struct Pixel_Q6
+		{
+			short r, g, b, a;
+		};
+
+		inline void Store_Channels(int r, int g, int b, int a, Pixel_Q6& p)
+		{
+			auto q = [](int x) { return static_cast<short>(std::clamp(x, -32768, 32767)); };
+			p = { q(r), q(g), q(b), q(a) };
+		}
+
+		inline void Store_Channels(int r, int g, int b, int a, RGB32& p)
+		{
+			auto q = [](int x) { return static_cast<BYTE>(std::clamp(x, 0, 255)); };
+			p = RGB32(q(r), q(g), q(b), q(a));
+		}
+
+#if defined(ZCPP_COLOR_SSE2)
+		namespace SIMD
+		{
+			// 2 pixels as { r, g, b, a } x 2 int16
+			inline __m128i Load_Pair(const RGB32* p) { return _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)), _mm_setzero_si128()); }
+			inline __m128i Load_Pair(const Pixel_Q6* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+
+			// 2 pixels from { r, g, b, a } x 2 int16, saturated to the destination
+			inline void Store_Pair(__m128i x, Pixel_Q6* p) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), x); }
+			inline void Store_Pair(__m128i x, RGB32* p) { _mm_storel_epi64(reinterpret_cast<__m128i*>(p), _mm_packus_epi16(x, x)); }
+
+			// 1 pixel as { r, g, b, a } int32
+			inline __m128i Load_Pixel(const RGB32* p)
+			{
+				int v;
+				memcpy(&v, p, 4);
+				const __m128i zero = _mm_setzero_si128();
+				return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(v), zero), zero);
+			}
+			inline __m128i Load_Pixel(const Pixel_Q6* p)
+			{
+				__m128i x = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+				return _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+			}
+
+			// 1 pixel from { r, g, b, a } int32
+			inline void Store_Pixel(__m128i x, Pixel_Q6* p) { _mm_storel_epi64(reinterpret_cast<__m128i*>(p), _mm_packs_epi32(x, x)); }
+			inline void Store_Pixel(__m128i x, RGB32* p) { int v = _mm_cvtsi128_si32(Pack_Bytes(x)); memcpy(static_cast<void*>(p), &v, 4); }
+		}
+#endif
+
+		// Copies count pixels into line with the edge pixels repeated left times before and right times after
+		template<typename Pixel>
+		void Pad_Line(const Pixel* src, size_t count, size_t left, size_t right, Pixel* line)
+		{
+			std::fill(line, line + left, src[0]);
+			std::copy(src, src + count, line + left);
+			std::fill(line + left + count, line + left + count + right, src[count - 1]);
+		}
+
+		// out[x] = (sum of taps[k] * line[x + k] + rounding) >> shift, taps from Kernel::Fixed.
+		// line holds count + taps.size() - 1 pixels.
+		template<typename In, typename Out>
+		void Filter_Row(const In* line, size_t count, const std::vector<short>& taps, int shift, Out* out)
+		{
+			const int bias = 1 << (shift - 1);
+			size_t x = 0;
+#if defined(ZCPP_COLOR_SSE2)
+			// Two outputs per register: interleaving pixel pairs with their right neighbours lines up
+			// taps k and k + 1 in every int32 lane for madd
+			const __m128i round = _mm_set1_epi32(bias);
+			for (; x + 2 <= count; x += 2) {
+				__m128i acc0 = round, acc1 = round;
+				for (size_t k = 0; k < taps.size(); k += 2) {
+					const __m128i w = _mm_set1_epi32(static_cast<unsigned short>(taps[k]) | (static_cast<int>(taps[k + 1]) << 16));
+					const __m128i a = SIMD::Load_Pair(line + x + k), b = SIMD::Load_Pair(line + x + k + 1);
+					acc0 = _mm_add_epi32(acc0, _mm_madd_epi16(_mm_unpacklo_epi16(a, b), w));
+					acc1 = _mm_add_epi32(acc1, _mm_madd_epi16(_mm_unpackhi_epi16(a, b), w));
+				}
+				SIMD::Store_Pair(_mm_packs_epi32(_mm_srai_epi32(acc0, shift), _mm_srai_epi32(acc1, shift)), out + x);
+			}
+#endif
+			for (; x < count; x++) {
+				int r = bias, g = bias, b = bias, a = bias;
+				for (size_t k = 0; k < taps.size(); k++) {
+					const In& p = line[x + k];
+					r += taps[k] * p.r; g += taps[k] * p.g; b += taps[k] * p.b; a += taps[k] * p.a;
+				}
+				Store_Channels(r >> shift, g >> shift, b >> shift, a >> shift, out[x]);
+			}
+		}
+
+		// out[x] = round(scale * sum of line[x .. x + size - 1]) from a running sum, the cost does not depend on size.
+		// line holds count + size - 1 pixels.
+		template<typename In, typename Out>
+		void Box_Row(const In* line, size_t count, size_t size, float scale, Out* out)
+		{
+#if defined(ZCPP_COLOR_SSE2)
+			__m128i sum = _mm_setzero_si128();
+			for (size_t k = 0; k < size; k++)
+				sum = _mm_add_epi32(sum, SIMD::Load_Pixel(line + k));
+
+			const __m128 s = _mm_set1_ps(scale);
+			for (size_t x = 0; x < count; x++) {
+				SIMD::Store_Pixel(_mm_cvtps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(sum), s)), out + x);
+				if (x + 1 < count)
+					sum = _mm_add_epi32(sum, _mm_sub_epi32(SIMD::Load_Pixel(line + x + size), SIMD::Load_Pixel(line + x)));
+			}
+#else
+			int r = 0, g = 0, b = 0, a = 0;
+			for (size_t k = 0; k < size; k++) {
+				r += line[k].r; g += line[k].g; b += line[k].b; a += line[k].a;
+			}
+
+			auto level = [scale](int c) { return static_cast<int>(nearbyintf(static_cast<float>(c) * scale)); };
+			for (size_t x = 0; x < count; x++) {
+				Store_Channels(level(r), level(g), level(b), level(a), out[x]);
+				if (x + 1 < count) {
+					const In& in = line[x + size];
+					const In& drop = line[x];
+					r += in.r - drop.r; g += in.g - drop.g; b += in.b - drop.b; a += in.a - drop.a;
+				}
+			}
+#endif
+		}
+
+		// Runs horizontal(line, count, out) over the rows of src into a transposed Q6 image, then
+		// vertical(line, count, out) over its rows (the columns of src) and transposes back into dst.
+		// Both passes read contiguous lines, and every transposed store writes 8 neighbouring pixels
+		// of one tile, so the column pass never strides across the image.
+		// count is the output length of the pass (dst_width, then dst_height); lines are padded by
+		// pad on the left and pad + 2 on the right, and horizontal may modify its line in place.
+		template<typename Horizontal, typename Vertical>
+		void Separable_Filter(const RGB32* src, size_t width, size_t height, RGB32* dst, size_t dst_width, size_t dst_height,
+			size_t pad_x, size_t pad_y, Horizontal horizontal, Vertical vertical)
+		{
+			const size_t tile = 8;
+			std::vector<Pixel_Q6> transposed(dst_width * height);
+
+			// Small images (thumbnails) stay on one thread
+			const size_t grain_x = std::max<size_t>(65536 / (tile * std::max(width, dst_width)), 1);
+			const size_t grain_y = std::max<size_t>(65536 / (tile * std::max(height, dst_height)), 1);
+
+			Parallel_For((height + tile - 1) / tile, grain_x, [&](size_t begin, size_t end) {
+				std::vector<RGB32> line(width + 2 * pad_x + 2);
+				std::vector<Pixel_Q6> rows(tile * dst_width);
+				for (size_t t = begin; t < end; t++) {
+					const size_t y0 = t * tile, n = std::min(tile, height - y0);
+					for (size_t j = 0; j < n; j++) {
+						Pad_Line(src + (y0 + j) * width, width, pad_x, pad_x + 2, line.data());
+						horizontal(line.data(), dst_width, rows.data() + j * dst_width);
+					}
+					for (size_t x = 0; x < dst_width; x++)
+						for (size_t j = 0; j < n; j++)
+							transposed[x * height + y0 + j] = rows[j * dst_width + x];
+				}
+			});
+
+			Parallel_For((dst_width + tile - 1) / tile, grain_y, [&](size_t begin, size_t end) {
+				std::vector<Pixel_Q6> line(height + 2 * pad_y + 2);
+				std::vector<RGB32> columns(tile * dst_height);
+				for (size_t t = begin; t < end; t++) {
+					const size_t x0 = t * tile, n = std::min(tile, dst_width - x0);
+					for (size_t j = 0; j < n; j++) {
+						Pad_Line(transposed.data() + (x0 + j) * height, height, pad_y, pad_y + 2, line.data());
+						vertical(line.data(), dst_height, columns.data() + j * dst_height);
+					}
+					for (size_t y = 0; y < dst_height; y++)
+						for (size_t j = 0; j < n; j++)
+							dst[y * dst_width + x0 + j] = columns[j * dst_height + y];
+				}
+			});
+		}
+
+		// < RGB32 images, width * height pixels row-major, edges clamped >
+		// The horizontal pass keeps 16bit Q6 intermediates. src and dst may be the same image.
+		// Returns false when either span is too small.
+
+		inline bool Convolve(std::span<const RGB32> src, std::span<RGB32> dst, size_t width, size_t height, const Kernel& horizontal, const Kernel& vertical)
+		{
+			if (width == 0 || height == 0 || src.size() < width * height || dst.size() < width * height)
+				return false;
+
+			const std::vector<short> tx = horizontal.Fixed(), ty = vertical.Fixed();
+			Separable_Filter(src.data(), width, height, dst.data(), width, height, horizontal.Radius(), vertical.Radius(),
+				[&](const RGB32* line, size_t count, Pixel_Q6* out) { Filter_Row(line, count, tx, 6, out); },
+				[&](const Pixel_Q6* line, size_t count, RGB32* out) { Filter_Row(line, count, ty, 18, out); });
+			return true;
+		}
+
+		inline bool Convolve(std::span<const RGB32> src, std::span<RGB32> dst, size_t width, size_t height, const Kernel& kernel)
+		{
+			return Convolve(src, dst, width, height, kernel, kernel);
+		}
+
+		// (2 * radius + 1)^2 box through running sums
+		inline bool Box_Blur(std::span<const RGB32> src, std::span<RGB32> dst, size_t width, size_t height, size_t radius)
+		{
+			if (width == 0 || height == 0 || src.size() < width * height || dst.size() < width * height)
+				return false;
+
+			const size_t size = 2 * radius + 1;
+			const float scale = 1.0f / static_cast<float>(size);
+			Separable_Filter(src.data(), width, height, dst.data(), width, height, radius, radius,
+				[&](const RGB32* line, size_t count, Pixel_Q6* out) { Box_Row(line, count, size, 64.0f * scale, out); },
+				[&](const Pixel_Q6* line, size_t count, RGB32* out) { Box_Row(line, count, size, scale / 64.0f, out); });
+			return true;
+		}
+
+		inline bool Gaussian_Blur(std::span<const RGB32> src, std::span<RGB32> dst, size_t width, size_t height, float sigma)
+		{
+			return Convolve(src, dst, width, height, Kernel::Gaussian(sigma));
+		}
+
+		// < Planar float images, every channel filtered, edges clamped >
+
+		// out[x] = sum of taps[k] * line[x + k], line holds count + taps.size() - 1 floats
+		inline void Filter_Row(const float* line, size_t count, const std::vector<float>& taps, float* out)
+		{
+			const size_t width_simd = SIMD::Float::width;
+			size_t x = 0;
+			if (width_simd > 1) {
+				for (; x + width_simd <= count; x += width_simd) {
+					SIMD::Float acc = 0.0f;
+					for (size_t k = 0; k < taps.size(); k++)
+						acc = acc + SIMD::Float(taps[k]) * SIMD::Float::Load(line + x + k);
+					acc.Store(out + x);
+				}
+			}
+			for (; x < count; x++) {
+				float acc = 0.0f;
+				for (size_t k = 0; k < taps.size(); k++)
+					acc = acc + taps[k] * line[x + k];
+				out[x] = acc;
+			}
+		}
+
+		// out[x] = sum of taps[k] * rows[k][x] over columns [begin, end)
+		inline void Filter_Column(const float* const* rows, size_t begin, size_t end, const std::vector<float>& taps, float* out)
+		{
+			const size_t width_simd = SIMD::Float::width;
+			size_t x = begin;
+			if (width_simd > 1) {
+				for (; x + width_simd <= end; x += width_simd) {
+					SIMD::Float acc = 0.0f;
+					for (size_t k = 0; k < taps.size(); k++)
+						acc = acc + SIMD::Float(taps[k]) * SIMD::Float::Load(rows[k] + x);
+					acc.Store(out + x);
+				}
+			}
+			for (; x < end; x++) {
+				float acc = 0.0f;
+				for (size_t k = 0; k < taps.size(); k++)
+					acc = acc + taps[k] * rows[k][x];
+				out[x] = acc;
+			}
+		}
+
+		// dst is resized to match src and may be the same image. The vertical pass walks
+		// strips of 512 columns top to bottom, so the rows under the kernel stay in cache.
+		template<typename ColorSpace>
+		void Convolve(const PlanarImage<ColorSpace>& src, PlanarImage<ColorSpace>& dst, const Kernel& horizontal, const Kernel& vertical)
+		{
+			const size_t width = src.Width(), height = src.Height();
+			if (dst.Width() != width || dst.Height() != height)
+				dst.Resize(width, height);
+			if (width == 0 || height == 0)
+				return;
+
+			const size_t rx = horizontal.Radius(), ry = vertical.Radius();
+			const size_t strip = 512;
+			std::vector<float> temp(width * height);
+
+			for (size_t ch = 0; ch < PlanarImage<ColorSpace>::channels; ch++) {
+				const float* s = src.Plane(ch);
+				float* d = dst.Plane(ch);
+
+				Parallel_For(height, 8, [&](size_t begin, size_t end) {
+					std::vector<float> line(width + 2 * rx);
+					for (size_t y = begin; y < end; y++) {
+						Pad_Line(s + y * width, width, rx, rx, line.data());
+						Filter_Row(line.data(), width, horizontal.taps, temp.data() + y * width);
+					}
+				});
+
+				Parallel_For(height, 8, [&](size_t begin, size_t end) {
+					std::vector<const float*> rows(vertical.taps.size());
+					for (size_t x0 = 0; x0 < width; x0 += strip) {
+						for (size_t y = begin; y < end; y++) {
+							for (size_t k = 0; k < rows.size(); k++)
+								rows[k] = temp.data() + std::min<size_t>(static_cast<size_t>(std::max<ptrdiff_t>(static_cast<ptrdiff_t>(y + k) - static_cast<ptrdiff_t>(ry), 0)), height - 1) * width;
+							Filter_Column(rows.data(), x0, std::min(x0 + strip, width), vertical.taps, d + y * width);
+						}
+					}
+				});
+			}
+		}
+
+		template<typename ColorSpace>
+		void Convolve(const PlanarImage<ColorSpace>& src, PlanarImage<ColorSpace>& dst, const Kernel& kernel)
+		{
+			Convolve(src, dst, kernel, kernel);
+		}
+
+		template<typename ColorSpace>
+		void Box_Blur(const PlanarImage<ColorSpace>& src, PlanarImage<ColorSpace>& dst, size_t radius)
+		{
+			Convolve(src, dst, Kernel::Box(radius));
+		}
+
+		template<typename ColorSpace>
+		void Gaussian_Blur(const PlanarImage<ColorSpace>& src, PlanarImage<ColorSpace>& dst, float sigma)
+		{
+			Convolve(src, dst, Kernel::Gaussian(sigma));
+		}
+
+		// /-----------------------------------------------\
+		// | Resampling                                    |
+		// \-----------------------------------------------/
+
+		enum class Resample_Filter
+		{
+			Bilinear,	// Triangle, support 1
+			Bicubic,	// Catmull-Rom, support 2
+			Lanczos		// Lanczos3, support 3
+		};
+
+		inline float Resample_Support(Resample_Filter filter)
+		{
+			switch (filter) {
+			case Resample_Filter::Bilinear: return 1.0f;
+			case Resample_Filter::Bicubic: return 2.0f;
+			default: return 3.0f;
+			}
+		}
+
+		inline float Resample_Weight(Resample_Filter filter, float t)
+		{
+			t = abs(t);
+			switch (filter) {
+			case Resample_Filter::Bilinear:
+				return t < 1.0f ? 1.0f - t : 0.0f;
+			case Resample_Filter::Bicubic:
+				if (t < 1.0f) return (1.5f * t - 2.5f) * t * t + 1.0f;
+				if (t < 2.0f) return ((-0.5f * t + 2.5f) * t - 4.0f) * t + 2.0f;
+				return 0.0f;
+			default: {
+				if (t < 1e-6f) return 1.0f;
+				if (t >= 3.0f) return 0.0f;
+				const float x = COLOR_PI * t;
+				return 3.0f * sinf(x) * sinf(x / 3.0f) / (x * x);
+			}
+			}
+		}
+
+		// < Filter weights of one axis for a (src, dst) size pair >
+		// Output i reads taps pixels of a line padded by pad on both sides, starting at start[i],
+		// with Q12 weights (summing to 4096) at weights[i * taps]. taps is even for pairwise madd.
+		// Downscaling widens the filter by src / dst, so every source pixel contributes.
+		class Resample_Axis
+		{
+		public:
+			Resample_Filter filter;
+			size_t src, dst;
+			size_t taps, pad;
+			std::vector<size_t> start;
+			std::vector<short> weights;
+
+			Resample_Axis(Resample_Filter filter, size_t src, size_t dst) : filter(filter), src(src), dst(dst), taps(0), pad(0), start(dst)
+			{
+				const double scale = static_cast<double>(src) / static_cast<double>(dst);
+				const double stretch = std::max(scale, 1.0);
+				const double support = Resample_Support(filter) * stretch;
+
+				std::vector<long long> left(dst);
+				for (size_t i = 0; i < dst; i++) {
+					const double center = (static_cast<double>(i) + 0.5) * scale - 0.5;
+					left[i] = static_cast<long long>(floor(center - support)) + 1;
+					const long long right = static_cast<long long>(floor(center + support));
+					taps = std::max<size_t>(taps, static_cast<size_t>(right - left[i] + 1));
+				}
+				taps = (taps + 1) & ~static_cast<size_t>(1);
+				pad = taps;
+
+				weights.assign(dst * taps, 0);
+				std::vector<float> w(taps);
+				for (size_t i = 0; i < dst; i++) {
+					const double center = (static_cast<double>(i) + 0.5) * scale - 0.5;
+					float sum = 0.0f;
+					for (size_t k = 0; k < taps; k++)
+						sum += w[k] = Resample_Weight(filter, static_cast<float>((static_cast<double>(left[i] + static_cast<long long>(k)) - center) / stretch));
+
+					short* q = weights.data() + i * taps;
+					int total = 0;
+					size_t peak = 0;
+					for (size_t k = 0; k < taps; k++) {
+						total += q[k] = static_cast<short>(lrintf(w[k] / sum * 4096.0f));
+						if (q[k] > q[peak])
+							peak = k;
+					}
+					q[peak] += static_cast<short>(4096 - total);
+					start[i] = static_cast<size_t>(left[i] + static_cast<long long>(pad));
+				}
+			}
+
+			// Shared tables, built once per (filter, src, dst) and kept for the 64 most recent pairs
+			static std::shared_ptr<const Resample_Axis> Get(Resample_Filter filter, size_t src, size_t dst)
+			{
+				static std::mutex lock;
+				static std::vector<std::shared_ptr<const Resample_Axis>> cache;
+
+				std::lock_guard<std::mutex> guard(lock);
+				for (size_t i = 0; i < cache.size(); i++) {
+					const std::shared_ptr<const Resample_Axis> axis = cache[i];
+					if (axis->filter == filter && axis->src == src && axis->dst == dst) {
+						cache.erase(cache.begin() + i);
+						cache.push_back(axis);
+						return axis;
+					}
+				}
+
+				if (cache.size() >= 64)
+					cache.erase(cache.begin());
+				cache.push_back(std::make_shared<const Resample_Axis>(filter, src, dst));
+				return cache.back();
+			}
+		};
+
+		// out[i] = (sum of the axis weights * line[start[i] + k] + rounding) >> shift
+		template<typename In, typename Out>
+		void Resample_Row(const In* line, const Resample_Axis& axis, int shift, Out* out)
+		{
+			const int bias = 1 << (shift - 1);
+			for (size_t i = 0; i < axis.dst; i++) {
+				const In* p = line + axis.start[i];
+				const short* w = axis.weights.data() + i * axis.taps;
+#if defined(ZCPP_COLOR_SSE2)
+				// Pixels k and k + 1 interleaved per channel line up with weights k and k + 1 for madd
+				__m128i acc = _mm_set1_epi32(bias);
+				for (size_t k = 0; k < axis.taps; k += 2) {
+					const __m128i pair = SIMD::Load_Pair(p + k);
+					const __m128i wk = _mm_set1_epi32(static_cast<unsigned short>(w[k]) | (static_cast<int>(w[k + 1]) << 16));
+					acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_unpacklo_epi16(pair, _mm_srli_si128(pair, 8)), wk));
+				}
+				SIMD::Store_Pixel(_mm_srai_epi32(acc, shift), out + i);
+#else
+				int r = bias, g = bias, b = bias, a = bias;
+				for (size_t k = 0; k < axis.taps; k++) {
+					r += w[k] * p[k].r; g += w[k] * p[k].g; b += w[k] * p[k].b; a += w[k] * p[k].a;
+				}
+				Store_Channels(r >> shift, g >> shift, b >> shift, a >> shift, out[i]);
+#endif
+			}
+		}
+
+		// Scales a width x height RGB32 image to dst_width x dst_height, edges clamped.
+		// With premultiply, color is filtered weighted by alpha (and divided back out at the end), so
+		// transparent pixels do not bleed their color into visible ones; pass false for images that
+		// are already premultiplied. Returns false when either span is too small.
+		inline bool Resample(std::span<const RGB32> src, size_t width, size_t height, std::span<RGB32> dst, size_t dst_width, size_t dst_height,
+			Resample_Filter filter = Resample_Filter::Bicubic, bool premultiply = true)
+		{
+			if (width == 0 || height == 0 || dst_width == 0 || dst_height == 0 || src.size() < width * height || dst.size() < dst_width * dst_height)
+				return false;
+
+			const std::shared_ptr<const Resample_Axis> ax = Resample_Axis::Get(filter, width, dst_width);
+			const std::shared_ptr<const Resample_Axis> ay = Resample_Axis::Get(filter, height, dst_height);
+
+			Separable_Filter(src.data(), width, height, dst.data(), dst_width, dst_height, ax->pad, ay->pad,
+				[&](RGB32* line, size_t, Pixel_Q6* out) {
+					if (premultiply)
+						Premultiply(std::span<RGB32>(line, width + 2 * ax->pad + 2));
+					Resample_Row(line, *ax, 6, out);
+				},
+				[&](const Pixel_Q6* line, size_t count, RGB32* out) {
+					Resample_Row(line, *ay, 18, out);
+					if (premultiply)
+						Unpremultiply(std::span<RGB32>(out, count));
+				});
+			return true;
+		}
+
+		// /-----------------------------------------------\
+		// | Packed Pixels                                 |
+		// \-----------------------------------------------/
+
+		// Byte order of 32bit pixels in memory
+		enum class Channel_Order
+		{
+			RGBA,	// RGB32's own layout
+			BGRA,	// Windows DIBs, Direct3D, most capture APIs
+			ARGB,
+			ABGR
+		};
+
+		// Byte offset of r, g, b and a within one pixel
+		inline std::array<int, 4> Channel_Offsets(Channel_Order order)
+		{
+			switch (order) {
+			case Channel_Order::BGRA: return { 2, 1, 0, 3 };
+			case Channel_Order::ARGB: return { 1, 2, 3, 0 };
+			case Channel_Order::ABGR: return { 3, 2, 1, 0 };
+			default: return { 0, 1, 2, 3 };
+			}
+		}
+
+		// map[j] = byte of the from pixel that lands in byte j of the to pixel
+		inline std::array<BYTE, 4> Swizzle_Map(Channel_Order from, Channel_Order to)
+		{
+			const std::array<int, 4> f = Channel_Offsets(from), t = Channel_Offsets(to);
+			std::array<BYTE, 4> map{};
+			for (size_t c = 0; c < 4; c++)
+				map[t[c]] = static_cast<BYTE>(f[c]);
+			return map;
+		}
+
+		// < RGB32 packed into one 32bit word, byte n of the pixel in bits 8n - 8n+7 >
+		// Matches the memory layout of RGB32 (and of a byte buffer in the given order) on little endian
+		// machines. Every channel operation works on the whole word at once (SWAR).
+		class Packed_RGB32
+		{
+		public:
+			uint32_t value;
+
+			Packed_RGB32() : value(0xFF000000u) {}
+			explicit Packed_RGB32(uint32_t value) : value(value) {}
+			Packed_RGB32(BYTE red, BYTE green, BYTE blue, BYTE alpha = 255)
+				: value(static_cast<uint32_t>(red) | (static_cast<uint32_t>(green) << 8) | (static_cast<uint32_t>(blue) << 16) | (static_cast<uint32_t>(alpha) << 24)) {}
+			Packed_RGB32(const RGB32& rgb32) : Packed_RGB32(rgb32.r, rgb32.g, rgb32.b, rgb32.a) {}
+
+			BYTE R() const { return static_cast<BYTE>(value); }
+			BYTE G() const { return static_cast<BYTE>(value >> 8); }
+			BYTE B() const { return static_cast<BYTE>(value >> 16); }
+			BYTE A() const { return static_cast<BYTE>(value >> 24); }
+
+			bool operator == (const Packed_RGB32& rhs) const { return value == rhs.value; }
+			bool operator != (const Packed_RGB32& rhs) const { return value != rhs.value; }
+
+			// Per channel a + b, clamped to 255
+			Packed_RGB32 operator + (const Packed_RGB32& rhs) const
+			{
+				const uint32_t a = value, b = rhs.value;
+				const uint32_t sum = ((a & 0x7F7F7F7Fu) + (b & 0x7F7F7F7Fu)) ^ ((a ^ b) & 0x80808080u);
+				const uint32_t carry = ((a & b) | ((a | b) & ~sum)) & 0x80808080u;
+				return Packed_RGB32(sum | ((carry << 1) - (carry >> 7)));
+			}
+
+			// Per channel a - b, clamped to 0
+			Packed_RGB32 operator - (const Packed_RGB32& rhs) const
+			{
+				const uint32_t a = value, b = rhs.value;
+				const uint32_t diff = ((a | 0x80808080u) - (b & 0x7F7F7F7Fu)) ^ ((a ^ ~b) & 0x80808080u);
+				const uint32_t borrow = ((~a & b) | (~(a ^ b) & diff)) & 0x80808080u;
+				return Packed_RGB32(diff & ~((borrow << 1) - (borrow >> 7)));
+			}
+
+			// Same byte order rearranged, e.g. Swizzle(Channel_Order::RGBA, Channel_Order::BGRA)
+			Packed_RGB32 Swizzle(Channel_Order from, Channel_Order to) const
+			{
+				const std::array<BYTE, 4> map = Swizzle_Map(from, to);
+				uint32_t v = 0;
+				for (size_t j = 0; j < 4; j++)
+					v |= ((value >> (8 * map[j])) & 0xFFu) << (8 * j);
+				return Packed_RGB32(v);
+			}
+		};
+
+		inline Packed_RGB32 To_Packed(const RGB32& rgb32) { return Packed_RGB32(rgb32); }
+		inline RGB32 To_RGB32(const Packed_RGB32& packed) { return RGB32(packed.R(), packed.G(), packed.B(), packed.A()); }
+
+		// Per channel (a + b + 1) / 2
+		inline Packed_RGB32 Average(Packed_RGB32 a, Packed_RGB32 b)
+		{
+			return Packed_RGB32((a.value | b.value) - (((a.value ^ b.value) & 0xFEFEFEFEu) >> 1));
+		}
+
+		// Per channel a + (b - a) * t / 256 rounded, t in 0 - 256 (256 returns b)
+		inline Packed_RGB32 Lerp(Packed_RGB32 a, Packed_RGB32 b, unsigned int t)
+		{
+			// Two channels per half, each with 8 spare bits for the product
+			const uint32_t s = 256 - t;
+			const uint32_t rb = ((a.value & 0x00FF00FFu) * s + (b.value & 0x00FF00FFu) * t + 0x00800080u) >> 8;
+			const uint32_t ga = (((a.value >> 8) & 0x00FF00FFu) * s + ((b.value >> 8) & 0x00FF00FFu) * t + 0x00800080u) >> 8;
+			return Packed_RGB32((rb & 0x00FF00FFu) | ((ga & 0x00FF00FFu) << 8));
+		}
+
+		// < Bulk byte order conversion >
+
+		// Rearranges pixels 4 bytes at a time, map from Swizzle_Map. src and dst may be the same buffer.
+		inline void Swizzle_Bytes(const BYTE* src, BYTE* dst, size_t pixels, const std::array<BYTE, 4>& map)
+		{
+			size_t i = 0;
+#if defined(ZCPP_COLOR_AVX2)
+			const __m256i mask = _mm256_setr_epi8(
+				map[0], map[1], map[2], map[3], map[0] + 4, map[1] + 4, map[2] + 4, map[3] + 4,
+				map[0] + 8, map[1] + 8, map[2] + 8, map[3] + 8, map[0] + 12, map[1] + 12, map[2] + 12, map[3] + 12,
+				map[0], map[1], map[2], map[3], map[0] + 4, map[1] + 4, map[2] + 4, map[3] + 4,
+				map[0] + 8, map[1] + 8, map[2] + 8, map[3] + 8, map[0] + 12, map[1] + 12, map[2] + 12, map[3] + 12);
+			for (; i + 8 <= pixels; i += 8)
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 4 * i), _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 4 * i)), mask));
+#elif defined(ZCPP_COLOR_SSSE3)
+			const __m128i mask = _mm_setr_epi8(
+				map[0], map[1], map[2], map[3], map[0] + 4, map[1] + 4, map[2] + 4, map[3] + 4,
+				map[0] + 8, map[1] + 8, map[2] + 8, map[3] + 8, map[0] + 12, map[1] + 12, map[2] + 12, map[3] + 12);
+			for (; i + 4 <= pixels; i += 4)
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4 * i), _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4 * i)), mask));
+#elif defined(ZCPP_COLOR_SSE2)
+			// No byte shuffle before SSSE3: move each byte with 32bit shifts
+			const __m128i low = _mm_set1_epi32(0xFF);
+			for (; i + 4 <= pixels; i += 4) {
+				const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4 * i));
+				__m128i out = _mm_setzero_si128();
+				for (int j = 0; j < 4; j++)
+					out = _mm_or_si128(out, _mm_sll_epi32(_mm_and_si128(_mm_srl_epi32(v, _mm_cvtsi32_si128(8 * map[j])), low), _mm_cvtsi32_si128(8 * j)));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4 * i), out);
+			}
+#endif
+			for (; i < pixels; i++) {
+				const BYTE p[4] = { src[4 * i], src[4 * i + 1], src[4 * i + 2], src[4 * i + 3] };
+				for (size_t j = 0; j < 4; j++)
+					dst[4 * i + j] = p[map[j]];
+			}
+		}
+
+		// Byte buffer in one order to another, min(src, dst) / 4 pixels
+		inline void Swizzle(std::span<const BYTE> src, std::span<BYTE> dst, Channel_Order from, Channel_Order to)
+		{
+			const size_t pixels = std::min(src.size(), dst.size()) / 4;
+			const std::array<BYTE, 4> map = Swizzle_Map(from, to);
+			Parallel_For(pixels, 65536, [&](size_t begin, size_t end) {
+				Swizzle_Bytes(src.data() + 4 * begin, dst.data() + 4 * begin, end - begin, map);
+			});
+		}
+
+		// Byte buffer in order -> RGB32
+		inline void Unpack(std::span<const BYTE> src, std::span<RGB32> dst, Channel_Order order)
+		{
+			Swizzle(src, std::span<BYTE>(reinterpret_cast<BYTE*>(dst.data()), dst.size() * 4), order, Channel_Order::RGBA);
+		}
+
+		// RGB32 -> byte buffer in order
+		inline void Pack(std::span<const RGB32> src, std::span<BYTE> dst, Channel_Order order)
+		{
+			Swizzle(std::span<const BYTE>(reinterpret_cast<const BYTE*>(src.data()), src.size() * 4), dst, Channel_Order::RGBA, order);
+		}
+
+		// /-----------------------------------------------\
+		// | Gradients & Colormaps                         |
+		// \-----------------------------------------------/
+
+		// Space the colors between two stops are blended in
+		enum class Gradient_Space
+		{
+			RGB,	// Straight sRGB channels
+			HSV,	// Hue takes the shorter way around the circle
+			OKLab	// Perceptually even steps
+		};
+
+		// < Baked lookup table, t in 0.0 - 1.0 maps to the nearest of size entries >
+		class Colormap
+		{
+		public:
+			std::vector<RGB32> table;
+
+			Colormap() : table(1) {}
+			explicit Colormap(std::vector<RGB32> table) : table(table.empty() ? std::vector<RGB32>(1) : std::move(table)) {}
+
+			size_t Size() const { return table.size(); }
+
+			RGB32 Map(float t) const
+			{
+				const float scale = static_cast<float>(table.size() - 1);
+				return table[static_cast<size_t>(max(min(t, 1.0f), 0.0f) * scale + 0.5f)];
+			}
+
+			// dst[i] = Map((src[i] - low) / (high - low)), one table read per pixel
+			void Map(std::span<const float> src, std::span<RGB32> dst, float low = 0.0f, float high = 1.0f) const
+			{
+				const size_t count = std::min(src.size(), dst.size());
+				const float range = high - low;
+				const float inverse = range != 0.0f ? 1.0f / range : 0.0f;
+				const float scale = static_cast<float>(table.size() - 1);
+				const RGB32* lut = table.data();
+
+				Parallel_For(count, 16384, [&](size_t begin, size_t end) {
+					const size_t width = SIMD::Float::width;
+					size_t i = begin;
+					if (width > 1) {
+						for (; i + width <= end; i += width) {
+							SIMD::Float t = (SIMD::Float::Load(src.data() + i) - low) * inverse;
+							SIMD::Float index = SIMD::Max(SIMD::Min(t, 1.0f), 0.0f) * scale + 0.5f;
+#if defined(ZCPP_COLOR_AVX2)
+							const __m256i pixels = _mm256_i32gather_epi32(reinterpret_cast<const int*>(lut), _mm256_cvttps_epi32(index.v), 4);
+							_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst.data() + i), pixels);
+#else
+							alignas(32) float slots[SIMD::Float::width];
+							index.Store(slots);
+							for (size_t k = 0; k < width; k++)
+								dst[i + k] = lut[static_cast<size_t>(slots[k])];
+#endif
+						}
+					}
+					for (; i < end; i++)
+						dst[i] = lut[static_cast<size_t>(max(min((src[i] - low) * inverse, 1.0f), 0.0f) * scale + 0.5f)];
+				});
+			}
+
+			// 8bit values index a 256 entry table directly, other sizes are rescaled once
+			void Map(std::span<const BYTE> src, std::span<RGB32> dst) const
+			{
+				const size_t count = std::min(src.size(), dst.size());
+				std::array<RGB32, 256> direct;
+				for (size_t v = 0; v < 256; v++)
+					direct[v] = table.size() == 256 ? table[v] : Map(static_cast<float>(v) * (1.0f / 255.0f));
+
+				Parallel_For(count, 65536, [&](size_t begin, size_t end) {
+					for (size_t i = begin; i < end; i++)
+						dst[i] = direct[src[i]];
+				});
+			}
+		};
+
+		// < Multi-stop gradient, positions in 0.0 - 1.0 >
+		class Gradient
+		{
+		public:
+			struct Stop
+			{
+				float position;
+				RGB color;
+			};
+
+		private:
+			std::vector<Stop> stops;
+			Gradient_Space space;
+			// Stops converted to the blend space once, as (x, y, z, alpha)
+			std::vector<std::array<float, 4>> points;
+
+			std::array<float, 4> To_Space(const RGB& c) const
+			{
+				switch (space) {
+				case Gradient_Space::HSV: { HSV v = RGB_TO_HSV(c); return { v.h, v.s, v.v, v.a }; }
+				case Gradient_Space::OKLab: { OKLab v = RGB_TO_OKLAB(c); return { v.l, v.a, v.b, v.alpha }; }
+				default: return { c.r, c.g, c.b, c.a };
+				}
+			}
+
+			RGB From_Space(const std::array<float, 4>& p) const
+			{
+				switch (space) {
+				case Gradient_Space::HSV: return HSV_TO_RGB(HSV(p[0] - floorf(p[0]), p[1], p[2], p[3]));
+				case Gradient_Space::OKLab: { RGB c = OKLAB_TO_RGB(OKLab(p[0], p[1], p[2], p[3])); return RGB(c.r, c.g, c.b, p[3]); }
+				default: return RGB(p[0], p[1], p[2], p[3]);
+				}
+			}
+
+		public:
+			Gradient(std::vector<Stop> stops, Gradient_Space space = Gradient_Space::OKLab) : stops(std::move(stops)), space(space)
+			{
+				if (this->stops.empty())
+					this->stops.push_back({ 0.0f, RGB() });
+				std::stable_sort(this->stops.begin(), this->stops.end(), [](const Stop& x, const Stop& y) { return x.position < y.position; });
+				for (const Stop& s : this->stops)
+					points.push_back(To_Space(s.color));
+			}
+
+			// Evenly spaced stops from first to last
+			Gradient(const std::vector<RGB32>& colors, Gradient_Space space = Gradient_Space::OKLab)
+				: Gradient([&] {
+					std::vector<Stop> s;
+					for (size_t i = 0; i < colors.size(); i++)
+						s.push_back({ colors.size() > 1 ? static_cast<float>(i) / static_cast<float>(colors.size() - 1) : 0.0f, RGB32_TO_RGB(colors[i]) });
+					return s;
+				}(), space) {}
+
+			const std::vector<Stop>& Stops() const { return stops; }
+			Gradient_Space Space() const { return space; }
+
+			// Color at t, clamped to the first and last stop
+			RGB Sample(float t) const
+			{
+				if (!(t > stops.front().position))
+					return stops.front().color;
+				if (t >= stops.back().position)
+					return stops.back().color;
+
+				size_t hi = 1;
+				while (stops[hi].position <= t)
+					hi++;
+				const size_t lo = hi - 1;
+				const float span = stops[hi].position - stops[lo].position;
+				const float f = span > 0.0f ? (t - stops[lo].position) / span : 1.0f;
+
+				std::array<float, 4> a = points[lo], b = points[hi];
+				if (space == Gradient_Space::HSV) {
+					// Shorter arc, and no hue drift into or out of a gray stop
+					if (b[0] - a[0] > 0.5f) a[0] += 1.0f;
+					else if (a[0] - b[0] > 0.5f) b[0] += 1.0f;
+					if (a[1] == 0.0f) a[0] = b[0];
+					if (b[1] == 0.0f) b[0] = a[0];
+				}
+
+				std::array<float, 4> p;
+				for (size_t i = 0; i < 4; i++)
+					p[i] = a[i] + (b[i] - a[i]) * f;
+				return From_Space(p);
+			}
+
+			// Table of size entries sampled at i / (size - 1), rounded to the nearest byte
+			Colormap Bake(size_t size = 256) const
+			{
+				size = std::max<size_t>(size, 2);
+				auto level = [](float c) { return static_cast<BYTE>(std::clamp(c, 0.0f, 1.0f) * 255.0f + 0.5f); };
+
+				std::vector<RGB32> table(size);
+				for (size_t i = 0; i < size; i++) {
+					RGB c = Sample(static_cast<float>(i) / static_cast<float>(size - 1));
+					table[i] = RGB32(level(c.r), level(c.g), level(c.b), level(c.a));
+				}
+				return Colormap(std::move(table));
+			}
+
+			// < Built-in maps (matplotlib, sampled at 10 points and blended in sRGB) >
+
+			static Gradient Viridis()
+			{
+				return Gradient(Hex({ 0x440154, 0x482878, 0x3E4A89, 0x31688E, 0x26828E, 0x1F9E89, 0x35B779, 0x6DCD59, 0xB4DE2C, 0xFDE725 }), Gradient_Space::RGB);
+			}
+			static Gradient Magma()
+			{
+				return Gradient(Hex({ 0x000004, 0x180F3E, 0x451077, 0x721F81, 0x9F2F7F, 0xCD4071, 0xF1605D, 0xFD9567, 0xFEC98D, 0xFCFDBF }), Gradient_Space::RGB);
+			}
+			static Gradient Inferno()
+			{
+				return Gradient(Hex({ 0x000004, 0x1B0C42, 0x4B0C6B, 0x781C6D, 0xA52C60, 0xCF4446, 0xED6925, 0xFB9A06, 0xF7D03C, 0xFCFFA4 }), Gradient_Space::RGB);
+			}
+			static Gradient Plasma()
+			{
+				return Gradient(Hex({ 0x0D0887, 0x47039F, 0x7301A8, 0x9C179E, 0xBD3786, 0xD8576B, 0xED7953, 0xFA9E3B, 0xFDC926, 0xF0F921 }), Gradient_Space::RGB);
+			}
+			// Full hue circle, the same colors as HUE_TO_RGB
+			static Gradient Rainbow()
+			{
+				return Gradient({ { 0.0f, RGB(1.0f, 0.0f, 0.0f) }, { 1.0f / 3.0f, RGB(0.0f, 1.0f, 0.0f) }, { 2.0f / 3.0f, RGB(0.0f, 0.0f, 1.0f) }, { 1.0f, RGB(1.0f, 0.0f, 0.0f) } }, Gradient_Space::HSV);
+			}
+
+		private:
+			static std::vector<RGB32> Hex(std::initializer_list<unsigned int> values)
+			{
+				std::vector<RGB32> colors;
+				for (unsigned int v : values)
+					colors.push_back(RGB32(static_cast<BYTE>(v >> 16), static_cast<BYTE>(v >> 8), static_cast<BYTE>(v)));
+				return colors;
+			}
+		};
+
+		// /-----------------------------------------------\
+		// | Image I/O                                     |
+		// \-----------------------------------------------/
+
+		enum class Image_Format
+		{
+			Unknown,
+			PGM,	// Netpbm P5, 8/16bit gray
+			PPM,	// Netpbm P6, 8/16bit RGB
+			PAM,	// Netpbm P7, 1 - 4 channels
+			QOI		// Quite OK Image, RGB or RGBA
+		};
+
+		// < Read-only view of a whole file >
+		// Memory-mapped where the platform allows it (pages load on first touch, so only the
+		// rows being decoded are resident), read into memory otherwise.
+		class Mapped_File
+		{
+		private:
+			const BYTE* data = nullptr;
+			size_t size = 0;
+			std::vector<BYTE> fallback;
+#if defined(_WIN32)
+			HANDLE file = INVALID_HANDLE_VALUE;
+			HANDLE mapping = nullptr;
+#endif
+
+		public:
+			Mapped_File() {}
+			explicit Mapped_File(const std::string& path) { Open(path); }
+			~Mapped_File() { Close(); }
+
+			Mapped_File(const Mapped_File&) = delete;
+			Mapped_File& operator = (const Mapped_File&) = delete;
+
+			bool Open(const std::string& path)
+			{
+				Close();
+#if defined(_WIN32)
+				file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+				LARGE_INTEGER length;
+				if (file != INVALID_HANDLE_VALUE && GetFileSizeEx(file, &length) && length.QuadPart > 0) {
+					mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+					if (mapping) {
+						data = static_cast<const BYTE*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+						size = data ? static_cast<size_t>(length.QuadPart) : 0;
+					}
+				}
+				if (data)
+					return true;
+				Close();
+#elif defined(ZCPP_COLOR_MMAP)
+				int fd = ::open(path.c_str(), O_RDONLY);
+				if (fd >= 0) {
+					struct stat info;
+					if (fstat(fd, &info) == 0 && info.st_size > 0) {
+						void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+						if (view != MAP_FAILED) {
+							madvise(view, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+							data = static_cast<const BYTE*>(view);
+							size = static_cast<size_t>(info.st_size);
+						}
+					}
+					::close(fd);
+				}
+				if (data)
+					return true;
+#endif
+				std::ifstream in(path, std::ios::binary);
+				if (!in)
+					return false;
+				fallback.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+				data = fallback.data();
+				size = fallback.size();
+				return size > 0;
+			}
+
+			void Close()
+			{
+#if defined(_WIN32)
+				if (data && fallback.empty())
+					UnmapViewOfFile(data);
+				if (mapping)
+					CloseHandle(mapping);
+				if (file != INVALID_HANDLE_VALUE)
+					CloseHandle(file);
+				mapping = nullptr;
+				file = INVALID_HANDLE_VALUE;
+#elif defined(ZCPP_COLOR_MMAP)
+				if (data && fallback.empty())
+					munmap(const_cast<BYTE*>(data), size);
+#endif
+				fallback.clear();
+				data = nullptr;
+				size = 0;
+			}
+
+			std::span<const BYTE> Data() const { return std::span<const BYTE>(data, size); }
+		};
+
+		// < Row kernels >
+
+		// 8bit RGB triples -> RGB32, alpha 255
+		inline void Expand_RGB24(const BYTE* src, RGB32* dst, size_t count)
+		{
+			size_t i = 0;
+#if defined(ZCPP_COLOR_SSSE3)
+			const __m128i mask = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+			const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+			// 16 byte loads, so stop while a full register is still inside the row
+			for (; i + 6 <= count; i += 4) {
+				const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 3 * i));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_or_si128(_mm_shuffle_epi8(v, mask), alpha));
+			}
+#endif
+			for (; i < count; i++)
+				dst[i] = RGB32(src[3 * i], src[3 * i + 1], src[3 * i + 2]);
+		}
+
+		// RGB32 -> 8bit RGB triples, alpha dropped
+		inline void Pack_RGB24(const RGB32* src, BYTE* dst, size_t count)
+		{
+			size_t i = 0;
+#if defined(ZCPP_COLOR_SSSE3)
+			const __m128i mask = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+			for (; i + 4 <= count; i += 4) {
+				const __m128i v = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), mask);
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(dst + 3 * i), v);
+				const int tail = _mm_cvtsi128_si32(_mm_srli_si128(v, 8));
+				memcpy(dst + 3 * i + 8, &tail, 4);
+			}
+#endif
+			for (; i < count; i++) {
+				dst[3 * i] = src[i].r;
+				dst[3 * i + 1] = src[i].g;
+				dst[3 * i + 2] = src[i].b;
+			}
+		}
+
+		inline size_t QOI_Hash(const RGB32& c) { return (c.r * 3 + c.g * 5 + c.b * 7 + c.a * 11) & 63; }
+
+		// < Streaming decoder >
+		// Decodes rows straight into caller memory. Netpbm rows are read in place from the mapped
+		// file (in parallel when several are asked for); QOI is decoded sequentially and keeps its
+		// state between calls, so any image can be processed a band of rows at a time.
+		class Image_Reader
+		{
+		private:
+			Mapped_File file;
+			std::span<const BYTE> data;
+			Image_Format format = Image_Format::Unknown;
+			size_t width = 0, height = 0, channels = 0;
+			size_t row = 0;
+			bool good = false;
+
+			// Netpbm
+			size_t offset = 0;
+			unsigned int maxval = 255;
+			size_t sample_bytes = 1;
+
+			// QOI
+			size_t position = 0;
+			std::array<RGB32, 64> index{};
+			RGB32 previous;
+			size_t run = 0;
+
+			static bool Space(BYTE c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f'; }
+
+			// Next whitespace separated token, skipping # comments
+			bool Token(size_t& p, std::string& out) const
+			{
+				out.clear();
+				while (p < data.size()) {
+					if (data[p] == '#')
+						while (p < data.size() && data[p] != '\n') p++;
+					else if (Space(data[p]))
+						p++;
+					else
+						break;
+				}
+				while (p < data.size() && !Space(data[p]) && data[p] != '#')
+					out += static_cast<char>(data[p++]);
+				return !out.empty();
+			}
+
+			bool Number(size_t& p, size_t& value) const
+			{
+				std::string t;
+				if (!Token(p, t) || t.find_first_not_of("0123456789") != std::string::npos || t.size() > 9)
+					return false;
+				value = std::stoul(t);
+				return true;
+			}
+
+			bool Parse_Netpbm()
+			{
+				size_t p = 2, max = 0;
+				if (format == Image_Format::PAM) {
+					std::string key;
+					size_t depth = 0;
+					while (Token(p, key) && key != "ENDHDR") {
+						if (key == "WIDTH") { if (!Number(p, width)) return false; }
+						else if (key == "HEIGHT") { if (!Number(p, height)) return false; }
+						else if (key == "DEPTH") { if (!Number(p, depth)) return false; }
+						else if (key == "MAXVAL") { if (!Number(p, max)) return false; }
+						else
+							while (p < data.size() && data[p] != '\n') p++;
+					}
+					if (key != "ENDHDR" || depth < 1 || depth > 4)
+						return false;
+					channels = depth;
+				}
+				else {
+					if (!Number(p, width) || !Number(p, height) || !Number(p, max))
+						return false;
+					channels = format == Image_Format::PGM ? 1 : 3;
+				}
+
+				// Exactly one whitespace byte separates the header from the samples
+				offset = p + 1;
+				maxval = static_cast<unsigned int>(max);
+				sample_bytes = max > 255 ? 2 : 1;
+				return max >= 1 && max <= 65535 && offset <= data.size();
+			}
+
+			bool Parse_QOI()
+			{
+				if (data.size() < 14)
+					return false;
+				auto be32 = [&](size_t p) { return (size_t(data[p]) << 24) | (size_t(data[p + 1]) << 16) | (size_t(data[p + 2]) << 8) | size_t(data[p + 3]); };
+				width = be32(4);
+				height = be32(8);
+				channels = data[12];
+				position = 14;
+				index.fill(RGB32(0, 0, 0, 0));
+				previous = RGB32(0, 0, 0, 255);
+				run = 0;
+				return channels == 3 || channels == 4;
+			}
+
+			void Decode_Netpbm_Row(const BYTE* src, RGB32* dst) const
+			{
+				if (sample_bytes == 1 && maxval == 255) {
+					switch (channels) {
+					case 1: for (size_t x = 0; x < width; x++) dst[x] = RGB32(src[x], src[x], src[x]); return;
+					case 2: for (size_t x = 0; x < width; x++) dst[x] = RGB32(src[2 * x], src[2 * x], src[2 * x], src[2 * x + 1]); return;
+					case 3: Expand_RGB24(src, dst, width); return;
+					default: memcpy(static_cast<void*>(dst), src, width * 4); return;
+					}
+				}
+
+				// Rescale to 0 - 255, 16bit samples are big endian
+				auto sample = [&](size_t i) {
+					unsigned int v = sample_bytes == 2 ? (unsigned int)(src[2 * i] << 8 | src[2 * i + 1]) : src[i];
+					return static_cast<BYTE>((std::min(v, maxval) * 255u + maxval / 2) / maxval);
+				};
+				for (size_t x = 0; x < width; x++) {
+					const size_t s = x * channels;
+					switch (channels) {
+					case 1: { BYTE v = sample(s); dst[x] = RGB32(v, v, v); break; }
+					case 2: { BYTE v = sample(s); dst[x] = RGB32(v, v, v, sample(s + 1)); break; }
+					case 3: dst[x] = RGB32(sample(s), sample(s + 1), sample(s + 2)); break;
+					default: dst[x] = RGB32(sample(s), sample(s + 1), sample(s + 2), sample(s + 3)); break;
+					}
+				}
+			}
+
+			// False when the data ends early
+			bool Decode_QOI(RGB32* dst, size_t count)
+			{
+				const BYTE* bytes = data.data();
+				const size_t end = data.size();
+				RGB32 px = previous;
+
+				for (size_t i = 0; i < count; i++) {
+					if (run > 0) {
+						run--;
+						dst[i] = px;
+						continue;
+					}
+					if (position >= end)
+						return false;
+
+					const BYTE b1 = bytes[position++];
+					if (b1 == 0xFE) {
+						if (position + 3 > end) return false;
+						px.r = bytes[position]; px.g = bytes[position + 1]; px.b = bytes[position + 2];
+						position += 3;
+					}
+					else if (b1 == 0xFF) {
+						if (position + 4 > end) return false;
+						px = RGB32(bytes[position], bytes[position + 1], bytes[position + 2], bytes[position + 3]);
+						position += 4;
+					}
+					else if ((b1 & 0xC0) == 0x00)
+						px = index[b1];
+					else if ((b1 & 0xC0) == 0x40) {
+						px.r = static_cast<BYTE>(px.r + ((b1 >> 4) & 3) - 2);
+						px.g = static_cast<BYTE>(px.g + ((b1 >> 2) & 3) - 2);
+						px.b = static_cast<BYTE>(px.b + (b1 & 3) - 2);
+					}
+					else if ((b1 & 0xC0) == 0x80) {
+						if (position >= end) return false;
+						const BYTE b2 = bytes[position++];
+						const int dg = (b1 & 0x3F) - 32;
+						px.r = static_cast<BYTE>(px.r + dg - 8 + ((b2 >> 4) & 0x0F));
+						px.g = static_cast<BYTE>(px.g + dg);
+						px.b = static_cast<BYTE>(px.b + dg - 8 + (b2 & 0x0F));
+					}
+					else
+						run = b1 & 0x3F;
+
+					index[QOI_Hash(px)] = px;
+					dst[i] = px;
+				}
+				previous = px;
+				return true;
+			}
+
+		public:
+			Image_Reader() {}
+			explicit Image_Reader(const std::string& path) { Open(path); }
+
+			// Maps and parses the file header
+			bool Open(const std::string& path)
+			{
+				if (!file.Open(path))
+					return good = false;
+				return Open(file.Data());
+			}
+
+			// Parses an image already in memory; data must outlive the reader
+			bool Open(std::span<const BYTE> bytes)
+			{
+				data = bytes;
+				row = 0;
+				format = Image_Format::Unknown;
+				good = false;
+
+				if (data.size() >= 4 && memcmp(data.data(), "qoif", 4) == 0) {
+					format = Image_Format::QOI;
+					good = Parse_QOI();
+				}
+				else if (data.size() >= 3 && data[0] == 'P') {
+					if (data[1] == '5') format = Image_Format::PGM;
+					else if (data[1] == '6') format = Image_Format::PPM;
+					else if (data[1] == '7') format = Image_Format::PAM;
+					good = format != Image_Format::Unknown && Parse_Netpbm();
+				}
+
+				good = good && width > 0 && height > 0;
+				return good;
+			}
+
+			bool Good() const { return good; }
+			Image_Format Format() const { return format; }
+			size_t Width() const { return width; }
+			size_t Height() const { return height; }
+			// Channels stored in the file (alpha is 255 when there are 1 or 3)
+			size_t Channels() const { return channels; }
+			// Next row Read_Rows will decode
+			size_t Row() const { return row; }
+
+			// Decodes as many whole rows as fit in dst, returns how many
+			size_t Read_Rows(std::span<RGB32> dst)
+			{
+				if (!good)
+					return 0;
+				size_t rows = std::min(dst.size() / width, height - row);
+
+				if (format == Image_Format::QOI) {
+					for (size_t r = 0; r < rows; r++)
+						if (!Decode_QOI(dst.data() + r * width, width)) {
+							good = false;
+							rows = r;
+							break;
+						}
+				}
+				else {
+					const size_t stride = width * channels * sample_bytes;
+					const size_t available = (data.size() - offset) / stride;
+					if (row + rows > available) {
+						rows = available > row ? available - row : 0;
+						good = false;
+					}
+					const BYTE* base = data.data() + offset + row * stride;
+					Parallel_For(rows, std::max<size_t>(65536 / width, 1), [&](size_t begin, size_t end) {
+						for (size_t r = begin; r < end; r++)
+							Decode_Netpbm_Row(base + r * stride, dst.data() + r * width);
+					});
+				}
+
+				row += rows;
+				return rows;
+			}
+
+			// All remaining rows; false when dst is too small or the data is cut short
+			bool Read(std::span<RGB32> dst)
+			{
+				const size_t rows = height - row;
+				if (!good || dst.size() < rows * width)
+					return false;
+				return Read_Rows(dst) == rows;
+			}
+		};
+
+		// < Streaming encoder >
+		// Rows are encoded as they arrive, so an image never has to be in memory at once.
+		// PPM drops alpha, PGM stores RGB32_TO_GRAYSCALE, PAM and QOI keep all four channels.
+		class Image_Writer
+		{
+		private:
+			std::ofstream file;
+			std::ostream* out = nullptr;
+			Image_Format format = Image_Format::Unknown;
+			size_t width = 0, height = 0;
+			size_t row = 0;
+			std::vector<BYTE> buffer;
+
+			// QOI
+			std::array<RGB32, 64> index{};
+			RGB32 previous;
+			size_t run = 0;
+
+			void Header()
+			{
+				std::ostringstream h;
+				switch (format) {
+				case Image_Format::PGM: h << "P5\n" << width << " " << height << "\n255\n"; break;
+				case Image_Format::PPM: h << "P6\n" << width << " " << height << "\n255\n"; break;
+				case Image_Format::PAM: h << "P7\nWIDTH " << width << "\nHEIGHT " << height << "\nDEPTH 4\nMAXVAL 255\nTUPLTYPE RGB_ALPHA\nENDHDR\n"; break;
+				default: {
+					const BYTE q[14] = { 'q', 'o', 'i', 'f',
+						BYTE(width >> 24), BYTE(width >> 16), BYTE(width >> 8), BYTE(width),
+						BYTE(height >> 24), BYTE(height >> 16), BYTE(height >> 8), BYTE(height), 4, 0 };
+					h.write(reinterpret_cast<const char*>(q), 14);
+					index.fill(RGB32(0, 0, 0, 0));
+					previous = RGB32(0, 0, 0, 255);
+					run = 0;
+				}
+				}
+				const std::string s = h.str();
+				out->write(s.data(), static_cast<std::streamsize>(s.size()));
+			}
+
+			void Encode_QOI(const RGB32* src, size_t count)
+			{
+				for (size_t i = 0; i < count; i++) {
+					RGB32 px = src[i];
+					if (px == previous) {
+						if (++run == 62) {
+							buffer.push_back(static_cast<BYTE>(0xC0 | (run - 1)));
+							run = 0;
+						}
+						continue;
+					}
+					if (run > 0) {
+						buffer.push_back(static_cast<BYTE>(0xC0 | (run - 1)));
+						run = 0;
+					}
+
+					const size_t h = QOI_Hash(px);
+					if (index[h] == px)
+						buffer.push_back(static_cast<BYTE>(h));
+					else {
+						index[h] = px;
+						if (px.a == previous.a) {
+							const signed char vr = static_cast<signed char>(px.r - previous.r);
+							const signed char vg = static_cast<signed char>(px.g - previous.g);
+							const signed char vb = static_cast<signed char>(px.b - previous.b);
+							const signed char vg_r = static_cast<signed char>(vr - vg), vg_b = static_cast<signed char>(vb - vg);
+
+							if (vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2)
+								buffer.push_back(static_cast<BYTE>(0x40 | (vr + 2) << 4 | (vg + 2) << 2 | (vb + 2)));
+							else if (vg_r > -9 && vg_r < 8 && vg > -33 && vg < 32 && vg_b > -9 && vg_b < 8) {
+								buffer.push_back(static_cast<BYTE>(0x80 | (vg + 32)));
+								buffer.push_back(static_cast<BYTE>((vg_r + 8) << 4 | (vg_b + 8)));
+							}
+							else
+								buffer.insert(buffer.end(), { BYTE(0xFE), px.r, px.g, px.b });
+						}
+						else
+							buffer.insert(buffer.end(), { BYTE(0xFF), px.r, px.g, px.b, px.a });
+					}
+					previous = px;
+				}
+			}
+
+		public:
+			Image_Writer() {}
+			~Image_Writer() { Close(); }
+
+			bool Open(const std::string& path, Image_Format format, size_t width, size_t height)
+			{
+				Close();
+				file.open(path, std::ios::binary | std::ios::trunc);
+				return file && Open(file, format, width, height);
+			}
+
+			// Writes to a caller stream, which must stay open until Close
+			bool Open(std::ostream& stream, Image_Format format, size_t width, size_t height)
+			{
+				if (format == Image_Format::Unknown || width == 0 || height == 0 || (format == Image_Format::QOI && (width > 0xFFFFFFFFu || height > 0xFFFFFFFFu)))
+					return false;
+				out = &stream;
+				this->format = format;
+				this->width = width;
+				this->height = height;
+				row = 0;
+				Header();
+				return static_cast<bool>(*out);
+			}
+
+			// Appends whole rows (rows.size() / width of them)
+			bool Write_Rows(std::span<const RGB32> rows)
+			{
+				if (!out)
+					return false;
+				const size_t count = std::min(rows.size() / width, height - row);
+
+				buffer.clear();
+				switch (format) {
+				case Image_Format::PGM:
+					buffer.resize(count * width);
+					for (size_t i = 0; i < buffer.size(); i++)
+						buffer[i] = RGB32_TO_GRAYSCALE(rows[i]).r;
+					break;
+				case Image_Format::PPM:
+					buffer.resize(count * width * 3);
+					Pack_RGB24(rows.data(), buffer.data(), count * width);
+					break;
+				case Image_Format::PAM:
+					buffer.resize(count * width * 4);
+					memcpy(buffer.data(), rows.data(), buffer.size());
+					break;
+				default:
+					Encode_QOI(rows.data(), count * width);
+				}
+
+				row += count;
+				out->write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+				return static_cast<bool>(*out) && count * width == rows.size();
+			}
+
+			// Finishes the stream; false if fewer than height rows were written or writing failed
+			bool Close()
+			{
+				if (!out)
+					return false;
+				if (format == Image_Format::QOI) {
+					buffer.clear();
+					if (run > 0)
+						buffer.push_back(static_cast<BYTE>(0xC0 | (run - 1)));
+					buffer.insert(buffer.end(), { 0, 0, 0, 0, 0, 0, 0, 1 });
+					out->write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+				}
+				out->flush();
+				const bool ok = static_cast<bool>(*out) && row == height;
+				if (file.is_open())
+					file.close();
+				out = nullptr;
+				return ok;
+			}
+		};
+
+		// < Whole images >
+
+		inline bool Write_Image(const std::string& path, Image_Format format, std::span<const RGB32> pixels, size_t width, size_t height)
+		{
+			if (pixels.size() < width * height)
+				return false;
+			Image_Writer writer;
+			return writer.Open(path, format, width, height) && writer.Write_Rows(pixels.first(width * height)) && writer.Close();
+		}
+
+		// Decodes into pixels, which must hold Width() * Height() of the file (see Image_Reader)
+		inline bool Read_Image(const std::string& path, std::span<RGB32> pixels)
+		{
+			Image_Reader reader(path);
+			return reader.Read(pixels);
+		}
+
+		// /-----------------------------------------------\
+		// | HDR Formats                                   |
+		// \-----------------------------------------------/
+
+		// < IEEE 754 binary16 bit pattern >
+		typedef uint16_t HALF;
+
+		// Round to nearest even, like F16C. Overflow goes to infinity, NaN stays NaN.
+		inline HALF FLOAT_TO_HALF(float value)
+		{
+			uint32_t x;
+			memcpy(&x, &value, sizeof(x));
+			const uint32_t sign = (x >> 16) & 0x8000u;
+			x &= 0x7FFFFFFFu;
+
+			if (x >= 0x7F800000u)
+				return static_cast<HALF>(sign | 0x7C00u | (x > 0x7F800000u ? 0x200u | ((x >> 13) & 0x3FFu) : 0u));
+			if (x >= 0x47800000u)
+				return static_cast<HALF>(sign | 0x7C00u);
+			if (x < 0x38800000u) {
+				// Below the smallest normal half: denormal, or zero under 2^-25
+				if (x < 0x33000000u)
+					return static_cast<HALF>(sign);
+				const uint32_t mantissa = (x & 0x7FFFFFu) | 0x800000u;
+				const uint32_t shift = 126u - (x >> 23);
+				const uint32_t rest = mantissa & ((1u << shift) - 1u), tie = 1u << (shift - 1u);
+				uint32_t h = mantissa >> shift;
+				if (rest > tie || (rest == tie && (h & 1u)))
+					h++;
+				return static_cast<HALF>(sign | h);
+			}
+
+			// Rebias the exponent; a carry out of the mantissa rolls into the exponent (and up to infinity)
+			uint32_t h = (x - 0x38000000u) >> 13;
+			const uint32_t rest = x & 0x1FFFu;
+			if (rest > 0x1000u || (rest == 0x1000u && (h & 1u)))
+				h++;
+			return static_cast<HALF>(sign | h);
+		}
+
+		inline float HALF_TO_FLOAT(HALF half)
+		{
+			const uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+			uint32_t exponent = (half >> 10) & 0x1Fu, mantissa = half & 0x3FFu, x;
+
+			if (exponent == 0x1Fu)
+				x = sign | 0x7F800000u | (mantissa ? 0x400000u | (mantissa << 13) : 0u);
+			else if (exponent != 0)
+				x = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+			else if (mantissa == 0)
+				x = sign;
+			else {
+				// Denormal, normalize into a float exponent
+				exponent = 113u;
+				while (!(mantissa & 0x400u)) {
+					mantissa <<= 1;
+					exponent--;
+				}
+				x = sign | (exponent << 23) | ((mantissa & 0x3FFu) << 13);
+			}
+
+			float value;
+			memcpy(&value, &x, sizeof(value));
+			return value;
+		}
+
+		// < 16bit unsigned normalized, 8 bytes per pixel >
+		class RGBA16
+		{
+		public:
+			// < Red >
+			// 0 - 65535
+			uint16_t r;
+			// < Green >
+			// 0 - 65535
+			uint16_t g;
+			// < Blue >
+			// 0 - 65535
+			uint16_t b;
+			// < Alpha >
+			// 0 - 65535
+			uint16_t a;
+
+			RGBA16(uint16_t red, uint16_t green, uint16_t blue, uint16_t alpha) : r(red), g(green), b(blue), a(alpha) {}
+			RGBA16(uint16_t red, uint16_t green, uint16_t blue) : r(red), g(green), b(blue), a(65535) {}
+			RGBA16() : r(0), g(0), b(0), a(65535) {}
+
+			bool operator == (const RGBA16& rhs) const { return this->r == rhs.r && this->g == rhs.g && this->b == rhs.b && this->a == rhs.a; }
+			bool operator != (const RGBA16& rhs) const { return !(*this == rhs); }
+
+			friend std::ostream& operator << (std::ostream& os, const RGBA16& rgba16)
+			{
+				os << "R: " << rgba16.r << " G: " << rgba16.g << " B: " << rgba16.b << " A: " << rgba16.a;
+				return os;
+			}
+		};
+
+		// < Half float, 8 bytes per pixel >
+		// Same range rules as RGB, values above 1.0 (up to 65504) are kept for HDR
+		class RGBA_Half
+		{
+		public:
+			HALF r;
+			HALF g;
+			HALF b;
+			HALF a;
+
+			RGBA_Half(HALF red, HALF green, HALF blue, HALF alpha) : r(red), g(green), b(blue), a(alpha) {}
+			RGBA_Half() : r(0), g(0), b(0), a(0x3C00) {}
+
+			bool operator == (const RGBA_Half& rhs) const { return this->r == rhs.r && this->g == rhs.g && this->b == rhs.b && this->a == rhs.a; }
+			bool operator != (const RGBA_Half& rhs) const { return !(*this == rhs); }
+
+			friend std::ostream& operator << (std::ostream& os, const RGBA_Half& half)
+			{
+				os << "R: " << HALF_TO_FLOAT(half.r) << " G: " << HALF_TO_FLOAT(half.g) << " B: " << HALF_TO_FLOAT(half.b) << " A: " << HALF_TO_FLOAT(half.a);
+				return os;
+			}
+		};
+
+		// < Conversions >
+
+		inline uint16_t unorm16(float c) { return static_cast<uint16_t>(max(min(c, 1.0f), 0.0f) * 65535.0f + 0.5f); }
+
+		inline RGB RGBA16_TO_RGB(RGBA16 rgba16)
+		{
+			const float scale = 1.0f / 65535.0f;
+			return RGB(rgba16.r * scale, rgba16.g * scale, rgba16.b * scale, rgba16.a * scale);
+		}
+		inline RGBA16 RGB_TO_RGBA16(RGB rgb) { return RGBA16(unorm16(rgb.r), unorm16(rgb.g), unorm16(rgb.b), unorm16(rgb.a)); }
+
+		// x * 257 widens exactly, (x * 255 + 32895) >> 16 is x / 257 rounded for every 16bit x
+		inline RGBA16 RGB32_TO_RGBA16(RGB32 rgb32) { return RGBA16(rgb32.r * 257, rgb32.g * 257, rgb32.b * 257, rgb32.a * 257); }
+		inline RGB32 RGBA16_TO_RGB32(RGBA16 rgba16)
+		{
+			auto narrow = [](uint16_t c) { return static_cast<BYTE>((c * 255u + 32895u) >> 16); };
+			return RGB32(narrow(rgba16.r), narrow(rgba16.g), narrow(rgba16.b), narrow(rgba16.a));
+		}
+
+		inline RGB RGBA_HALF_TO_RGB(RGBA_Half half) { return RGB(HALF_TO_FLOAT(half.r), HALF_TO_FLOAT(half.g), HALF_TO_FLOAT(half.b), HALF_TO_FLOAT(half.a)); }
+		inline RGBA_Half RGB_TO_RGBA_HALF(RGB rgb) { return RGBA_Half(FLOAT_TO_HALF(rgb.r), FLOAT_TO_HALF(rgb.g), FLOAT_TO_HALF(rgb.b), FLOAT_TO_HALF(rgb.a)); }
+
+		// Rounded rather than truncated like RGB_TO_RGB32, so 8bit values survive a trip through half
+		inline RGB32 RGBA_HALF_TO_RGB32(RGBA_Half half)
+		{
+			auto level = [](HALF c) { return static_cast<BYTE>(max(min(HALF_TO_FLOAT(c), 1.0f), 0.0f) * 255.0f + 0.5f); };
+			return RGB32(level(half.r), level(half.g), level(half.b), level(half.a));
+		}
+
+		inline RGBA16 To_RGBA16(RGB32 rgb32) { return RGB32_TO_RGBA16(rgb32); }
+		inline RGBA16 To_RGBA16(RGB rgb) { return RGB_TO_RGBA16(rgb); }
+		inline RGBA16 To_RGBA16(HSV hsv) { return RGB_TO_RGBA16(HSV_TO_RGB(hsv)); }
+		inline RGBA16 To_RGBA16(HSL hsl) { return RGB_TO_RGBA16(HSL_TO_RGB(hsl)); }
+		inline RGBA16 To_RGBA16(CMYK cmyk) { return RGB_TO_RGBA16(CMYK_TO_RGB(cmyk)); }
+		inline RGBA16 To_RGBA16(RGBA_Half half) { return RGB_TO_RGBA16(RGBA_HALF_TO_RGB(half)); }
+
+		inline RGBA_Half To_RGBA_Half(RGB32 rgb32) { return RGB_TO_RGBA_HALF(RGB32_TO_RGB(rgb32)); }
+		inline RGBA_Half To_RGBA_Half(RGB rgb) { return RGB_TO_RGBA_HALF(rgb); }
+		inline RGBA_Half To_RGBA_Half(HSV hsv) { return RGB_TO_RGBA_HALF(HSV_TO_RGB(hsv)); }
+		inline RGBA_Half To_RGBA_Half(HSL hsl) { return RGB_TO_RGBA_HALF(HSL_TO_RGB(hsl)); }
+		inline RGBA_Half To_RGBA_Half(CMYK cmyk) { return RGB_TO_RGBA_HALF(CMYK_TO_RGB(cmyk)); }
+		inline RGBA_Half To_RGBA_Half(RGBA16 rgba16) { return RGB_TO_RGBA_HALF(RGBA16_TO_RGB(rgba16)); }
+
+		inline RGB32 To_RGB32(RGBA16 rgba16) { return RGBA16_TO_RGB32(rgba16); }
+		inline RGB32 To_RGB32(RGBA_Half half) { return RGBA_HALF_TO_RGB32(half); }
+		inline RGB To_RGB(RGBA16 rgba16) { return RGBA16_TO_RGB(rgba16); }
+		inline RGB To_RGB(RGBA_Half half) { return RGBA_HALF_TO_RGB(half); }
+		inline HSV To_HSV(RGBA16 rgba16) { return RGB_TO_HSV(RGBA16_TO_RGB(rgba16)); }
+		inline HSV To_HSV(RGBA_Half half) { return RGB_TO_HSV(RGBA_HALF_TO_RGB(half)); }
+		inline HSL To_HSL(RGBA16 rgba16) { return RGB_TO_HSL(RGBA16_TO_RGB(rgba16)); }
+		inline HSL To_HSL(RGBA_Half half) { return RGB_TO_HSL(RGBA_HALF_TO_RGB(half)); }
+		inline CMYK To_CMYK(RGBA16 rgba16) { return RGB_TO_CMYK(RGBA16_TO_RGB(rgba16)); }
+		inline CMYK To_CMYK(RGBA_Half half) { return RGB_TO_CMYK(RGBA_HALF_TO_RGB(half)); }
+
+		// < Bulk conversion >
+		// RGB, RGBA16 and RGBA_Half are all four interleaved channels, so these run over the
+		// buffers as flat channel arrays, two pixels per 128bit step.
+
+		inline void Convert(std::span<const RGBA_Half> src, std::span<RGB> dst)
+		{
+			const size_t count = std::min(src.size(), dst.size());
+			size_t i = 0;
+#if defined(ZCPP_COLOR_F16C)
+			const HALF* in = reinterpret_cast<const HALF*>(src.data());
+			float* out = reinterpret_cast<float*>(dst.data());
+			for (; i + 2 <= count; i += 2) {
+				const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 4 * i));
+				_mm_storeu_ps(out + 4 * i, _mm_cvtph_ps(v));
+				_mm_storeu_ps(out + 4 * i + 4, _mm_cvtph_ps(_mm_unpackhi_epi64(v, v)));
+			}
+#endif
+			for (; i < count; i++)
+				dst[i] = RGBA_HALF_TO_RGB(src[i]);
+		}
+
+		inline void Convert(std::span<const RGB> src, std::span<RGBA_Half> dst)
+		{
+			const size_t count = std::min(src.size(), dst.size());
+			size_t i = 0;
+#if defined(ZCPP_COLOR_F16C)
+			const float* in = reinterpret_cast<const float*>(src.data());
+			HALF* out = reinterpret_cast<HALF*>(dst.data());
+			for (; i + 2 <= count; i += 2) {
+				const __m128i lo = _mm_cvtps_ph(_mm_loadu_ps(in + 4 * i), _MM_FROUND_TO_NEAREST_INT);
+				const __m128i hi = _mm_cvtps_ph(_mm_loadu_ps(in + 4 * i + 4), _MM_FROUND_TO_NEAREST_INT);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4 * i), _mm_unpacklo_epi64(lo, hi));
+			}
+#endif
+			for (; i < count; i++)
+				dst[i] = RGB_TO_RGBA_HALF(src[i]);
+		}
+
+		inline void Convert(std::span<const RGBA16> src, std::span<RGB> dst)
+		{
+			const size_t count = std::min(src.size(), dst.size());
+			size_t i = 0;
+#if defined(ZCPP_COLOR_SSE2)
+			const uint16_t* in = reinterpret_cast<const uint16_t*>(src.data());
+			float* out = reinterpret_cast<float*>(dst.data());
+			const __m128 scale = _mm_set1_ps(1.0f / 65535.0f);
+			const __m128i zero = _mm_setzero_si128();
+			for (; i + 2 <= count; i += 2) {
+				const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 4 * i));
+				_mm_storeu_ps(out + 4 * i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(v, zero)), scale));
+				_mm_storeu_ps(out + 4 * i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(v, zero)), scale));
+			}
+#endif
+			for (; i < count; i++)
+				dst[i] = RGBA16_TO_RGB(src[i]);
+		}
+
+		inline void Convert(std::span<const RGB> src, std::span<RGBA16> dst)
+		{
+			const size_t count = std::min(src.size(), dst.size());
+			size_t i = 0;
+#if defined(ZCPP_COLOR_SSE2)
+			const float* in = reinterpret_cast<const float*>(src.data());
+			uint16_t* out = reinterpret_cast<uint16_t*>(dst.data());
+			const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f), scale = _mm_set1_ps(65535.0f), half = _mm_set1_ps(0.5f);
+			auto level = [&](__m128 c) {
+				// Biased by -32768 so the signed pack saturates nothing, flipped back after
+				const __m128i v = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(c, zero), one), scale), half));
+				return _mm_sub_epi32(v, _mm_set1_epi32(32768));
+			};
+			for (; i + 2 <= count; i += 2) {
+				const __m128i packed = _mm_packs_epi32(level(_mm_loadu_ps(in + 4 * i)), level(_mm_loadu_ps(in + 4 * i + 4)));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4 * i), _mm_xor_si128(packed, _mm_set1_epi16(static_cast<short>(0x8000))));
+			}
+#endif
+			for (; i < count; i++)
+				dst[i] = RGB_TO_RGBA16(src[i]);
+		}
+
+		inline void Convert(std::span<const RGB32> src, std::span<RGBA16> dst)
+		{
+			const size_t count = std::min(src.size(), dst.size());
+			size_t i = 0;
+#if defined(ZCPP_COLOR_SSE2)
+			for (; i + 4 <= count; i += 4) {
+				// Each byte paired with itself is c * 257
+				const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src.data() + i));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst.data() + i), _mm_unpacklo_epi8(v, v));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst.data() + i + 2), _mm_unpackhi_epi8(v, v));
+			}
+#endif
+			for (; i < count; i++)
+				dst[i] = RGB32_TO_RGBA16(src[i]);
+		}
+
+		inline void Convert(std::span<const RGBA16> src, std::span<RGB32> dst)
+		{
+			const size_t count = std::min(src.size(), dst.size());
+			size_t i = 0;
+#if defined(ZCPP_COLOR_SSE2)
+			// (c * 255 + 32895) >> 16 in 32bit lanes, the product rebuilt from mullo / mulhi
+			const __m128i m255 = _mm_set1_epi16(255), bias = _mm_set1_epi32(32895);
+			auto narrow = [&](__m128i v) {
+				const __m128i lo = _mm_mullo_epi16(v, m255), hi = _mm_mulhi_epu16(v, m255);
+				const __m128i a = _mm_srli_epi32(_mm_add_epi32(_mm_unpacklo_epi16(lo, hi), bias), 16);
+				const __m128i b = _mm_srli_epi32(_mm_add_epi32(_mm_unpackhi_epi16(lo, hi), bias), 16);
+				return _mm_packs_epi32(a, b);
+			};
+			for (; i + 4 <= count; i += 4) {
+				const __m128i a = narrow(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src.data() + i)));
+				const __m128i b = narrow(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src.data() + i + 2)));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst.data() + i), _mm_packus_epi16(a, b));
+			}
+#endif
+			for (; i < count; i++)
+				dst[i] = RGBA16_TO_RGB32(src[i]);
+		}
+
+		// Half <-> 8bit through a small float buffer, both halves staying vectorized
+		inline void Convert(std::span<const RGBA_Half> src, std::span<RGB32> dst)
+		{
+			const size_t count = std::min(src.size(), dst.size());
+			std::array<RGB, 256> buffer;
+			for (size_t i = 0; i < count; i += buffer.size()) {
+				const size_t n = std::min(buffer.size(), count - i);
+				Convert(src.subspan(i, n), std::span<RGB>(buffer.data(), n));
+				size_t k = 0;
+#if defined(ZCPP_COLOR_SSE2)
+				const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f), scale = _mm_set1_ps(255.0f), half = _mm_set1_ps(0.5f);
+				for (; k < n; k++) {
+					const __m128i v = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(&buffer[k].r), zero), one), scale), half));
+					const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(v, v), v);
+					const int bytes = _mm_cvtsi128_si32(packed);
+					memcpy(static_cast<void*>(&dst[i + k]), &bytes, sizeof(bytes));
+				}
+#endif
+				for (; k < n; k++)
+					dst[i + k] = RGBA_HALF_TO_RGB32(src[i + k]);
+			}
+		}
+
+		inline void Convert(std::span<const RGB32> src, std::span<RGBA_Half> dst)
+		{
+			const size_t count = std::min(src.size(), dst.size());
+			std::array<RGB, 256> buffer;
+			for (size_t i = 0; i < count; i += buffer.size()) {
+				const size_t n = std::min(buffer.size(), count - i);
+				Convert(src.subspan(i, n), std::span<RGB>(buffer.data(), n));
+				Convert(std::span<const RGB>(buffer.data(), n), dst.subspan(i, n));
+			}
+		}
 	}
 }
\ No newline at end of file
@@ -2,6 +2,17 @@
 #include <random>
 #include <limits.h>
 #include <algorithm>
+#include <atomic>
+#include <array>
+#include <cstdint>
+#include <type_traits>
+#include <span>
+#include <cstring>
+
+#if !defined(ZCPP_RANDOM_NO_SIMD) && defined(__AVX2__)
+#define ZCPP_RANDOM_AVX2
+#include <immintrin.h>
+#endif
 
 namespace ZCPP
 {
@@ -16,75 +27,677 @@ namespace ZCPP
 		// | Random<Bool>()  - bool(false, true)           |
 		// |                                               |
 		// | Random<Type>(min, max) - Type(min, max)       |
+		// | BoundedRange<Int>(min, max) - Repeated draws  |
+		// |                                               |
+		// | Every thread draws from its own engine:       |
+		// | Seed(master) - Reproducible per-thread streams|
+		// | Set_Thread_Index(i) - Fixes a worker's stream |
+		// |                                               |
+		// | Engines: Xoshiro256ss  Xoshiro128p  PCG32     |
+		// |          PCG64  SplitMix64  Wyrand            |
+		// | Generator<Engine> - Random() on any engine    |
+		// | ZCPP_RANDOM_ENGINE - Engine behind Random()   |
+		// |                                               |
+		// | Fill(span, min, max) - Bulk floats, ints,     |
+		// |                        bools, bytes (AVX2)    |
+		// | Philox4x32 - Counter-based, O(1) skip-ahead,  |
+		// |              split-invariant parallel fills   |
 		// |                                     - Zyphery |
 		// \-----------------------------------------------/
 
+		// /-----------------------------------------------\
+		// | Random Engines                                |
+		// \-----------------------------------------------/
+
+		// All engines below are UniformRandomBitGenerators, so they also work with the std
+		// distributions. Each seeds from one 64bit value (expanded by SplitMix64) or a seed_seq.
+
+		inline uint64_t rotl64(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+		inline uint32_t rotl32(uint32_t x, int k) { return (x << k) | (x >> (32 - k)); }
+
+		// High and low halves of a * b
+		inline void mul_128(uint64_t a, uint64_t b, uint64_t& hi, uint64_t& lo)
+		{
+#if defined(__SIZEOF_INT128__)
+			const unsigned __int128 p = static_cast<unsigned __int128>(a) * b;
+			hi = static_cast<uint64_t>(p >> 64);
+			lo = static_cast<uint64_t>(p);
+#else
+			const uint64_t a_lo = a & 0xFFFFFFFFu, a_hi = a >> 32, b_lo = b & 0xFFFFFFFFu, b_hi = b >> 32;
+			const uint64_t ll = a_lo * b_lo, lh = a_lo * b_hi, hl = a_hi * b_lo, hh = a_hi * b_hi;
+			const uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFFu) + (hl & 0xFFFFFFFFu);
+			hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+			lo = (mid << 32) | (ll & 0xFFFFFFFFu);
+#endif
+		}
+
+		// 64bit words from a seed_seq, for engines whose state is not 32bit words
+		template<size_t Count>
+		std::array<uint64_t, Count> seed_words(std::seed_seq& seq)
+		{
+			std::array<uint32_t, Count * 2> words;
+			seq.generate(words.begin(), words.end());
+			std::array<uint64_t, Count> out;
+			for (size_t i = 0; i < Count; i++)
+				out[i] = words[2 * i] | (static_cast<uint64_t>(words[2 * i + 1]) << 32);
+			return out;
+		}
+
+		// < SplitMix64 (Steele, Lea, Flood) >
+		// 8 bytes of state, passes BigCrush; also expands seeds for the other engines
+		class SplitMix64
+		{
+		public:
+			typedef uint64_t result_type;
+			uint64_t state;
+
+			explicit SplitMix64(uint64_t seed = 0x853C49E6748FEA9Bull) : state(seed) {}
+			void seed(uint64_t value) { state = value; }
+			void seed(std::seed_seq& seq) { state = seed_words<1>(seq)[0]; }
+
+			static constexpr result_type min() { return 0; }
+			static constexpr result_type max() { return UINT64_MAX; }
+
+			result_type operator()()
+			{
+				uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+				z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+				z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+				return z ^ (z >> 31);
+			}
+		};
+
+		// < xoshiro256** (Blackman, Vigna) >
+		// 32 bytes of state, all 64 output bits are good
+		class Xoshiro256ss
+		{
+		public:
+			typedef uint64_t result_type;
+			uint64_t s[4];
+
+			explicit Xoshiro256ss(uint64_t seed = 0x853C49E6748FEA9Bull) { this->seed(seed); }
+			void seed(uint64_t value)
+			{
+				SplitMix64 mix(value);
+				for (uint64_t& word : s)
+					word = mix();
+			}
+			void seed(std::seed_seq& seq)
+			{
+				const std::array<uint64_t, 4> words = seed_words<4>(seq);
+				std::copy(words.begin(), words.end(), s);
+				if (!(s[0] | s[1] | s[2] | s[3]))
+					s[0] = 1;
+			}
+
+			static constexpr result_type min() { return 0; }
+			static constexpr result_type max() { return UINT64_MAX; }
+
+			result_type operator()()
+			{
+				const uint64_t result = rotl64(s[1] * 5, 7) * 9;
+				const uint64_t t = s[1] << 17;
+				s[2] ^= s[0];
+				s[3] ^= s[1];
+				s[1] ^= s[2];
+				s[0] ^= s[3];
+				s[2] ^= t;
+				s[3] = rotl64(s[3], 45);
+				return result;
+			}
+
+			// Advances 2^128 draws, for up to 2^128 non-overlapping streams
+			void Jump()
+			{
+				static const uint64_t table[4] = { 0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull };
+				uint64_t t[4] = { 0, 0, 0, 0 };
+				for (uint64_t word : table) {
+					for (int bit = 0; bit < 64; bit++) {
+						if (word & (1ull << bit)) {
+							t[0] ^= s[0]; t[1] ^= s[1]; t[2] ^= s[2]; t[3] ^= s[3];
+						}
+						(*this)();
+					}
+				}
+				std::copy(t, t + 4, s);
+			}
+		};
+
+		// < Four xoshiro256** lanes stepped together >
+		// Lane n starts n Jump()s after the seed, so the lanes never overlap. Word i of a block comes
+		// from lane i % 4, the same in every build; AVX2 steps all four in one register.
+		class Xoshiro256ss_x4
+		{
+		public:
+			// s[word][lane]
+			alignas(32) uint64_t s[4][4];
+
+			explicit Xoshiro256ss_x4(uint64_t seed = 0x853C49E6748FEA9Bull) { this->seed(seed); }
+			void seed(uint64_t value)
+			{
+				Xoshiro256ss base(value);
+				for (size_t lane = 0; lane < 4; lane++) {
+					for (size_t word = 0; word < 4; word++)
+						s[word][lane] = base.s[word];
+					base.Jump();
+				}
+			}
+
+			// count random words, count rounded up to a multiple of 4 internally (the rest is dropped)
+			void Fill_Bits(uint64_t* out, size_t count)
+			{
+				size_t i = 0;
+#if defined(ZCPP_RANDOM_AVX2)
+				__m256i s0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(s[0]));
+				__m256i s1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(s[1]));
+				__m256i s2 = _mm256_load_si256(reinterpret_cast<const __m256i*>(s[2]));
+				__m256i s3 = _mm256_load_si256(reinterpret_cast<const __m256i*>(s[3]));
+				for (; i < count; i += 4) {
+					// rotl(s1 * 5, 7) * 9, the multiplies as shift + add
+					const __m256i x5 = _mm256_add_epi64(s1, _mm256_slli_epi64(s1, 2));
+					const __m256i r = _mm256_or_si256(_mm256_slli_epi64(x5, 7), _mm256_srli_epi64(x5, 57));
+					const __m256i result = _mm256_add_epi64(r, _mm256_slli_epi64(r, 3));
+					const __m256i t = _mm256_slli_epi64(s1, 17);
+					s2 = _mm256_xor_si256(s2, s0);
+					s3 = _mm256_xor_si256(s3, s1);
+					s1 = _mm256_xor_si256(s1, s2);
+					s0 = _mm256_xor_si256(s0, s3);
+					s2 = _mm256_xor_si256(s2, t);
+					s3 = _mm256_or_si256(_mm256_slli_epi64(s3, 45), _mm256_srli_epi64(s3, 19));
+					if (i + 4 <= count)
+						_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), result);
+					else {
+						alignas(32) uint64_t rest[4];
+						_mm256_store_si256(reinterpret_cast<__m256i*>(rest), result);
+						std::copy(rest, rest + (count - i), out + i);
+					}
+				}
+				_mm256_store_si256(reinterpret_cast<__m256i*>(s[0]), s0);
+				_mm256_store_si256(reinterpret_cast<__m256i*>(s[1]), s1);
+				_mm256_store_si256(reinterpret_cast<__m256i*>(s[2]), s2);
+				_mm256_store_si256(reinterpret_cast<__m256i*>(s[3]), s3);
+#else
+				for (; i < count; i += 4) {
+					for (size_t lane = 0; lane < 4; lane++) {
+						const uint64_t result = rotl64(s[1][lane] * 5, 7) * 9;
+						const uint64_t t = s[1][lane] << 17;
+						s[2][lane] ^= s[0][lane];
+						s[3][lane] ^= s[1][lane];
+						s[1][lane] ^= s[2][lane];
+						s[0][lane] ^= s[3][lane];
+						s[2][lane] ^= t;
+						s[3][lane] = rotl64(s[3][lane], 45);
+						if (i + lane < count)
+							out[i + lane] = result;
+					}
+				}
+#endif
+			}
+		};
+
+		// < xoshiro128+ (Blackman, Vigna) >
+		// 16 bytes of state, 32bit output. The lowest bits are weak: meant for floats, where they are
+		// discarded, not for integers or bits.
+		class Xoshiro128p
+		{
+		public:
+			typedef uint32_t result_type;
+			uint32_t s[4];
+
+			explicit Xoshiro128p(uint64_t seed = 0x853C49E6748FEA9Bull) { this->seed(seed); }
+			void seed(uint64_t value)
+			{
+				SplitMix64 mix(value);
+				const uint64_t a = mix(), b = mix();
+				s[0] = static_cast<uint32_t>(a); s[1] = static_cast<uint32_t>(a >> 32);
+				s[2] = static_cast<uint32_t>(b); s[3] = static_cast<uint32_t>(b >> 32);
+			}
+			void seed(std::seed_seq& seq)
+			{
+				seq.generate(s, s + 4);
+				if (!(s[0] | s[1] | s[2] | s[3]))
+					s[0] = 1;
+			}
+
+			static constexpr result_type min() { return 0; }
+			static constexpr result_type max() { return UINT32_MAX; }
+
+			result_type operator()()
+			{
+				const uint32_t result = s[0] + s[3];
+				const uint32_t t = s[1] << 9;
+				s[2] ^= s[0];
+				s[3] ^= s[1];
+				s[1] ^= s[2];
+				s[0] ^= s[3];
+				s[2] ^= t;
+				s[3] = rotl32(s[3], 11);
+				return result;
+			}
+		};
+
+		// < PCG32, XSH-RR 64/32 (O'Neill) >
+		// 64bit LCG state plus a stream selector, 2^63 distinct streams
+		class PCG32
+		{
+		public:
+			typedef uint32_t result_type;
+			uint64_t state, increment;
+
+			explicit PCG32(uint64_t seed = 0x853C49E6748FEA9Bull, uint64_t stream = 0xDA3E39CB94B95BDBull) { this->seed(seed, stream); }
+			void seed(uint64_t value, uint64_t stream = 0xDA3E39CB94B95BDBull)
+			{
+				state = 0;
+				increment = (stream << 1) | 1;
+				(*this)();
+				state += value;
+				(*this)();
+			}
+			void seed(std::seed_seq& seq)
+			{
+				const std::array<uint64_t, 2> words = seed_words<2>(seq);
+				seed(words[0], words[1]);
+			}
+
+			static constexpr result_type min() { return 0; }
+			static constexpr result_type max() { return UINT32_MAX; }
+
+			result_type operator()()
+			{
+				const uint64_t old = state;
+				state = old * 6364136223846793005ull + increment;
+				const uint32_t shifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+				const int rotation = static_cast<int>(old >> 59);
+				return (shifted >> rotation) | (shifted << ((-rotation) & 31));
+			}
+		};
+
+		// < PCG64, XSL-RR 128/64 (O'Neill) >
+		// 128bit LCG state plus a stream selector
+		class PCG64
+		{
+		public:
+			typedef uint64_t result_type;
+			uint64_t state_hi, state_lo, increment_hi, increment_lo;
+
+			explicit PCG64(uint64_t seed = 0x853C49E6748FEA9Bull, uint64_t stream = 0xDA3E39CB94B95BDBull) { this->seed(seed, stream); }
+			void seed(uint64_t value, uint64_t stream = 0xDA3E39CB94B95BDBull)
+			{
+				seed(0, value, 0, stream);
+			}
+			void seed(std::seed_seq& seq)
+			{
+				const std::array<uint64_t, 4> words = seed_words<4>(seq);
+				seed(words[0], words[1], words[2], words[3]);
+			}
+
+			static constexpr result_type min() { return 0; }
+			static constexpr result_type max() { return UINT64_MAX; }
+
+			result_type operator()()
+			{
+				Step();
+				const uint64_t x = state_hi ^ state_lo;
+				const int rotation = static_cast<int>(state_hi >> 58);
+				return (x >> rotation) | (x << ((-rotation) & 63));
+			}
+
+		private:
+			void seed(uint64_t value_hi, uint64_t value_lo, uint64_t stream_hi, uint64_t stream_lo)
+			{
+				state_hi = state_lo = 0;
+				increment_hi = (stream_hi << 1) | (stream_lo >> 63);
+				increment_lo = (stream_lo << 1) | 1;
+				Step();
+				state_lo += value_lo;
+				state_hi += value_hi + (state_lo < value_lo);
+				Step();
+			}
+
+			// state = state * multiplier + increment, mod 2^128
+			void Step()
+			{
+				const uint64_t mul_hi = 0x2360ED051FC65DA4ull, mul_lo = 0x4385DF649FCCF645ull;
+				uint64_t hi, lo;
+				mul_128(state_lo, mul_lo, hi, lo);
+				hi += state_hi * mul_lo + state_lo * mul_hi;
+				state_lo = lo + increment_lo;
+				state_hi = hi + increment_hi + (state_lo < lo);
+			}
+		};
+
+		// < wyrand (Wang Yi) >
+		// 8 bytes of state, one 64x64->128 multiply per draw
+		class Wyrand
+		{
+		public:
+			typedef uint64_t result_type;
+			uint64_t state;
+
+			explicit Wyrand(uint64_t seed = 0x853C49E6748FEA9Bull) : state(seed) {}
+			void seed(uint64_t value) { state = value; }
+			void seed(std::seed_seq& seq) { state = seed_words<1>(seq)[0]; }
+
+			static constexpr result_type min() { return 0; }
+			static constexpr result_type max() { return UINT64_MAX; }
+
+			result_type operator()()
+			{
+				state += 0xA0761D6478BD642Full;
+				uint64_t hi, lo;
+				mul_128(state, state ^ 0xE7037ED1A0B428DBull, hi, lo);
+				return hi ^ lo;
+			}
+		};
+
+		// Engine behind the free Random() functions. Define ZCPP_RANDOM_ENGINE before including this
+		// header to pick another one, e.g. #define ZCPP_RANDOM_ENGINE ZCPP::Random::Xoshiro256ss
+#if defined(ZCPP_RANDOM_ENGINE)
+		typedef ZCPP_RANDOM_ENGINE Default_Engine;
+#else
+		typedef std::mt19937 Default_Engine;
+#endif
+
 		// /-----------------------------------------------\
 		// | Random Device                                 |
 		// \-----------------------------------------------/
 		
-		static std::random_device device;
+		// < 64 bits from the OS random device >
+		inline unsigned long long Entropy()
+		{
+			static std::random_device device;
+			return (static_cast<unsigned long long>(device()) << 32) | device();
+		}
+
+		// Seed all thread engines are derived from, random unless Seed() is called
+		inline std::atomic<unsigned long long> master_seed{ Entropy() };
+		// Bumped by Seed(), threads reseed lazily on their next draw when it changes
+		inline std::atomic<unsigned long long> seed_generation{ 0 };
+		// Next default thread index, in order of each thread's first draw
+		inline std::atomic<unsigned long long> thread_counter{ 0 };
+
+		// < Engine state of one thread >
+		struct Thread_Engine
+		{
+			Default_Engine engine;
+			unsigned long long index = thread_counter.fetch_add(1, std::memory_order_relaxed);
+			unsigned long long generation = ~0ull;
+			Xoshiro256ss_x4 lanes;
+			unsigned long long lanes_generation = ~0ull;
+		};
+
+		inline Thread_Engine& Thread_State()
+		{
+			thread_local Thread_Engine state;
+			return state;
+		}
+
+		// Engine of the calling thread, seeded from (master seed, thread index).
+		// No locking: each thread only ever touches its own state.
+		inline Default_Engine& Engine()
+		{
+			Thread_Engine& state = Thread_State();
+			const unsigned long long generation = seed_generation.load(std::memory_order_acquire);
+			if (state.generation != generation) {
+				const unsigned long long master = master_seed.load(std::memory_order_relaxed);
+				std::seed_seq seq{ static_cast<unsigned int>(master), static_cast<unsigned int>(master >> 32),
+					static_cast<unsigned int>(state.index), static_cast<unsigned int>(state.index >> 32) };
+				state.engine.seed(seq);
+				state.generation = generation;
+			}
+			return state.engine;
+		}
+
+		// Reseeds every thread's engine from master, each on its next draw
+		inline void Seed(unsigned long long master)
+		{
+			master_seed.store(master, std::memory_order_relaxed);
+			seed_generation.fetch_add(1, std::memory_order_release);
+		}
+
+		// Sets the calling thread's index and restarts its stream. By default threads are numbered
+		// in the order they first draw, set it from a worker id when that order is not fixed.
+		inline void Set_Thread_Index(unsigned long long index)
+		{
+			Thread_Engine& state = Thread_State();
+			state.index = index;
+			state.generation = ~0ull;
+			state.lanes_generation = ~0ull;
+		}
+
+		// /-----------------------------------------------\
+		// | Distributions                                 |
+		// \-----------------------------------------------/
+
+		// Uniform 32 and 64bit words from any engine
+		template<typename Engine_Type>
+		uint32_t bits32(Engine_Type& engine)
+		{
+			if constexpr (Engine_Type::min() == 0 && Engine_Type::max() == UINT64_MAX)
+				return static_cast<uint32_t>(static_cast<uint64_t>(engine()) >> 32);
+			else if constexpr (Engine_Type::min() == 0 && Engine_Type::max() == UINT32_MAX)
+				return static_cast<uint32_t>(engine());
+			else
+				return std::uniform_int_distribution<uint32_t>()(engine);
+		}
+
+		template<typename Engine_Type>
+		uint64_t bits64(Engine_Type& engine)
+		{
+			if constexpr (Engine_Type::min() == 0 && Engine_Type::max() == UINT64_MAX)
+				return static_cast<uint64_t>(engine());
+			else {
+				const uint64_t hi = bits32(engine);
+				return (hi << 32) | bits32(engine);
+			}
+		}
+
+		// < Lemire's nearly divisionless bounded integers >
+		// x * range >> bits maps a random x onto [0, range); products whose low half falls under
+		// 2^bits % range are redrawn so every result is equally likely. That threshold costs a
+		// division, but it is only needed when the low half is below range, rarely for small ranges.
+		// range 0 stands for the full 2^32 / 2^64.
+
+		template<typename Engine_Type>
+		uint32_t bounded32(Engine_Type& engine, uint32_t range)
+		{
+			if (range == 0)
+				return bits32(engine);
+			uint64_t m = static_cast<uint64_t>(bits32(engine)) * range;
+			if (static_cast<uint32_t>(m) < range) {
+				const uint32_t threshold = (0u - range) % range;
+				while (static_cast<uint32_t>(m) < threshold)
+					m = static_cast<uint64_t>(bits32(engine)) * range;
+			}
+			return static_cast<uint32_t>(m >> 32);
+		}
+
+		template<typename Engine_Type>
+		uint64_t bounded64(Engine_Type& engine, uint64_t range)
+		{
+			if (range == 0)
+				return bits64(engine);
+			uint64_t hi, lo;
+			mul_128(bits64(engine), range, hi, lo);
+			if (lo < range) {
+				const uint64_t threshold = (0 - range) % range;
+				while (lo < threshold)
+					mul_128(bits64(engine), range, hi, lo);
+			}
+			return hi;
+		}
 
-		static std::mt19937 rng(device());
+		// Random<Type>() on any engine: floats in (-1.0, 1.0), integers over their full range
+		template<typename Type, typename Engine_Type>
+		Type Uniform(Engine_Type& engine)
+		{
+			if constexpr (std::is_same_v<Type, bool>)
+				return std::uniform_real_distribution<float>(-1.0f, 1.0f)(engine) >= 0.0f;
+			else if constexpr (std::is_floating_point_v<Type>)
+				return std::uniform_real_distribution<Type>(Type(-1), Type(1))(engine);
+			else if constexpr (sizeof(Type) <= 4)
+				return static_cast<Type>(bits32(engine));
+			else
+				return static_cast<Type>(bits64(engine));
+		}
+
+		// Random(min, max) on any engine; integer bounds may come in either order
+		template<typename Type, typename Engine_Type>
+		Type Uniform(Engine_Type& engine, const Type& min, const Type& max)
+		{
+			if constexpr (std::is_floating_point_v<Type>)
+				return std::uniform_real_distribution<Type>(min, max)(engine);
+			else {
+				if (max < min)
+					return Uniform<Type>(engine, max, min);
+				typedef std::make_unsigned_t<Type> Unsigned;
+				const Unsigned span = static_cast<Unsigned>(static_cast<Unsigned>(max) - static_cast<Unsigned>(min));
+				if constexpr (sizeof(Type) <= 4)
+					return static_cast<Type>(static_cast<Unsigned>(min) + static_cast<Unsigned>(bounded32(engine, static_cast<uint32_t>(span) + 1u)));
+				else
+					return static_cast<Type>(static_cast<Unsigned>(min) + static_cast<Unsigned>(bounded64(engine, static_cast<uint64_t>(span) + 1u)));
+			}
+		}
+
+		// < Integers in [min, max] with the rejection threshold computed once >
+		// For repeated draws from one range (index sampling, shuffles): each draw is one multiply
+		// and a compare, no division at all.
+		template<typename Type>
+		requires (std::is_integral_v<Type> && !std::is_same_v<Type, bool>)
+		class BoundedRange
+		{
+		private:
+			typedef std::make_unsigned_t<Type> Unsigned;
+			static constexpr bool wide = sizeof(Type) > 4;
+
+			Type low, high;
+			// Number of values, 0 for the full 2^32 / 2^64
+			uint64_t range;
+			uint64_t threshold;
+
+		public:
+			BoundedRange(Type min, Type max) : low(std::min(min, max)), high(std::max(min, max))
+			{
+				const uint64_t span = static_cast<Unsigned>(static_cast<Unsigned>(high) - static_cast<Unsigned>(low));
+				if constexpr (wide) {
+					range = span + 1;
+					threshold = range ? (0 - range) % range : 0;
+				}
+				else {
+					range = static_cast<uint32_t>(span + 1);
+					threshold = range ? (0u - static_cast<uint32_t>(range)) % static_cast<uint32_t>(range) : 0;
+				}
+			}
+
+			Type Min() const { return low; }
+			Type Max() const { return high; }
+
+			template<typename Engine_Type>
+			Type operator()(Engine_Type& engine) const
+			{
+				if constexpr (wide) {
+					if (range == 0)
+						return static_cast<Type>(bits64(engine));
+					uint64_t hi, lo;
+					do
+						mul_128(bits64(engine), range, hi, lo);
+					while (lo < threshold);
+					return static_cast<Type>(static_cast<Unsigned>(low) + static_cast<Unsigned>(hi));
+				}
+				else {
+					if (range == 0)
+						return static_cast<Type>(bits32(engine));
+					uint64_t m;
+					do
+						m = static_cast<uint64_t>(bits32(engine)) * range;
+					while (static_cast<uint32_t>(m) < threshold);
+					return static_cast<Type>(static_cast<Unsigned>(low) + static_cast<Unsigned>(m >> 32));
+				}
+			}
+
+			// Draw from the calling thread's engine
+			Type operator()() const { return (*this)(Engine()); }
+		};
+
+		// < The Random() API on an engine of your own, e.g. Generator<PCG32> rng(seed) >
+		// Not shared between threads: give each thread its own Generator.
+		template<typename Engine_Type>
+		class Generator
+		{
+		public:
+			Engine_Type engine;
+
+			Generator() : engine() {}
+			explicit Generator(uint64_t seed) : engine(seed) {}
+
+			template<typename Type = float>
+			Type Random() { return Uniform<Type>(engine); }
+
+			template<typename Type = float>
+			Type Random(const Type& min, const Type& max)
+			{
+				return min > max ? Uniform<Type>(engine, max, min) : Uniform<Type>(engine, min, max);
+			}
+		};
 
 		// /-----------------------------------------------\
 		// | Random Functions                              |
 		// \-----------------------------------------------/
 
 		const static bool Random(bool) {
-			return std::uniform_real_distribution<float>(-1.0f, 1.0f)(rng) >= 0.0f;
+			return Uniform<bool>(Engine());
 		}
 
 		const static float Random(float) {
-			return std::uniform_real_distribution<float>(-1.0f, 1.0f)(rng);
+			return Uniform<float>(Engine());
 		}
 
 		const static double Random(double) {
-			return std::uniform_real_distribution<double>(-1.0, 1.0)(rng);
+			return Uniform<double>(Engine());
 		}
 
 		const static long double Random(long double) {
-			return std::uniform_real_distribution<long double>(-1.0l, 1.0l)(rng);
+			return Uniform<long double>(Engine());
 		}
 
 		const static char Random(char) {
-			return std::uniform_int_distribution<char>(std::numeric_limits<char>::min(), std::numeric_limits<char>::max())(rng);
+			return Uniform<char>(Engine());
 		}
 
 		const static unsigned char Random(unsigned char) {
-			return std::uniform_int_distribution<unsigned char>(std::numeric_limits<unsigned char>::min(), std::numeric_limits<unsigned char>::max())(rng);
+			return Uniform<unsigned char>(Engine());
 		}
 
 		const static short Random(short) {
-			return std::uniform_int_distribution<short>(std::numeric_limits<short>::min(), std::numeric_limits<short>::max())(rng);
+			return Uniform<short>(Engine());
 		}
 
 		const static unsigned short Random(unsigned short) {
-			return std::uniform_int_distribution<unsigned short>(std::numeric_limits<unsigned short>::min(), std::numeric_limits<unsigned short>::max())(rng);
+			return Uniform<unsigned short>(Engine());
 		}
 
 		const static long Random(long) {
-			return std::uniform_int_distribution<long>(std::numeric_limits<long>::min(), std::numeric_limits<long>::max())(rng);
+			return Uniform<long>(Engine());
 		}
 
 		const static unsigned long Random(unsigned long) {
-			return std::uniform_int_distribution<unsigned long>(std::numeric_limits<unsigned long>::min(), std::numeric_limits<unsigned long>::max())(rng);
+			return Uniform<unsigned long>(Engine());
 		}
 
 		const static long long Random(long long) {
-			return std::uniform_int_distribution<long long>(std::numeric_limits<long long>::min(), std::numeric_limits<long long>::max())(rng);
+			return Uniform<long long>(Engine());
 		}
 
 		const static unsigned long long Random(unsigned long long) {
-			return std::uniform_int_distribution<unsigned long long>(std::numeric_limits<unsigned long long>::min(), std::numeric_limits<unsigned long long>::max())(rng);
+			return Uniform<unsigned long long>(Engine());
 		}
 
 		const static int Random(int) {
-			return std::uniform_int_distribution<int>(std::numeric_limits<int>::min(), std::numeric_limits<int>::max())(rng);
+			return Uniform<int>(Engine());
 		}
 
 		const static unsigned int Random(unsigned int) {
-			return std::uniform_int_distribution<unsigned int>(std::numeric_limits<unsigned int>::min(), std::numeric_limits<unsigned int>::max())(rng);
+			return Uniform<unsigned int>(Engine());
 		}
 
 		template<typename Type = float>
@@ -93,55 +706,55 @@ namespace ZCPP
 		}
 
 		const static float Random(const float& min, const float& max) {
-			return std::uniform_real_distribution<float>(min, max)(rng);
+			return Uniform<float>(Engine(), min, max);
 		}
 
 		const static double Random(const double& min, const double& max) {
-			return std::uniform_real_distribution<double>(min, max)(rng);
+			return Uniform<double>(Engine(), min, max);
 		}
 
 		const static long double Random(const long double& min, const long double& max) {
-			return std::uniform_real_distribution<long double>(min, max)(rng);
+			return Uniform<long double>(Engine(), min, max);
 		}
 
 		const static char Random(const char& min, const char& max) {
-			return std::uniform_int_distribution<char>(min, max)(rng);
+			return Uniform<char>(Engine(), min, max);
 		}
 
 		const static unsigned char Random(const unsigned char& min, const unsigned char& max) {
-			return std::uniform_int_distribution<unsigned char>(min, max)(rng);
+			return Uniform<unsigned char>(Engine(), min, max);
 		}
 
 		const static short Random(const short& min, const short& max) {
-			return std::uniform_int_distribution<short>(min, max)(rng);
+			return Uniform<short>(Engine(), min, max);
 		}
 
 		const static unsigned short Random(const unsigned short& min, const unsigned short& max) {
-			return std::uniform_int_distribution<unsigned short>(min, max)(rng);
+			return Uniform<unsigned short>(Engine(), min, max);
 		}
 
 		const static long Random(const long& min, const long& max) {
-			return std::uniform_int_distribution<long>(min, max)(rng);
+			return Uniform<long>(Engine(), min, max);
 		}
 
 		const static unsigned long Random(const unsigned long& min, const unsigned long& max) {
-			return std::uniform_int_distribution<unsigned long>(min, max)(rng);
+			return Uniform<unsigned long>(Engine(), min, max);
 		}
 
 		const static long long Random(const long long& min, const long long& max) {
-			return std::uniform_int_distribution<long long>(min, max)(rng);
+			return Uniform<long long>(Engine(), min, max);
 		}
 
 		const static unsigned long long Random(const unsigned long long& min, const unsigned long long& max) {
-			return std::uniform_int_distribution<unsigned long long>(min, max)(rng);
+			return Uniform<unsigned long long>(Engine(), min, max);
 		}
 
 		const static int Random(const int& min, const int& max) {
-			return std::uniform_int_distribution<int>(min, max)(rng);
+			return Uniform<int>(Engine(), min, max);
 		}
 
 		const static unsigned int Random(const unsigned int& min, const unsigned int& max) {
-			return std::uniform_int_distribution<unsigned int>(min, max)(rng);
+			return Uniform<unsigned int>(Engine(), min, max);
 		}
 
 		template<typename Type = float>
@@ -151,5 +764,429 @@ namespace ZCPP
 				std::swap(tmin, tmax);
 			return Random(tmin, tmax);
 		}
+
+		// /-----------------------------------------------\
+		// | Bulk Fill                                     |
+		// \-----------------------------------------------/
+
+		// Lanes of the calling thread, seeded from its Engine() so Seed() and Set_Thread_Index() apply
+		inline Xoshiro256ss_x4& Lane_Engine()
+		{
+			Default_Engine& engine = Engine();
+			Thread_Engine& state = Thread_State();
+			if (state.lanes_generation != state.generation) {
+				state.lanes.seed(std::uniform_int_distribution<unsigned long long>()(engine));
+				state.lanes_generation = state.generation;
+			}
+			return state.lanes;
+		}
+
+		// < Random words from the lanes, one block at a time >
+		class Lane_Stream
+		{
+		private:
+			Xoshiro256ss_x4& lanes;
+			uint64_t block[256];
+			size_t next = 512;
+
+		public:
+			explicit Lane_Stream(Xoshiro256ss_x4& lanes) : lanes(lanes) {}
+
+			uint32_t Next32()
+			{
+				if (next == 512) {
+					lanes.Fill_Bits(block, 256);
+					next = 0;
+				}
+				const uint64_t word = block[next / 2];
+				return static_cast<uint32_t>(next++ & 1 ? word >> 32 : word);
+			}
+
+			uint64_t Next64()
+			{
+				next = (next + 1) & ~static_cast<size_t>(1);
+				if (next == 512) {
+					lanes.Fill_Bits(block, 256);
+					next = 0;
+				}
+				const uint64_t word = block[next / 2];
+				next += 2;
+				return word;
+			}
+		};
+
+		// dst[i] = min + range * (bits[i] >> 8) / 2^24, the top 24 bits of each word
+		inline void bits_to_floats(const uint32_t* bits, float* dst, size_t count, float min, float range)
+		{
+			const float unit = 1.0f / 16777216.0f;
+			size_t i = 0;
+#if defined(ZCPP_RANDOM_AVX2)
+			const __m256 vunit = _mm256_set1_ps(unit), vrange = _mm256_set1_ps(range), vmin = _mm256_set1_ps(min);
+			for (; i + 8 <= count; i += 8) {
+				const __m256i v = _mm256_srli_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(bits + i)), 8);
+				const __m256 u = _mm256_mul_ps(_mm256_cvtepi32_ps(v), vunit);
+				_mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_mul_ps(u, vrange), vmin));
+			}
+#endif
+			for (; i < count; i++)
+				dst[i] = static_cast<float>(bits[i] >> 8) * unit * range + min;
+		}
+
+		// dst[i] = min + range * (bits[i] >> 12) / 2^52, the top 52 bits placed straight into the mantissa
+		inline void bits_to_doubles(const uint64_t* bits, double* dst, size_t count, double min, double range)
+		{
+			size_t i = 0;
+#if defined(ZCPP_RANDOM_AVX2)
+			const __m256i one = _mm256_set1_epi64x(0x3FF0000000000000ll);
+			const __m256d vone = _mm256_set1_pd(1.0), vrange = _mm256_set1_pd(range), vmin = _mm256_set1_pd(min);
+			for (; i + 4 <= count; i += 4) {
+				const __m256i v = _mm256_or_si256(_mm256_srli_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(bits + i)), 12), one);
+				const __m256d u = _mm256_sub_pd(_mm256_castsi256_pd(v), vone);
+				_mm256_storeu_pd(dst + i, _mm256_add_pd(_mm256_mul_pd(u, vrange), vmin));
+			}
+#endif
+			for (; i < count; i++) {
+				const uint64_t v = (bits[i] >> 12) | 0x3FF0000000000000ull;
+				double u;
+				std::memcpy(&u, &v, sizeof(u));
+				dst[i] = (u - 1.0) * range + min;
+			}
+		}
+
+		// Floats in [min, max), like Random(min, max) but without a distribution object per value
+		inline void Fill(std::span<float> out, float min = -1.0f, float max = 1.0f)
+		{
+			Xoshiro256ss_x4& lanes = Lane_Engine();
+			alignas(32) uint64_t block[256];
+
+			for (size_t done = 0; done < out.size(); done += 512) {
+				const size_t n = std::min<size_t>(512, out.size() - done);
+				lanes.Fill_Bits(block, (n + 1) / 2);
+				bits_to_floats(reinterpret_cast<const uint32_t*>(block), out.data() + done, n, min, max - min);
+			}
+		}
+
+		inline void Fill(std::span<double> out, double min = -1.0, double max = 1.0)
+		{
+			Xoshiro256ss_x4& lanes = Lane_Engine();
+			alignas(32) uint64_t block[256];
+
+			for (size_t done = 0; done < out.size(); done += 256) {
+				const size_t n = std::min<size_t>(256, out.size() - done);
+				lanes.Fill_Bits(block, n);
+				bits_to_doubles(block, out.data() + done, n, min, max - min);
+			}
+		}
+
+		// Integers over the full range of Type (raw bits, so also any byte buffer)
+		template<typename Type>
+		requires (std::is_integral_v<Type> && !std::is_same_v<Type, bool>)
+		void Fill(std::span<Type> out)
+		{
+			Xoshiro256ss_x4& lanes = Lane_Engine();
+			const size_t bytes = out.size_bytes();
+			unsigned char* dst = reinterpret_cast<unsigned char*>(out.data());
+			uint64_t block[256];
+
+			for (size_t done = 0; done < bytes; done += sizeof(block)) {
+				const size_t n = std::min(sizeof(block), bytes - done);
+				lanes.Fill_Bits(block, (n + 7) / 8);
+				std::memcpy(dst + done, block, n);
+			}
+		}
+
+		// Integers in [min, max] (either order), unbiased: multiply-shift with a rejection threshold
+		template<typename Type>
+		requires (std::is_integral_v<Type> && !std::is_same_v<Type, bool>)
+		void Fill(std::span<Type> out, Type min, Type max)
+		{
+			if (min > max)
+				std::swap(min, max);
+			typedef std::make_unsigned_t<Type> Unsigned;
+			const uint64_t span = static_cast<Unsigned>(static_cast<Unsigned>(max) - static_cast<Unsigned>(min));
+			Lane_Stream stream(Lane_Engine());
+
+			if (span >= UINT32_MAX) {
+				if (span == UINT64_MAX) {
+					for (Type& value : out)
+						value = static_cast<Type>(stream.Next64());
+					return;
+				}
+				const uint64_t range = span + 1, threshold = (0 - range) % range;
+				for (Type& value : out) {
+					uint64_t hi, lo;
+					do
+						mul_128(stream.Next64(), range, hi, lo);
+					while (lo < threshold);
+					value = static_cast<Type>(static_cast<Unsigned>(min) + hi);
+				}
+				return;
+			}
+
+			// Value i is bits[i] * range >> 32; the rare rejected ones are redrawn from a spare stream
+			const uint32_t range = static_cast<uint32_t>(span) + 1, threshold = (0u - range) % range;
+			Xoshiro256ss_x4& lanes = Lane_Engine();
+			alignas(32) uint64_t block[256];
+			alignas(32) uint32_t picked[512];
+			const uint32_t* bits = reinterpret_cast<const uint32_t*>(block);
+			Lane_Stream spare(lanes);
+			auto redraw = [&](uint32_t& pick) {
+				uint64_t m;
+				do
+					m = static_cast<uint64_t>(spare.Next32()) * range;
+				while (static_cast<uint32_t>(m) < threshold);
+				pick = static_cast<uint32_t>(m >> 32);
+			};
+
+			for (size_t done = 0; done < out.size(); done += 512) {
+				const size_t n = std::min<size_t>(512, out.size() - done);
+				lanes.Fill_Bits(block, (n + 1) / 2);
+				size_t i = 0;
+#if defined(ZCPP_RANDOM_AVX2)
+				const __m256i vrange = _mm256_set1_epi32(static_cast<int>(range));
+				const __m256i bias = _mm256_set1_epi32(INT_MIN), vthreshold = _mm256_set1_epi32(static_cast<int>(threshold ^ 0x80000000u));
+				for (; i + 8 <= n; i += 8) {
+					const __m256i x = _mm256_load_si256(reinterpret_cast<const __m256i*>(bits + i));
+					const __m256i even = _mm256_mul_epu32(x, vrange), odd = _mm256_mul_epu32(_mm256_srli_epi64(x, 32), vrange);
+					const __m256i hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+					const __m256i lo = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+					_mm256_store_si256(reinterpret_cast<__m256i*>(picked + i), hi);
+					// Unsigned lo < threshold via the sign-flipped signed compare
+					const int rejected = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(vthreshold, _mm256_xor_si256(lo, bias))));
+					if (rejected) {
+						for (size_t k = 0; k < 8; k++)
+							if (rejected & (1 << k))
+								redraw(picked[i + k]);
+					}
+				}
+#endif
+				for (; i < n; i++) {
+					const uint64_t m = static_cast<uint64_t>(bits[i]) * range;
+					picked[i] = static_cast<uint32_t>(m >> 32);
+					if (static_cast<uint32_t>(m) < threshold)
+						redraw(picked[i]);
+				}
+				for (i = 0; i < n; i++)
+					out[done + i] = static_cast<Type>(static_cast<Unsigned>(min) + static_cast<Unsigned>(picked[i]));
+			}
+		}
+
+		// Fair coin flips, one random bit each
+		inline void Fill(std::span<bool> out)
+		{
+			Xoshiro256ss_x4& lanes = Lane_Engine();
+			uint64_t block[64];
+
+			for (size_t done = 0; done < out.size(); done += 64 * 64) {
+				const size_t n = std::min<size_t>(64 * 64, out.size() - done);
+				lanes.Fill_Bits(block, (n + 63) / 64);
+				for (size_t i = 0; i < n; i++)
+					out[done + i] = (block[i / 64] >> (i % 64)) & 1;
+			}
+		}
+
+		// /-----------------------------------------------\
+		// | Counter-Based Streams                         |
+		// \-----------------------------------------------/
+
+		// < Philox4x32-10 (Salmon et al., Random123) >
+		// Word i of stream s is a pure function of (key, s, i): block i / 4 encrypts the counter
+		// (i / 4, s) under the key. Any word is reachable in O(1) and separate ranges can be filled
+		// on separate threads with the same result as one sequential pass.
+		class Philox4x32
+		{
+		public:
+			typedef uint32_t result_type;
+			uint32_t key[2];
+			uint64_t stream;
+			// Index of the next word operator() returns
+			uint64_t position;
+
+			explicit Philox4x32(uint64_t seed = 0x853C49E6748FEA9Bull, uint64_t stream = 0) : stream(stream), position(0) { this->seed(seed); }
+			void seed(uint64_t value)
+			{
+				key[0] = static_cast<uint32_t>(value);
+				key[1] = static_cast<uint32_t>(value >> 32);
+				position = 0;
+				cached = false;
+			}
+			void seed(std::seed_seq& seq)
+			{
+				seq.generate(key, key + 2);
+				position = 0;
+				cached = false;
+			}
+
+			static constexpr result_type min() { return 0; }
+			static constexpr result_type max() { return UINT32_MAX; }
+
+			// The 4 words of counter (c0, c1, c2, c3) under key (k0, k1)
+			static std::array<uint32_t, 4> Block(uint32_t c0, uint32_t c1, uint32_t c2, uint32_t c3, uint32_t k0, uint32_t k1)
+			{
+				for (int round = 0; round < 10; round++) {
+					const uint64_t p0 = static_cast<uint64_t>(0xD2511F53u) * c0, p1 = static_cast<uint64_t>(0xCD9E8D57u) * c2;
+					const uint32_t hi0 = static_cast<uint32_t>(p0 >> 32), lo0 = static_cast<uint32_t>(p0);
+					const uint32_t hi1 = static_cast<uint32_t>(p1 >> 32), lo1 = static_cast<uint32_t>(p1);
+					c0 = hi1 ^ c1 ^ k0;
+					c1 = lo1;
+					c2 = hi0 ^ c3 ^ k1;
+					c3 = lo0;
+					k0 += 0x9E3779B9u;
+					k1 += 0xBB67AE85u;
+				}
+				return { c0, c1, c2, c3 };
+			}
+
+			// Word index of this stream
+			uint32_t At(uint64_t index) const
+			{
+				const uint64_t block = index / 4;
+				return Block(static_cast<uint32_t>(block), static_cast<uint32_t>(block >> 32), static_cast<uint32_t>(stream), static_cast<uint32_t>(stream >> 32), key[0], key[1])[index % 4];
+			}
+
+			// Words first .. first + count - 1 of this stream, 8 blocks at a time with AVX2
+			void Words(uint64_t first, uint32_t* out, size_t count) const
+			{
+				uint64_t block = first / 4;
+				size_t skip = first % 4, done = 0;
+				const uint32_t s0 = static_cast<uint32_t>(stream), s1 = static_cast<uint32_t>(stream >> 32);
+
+				// Finish a partly used leading block first, so the bulk loop starts on a block boundary
+				if (skip != 0 && count != 0) {
+					const std::array<uint32_t, 4> words = Block(static_cast<uint32_t>(block), static_cast<uint32_t>(block >> 32), s0, s1, key[0], key[1]);
+					for (; skip < 4 && done < count; skip++)
+						out[done++] = words[skip];
+					block++;
+				}
+
+#if defined(ZCPP_RANDOM_AVX2)
+				const __m256i m0 = _mm256_set1_epi32(static_cast<int>(0xD2511F53u)), m1 = _mm256_set1_epi32(static_cast<int>(0xCD9E8D57u));
+				while (count - done >= 32) {
+					alignas(32) uint32_t lo[8], hi[8];
+					for (int k = 0; k < 8; k++) {
+						lo[k] = static_cast<uint32_t>(block + k);
+						hi[k] = static_cast<uint32_t>((block + k) >> 32);
+					}
+					__m256i c0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(lo)), c1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(hi));
+					__m256i c2 = _mm256_set1_epi32(static_cast<int>(s0)), c3 = _mm256_set1_epi32(static_cast<int>(s1));
+					uint32_t k0 = key[0], k1 = key[1];
+					for (int round = 0; round < 10; round++) {
+						// 32x32 -> 64 products of the even lanes, then of the odd lanes shifted down
+						const __m256i e0 = _mm256_mul_epu32(c0, m0), o0 = _mm256_mul_epu32(_mm256_srli_epi64(c0, 32), m0);
+						const __m256i e1 = _mm256_mul_epu32(c2, m1), o1 = _mm256_mul_epu32(_mm256_srli_epi64(c2, 32), m1);
+						const __m256i hi0 = _mm256_blend_epi32(_mm256_srli_epi64(e0, 32), o0, 0xAA), lo0 = _mm256_blend_epi32(e0, _mm256_slli_epi64(o0, 32), 0xAA);
+						const __m256i hi1 = _mm256_blend_epi32(_mm256_srli_epi64(e1, 32), o1, 0xAA), lo1 = _mm256_blend_epi32(e1, _mm256_slli_epi64(o1, 32), 0xAA);
+						c0 = _mm256_xor_si256(_mm256_xor_si256(hi1, c1), _mm256_set1_epi32(static_cast<int>(k0)));
+						c1 = lo1;
+						c2 = _mm256_xor_si256(_mm256_xor_si256(hi0, c3), _mm256_set1_epi32(static_cast<int>(k1)));
+						c3 = lo0;
+						k0 += 0x9E3779B9u;
+						k1 += 0xBB67AE85u;
+					}
+					// Lane j of c0..c3 is block j: transpose to block order
+					const __m256i t0 = _mm256_unpacklo_epi32(c0, c1), t1 = _mm256_unpackhi_epi32(c0, c1);
+					const __m256i t2 = _mm256_unpacklo_epi32(c2, c3), t3 = _mm256_unpackhi_epi32(c2, c3);
+					const __m256i u0 = _mm256_unpacklo_epi64(t0, t2), u1 = _mm256_unpackhi_epi64(t0, t2);
+					const __m256i u2 = _mm256_unpacklo_epi64(t1, t3), u3 = _mm256_unpackhi_epi64(t1, t3);
+					__m256i* dst = reinterpret_cast<__m256i*>(out + done);
+					_mm256_storeu_si256(dst, _mm256_permute2x128_si256(u0, u1, 0x20));
+					_mm256_storeu_si256(dst + 1, _mm256_permute2x128_si256(u2, u3, 0x20));
+					_mm256_storeu_si256(dst + 2, _mm256_permute2x128_si256(u0, u1, 0x31));
+					_mm256_storeu_si256(dst + 3, _mm256_permute2x128_si256(u2, u3, 0x31));
+					block += 8;
+					done += 32;
+				}
+#endif
+				while (done < count) {
+					const std::array<uint32_t, 4> words = Block(static_cast<uint32_t>(block), static_cast<uint32_t>(block >> 32), s0, s1, key[0], key[1]);
+					for (size_t k = 0; k < 4 && done < count; k++)
+						out[done++] = words[k];
+					block++;
+				}
+			}
+
+			// Next word of the stream, one block computed per 4 draws
+			result_type operator()()
+			{
+				if (position / 4 != cached_block || !cached) {
+					cached_block = position / 4;
+					cached_words = Block(static_cast<uint32_t>(cached_block), static_cast<uint32_t>(cached_block >> 32), static_cast<uint32_t>(stream), static_cast<uint32_t>(stream >> 32), key[0], key[1]);
+					cached = true;
+				}
+				return cached_words[position++ % 4];
+			}
+
+			// O(1) skip-ahead and seeking, in words
+			void Skip(uint64_t count) { position += count; }
+			void Seek(uint64_t index) { position = index; }
+			// Starts another stream of the same key at its first word
+			void Set_Stream(uint64_t value) { stream = value; position = 0; cached = false; }
+
+		private:
+			std::array<uint32_t, 4> cached_words{};
+			uint64_t cached_block = 0;
+			bool cached = false;
+		};
+
+		// < Index-addressed fills: out[i] is value first + i of the generator's stream >
+		// Results depend only on (seed, stream, index), so e.g. Fill(gen, out.subspan(b, n), b) on any
+		// split of [0, size) across threads matches one Fill(gen, out) exactly.
+
+		inline void Fill(const Philox4x32& generator, std::span<uint32_t> out, uint64_t first = 0)
+		{
+			generator.Words(first, out.data(), out.size());
+		}
+
+		// Value i uses word i
+		inline void Fill(const Philox4x32& generator, std::span<float> out, uint64_t first = 0, float min = -1.0f, float max = 1.0f)
+		{
+			alignas(32) uint32_t words[512];
+			for (size_t done = 0; done < out.size(); done += 512) {
+				const size_t n = std::min<size_t>(512, out.size() - done);
+				generator.Words(first + done, words, n);
+				bits_to_floats(words, out.data() + done, n, min, max - min);
+			}
+		}
+
+		// Value i uses words 2i (low half) and 2i + 1
+		inline void Fill(const Philox4x32& generator, std::span<double> out, uint64_t first = 0, double min = -1.0, double max = 1.0)
+		{
+			uint32_t words[512];
+			alignas(32) uint64_t bits[256];
+			for (size_t done = 0; done < out.size(); done += 256) {
+				const size_t n = std::min<size_t>(256, out.size() - done);
+				generator.Words(2 * (first + done), words, 2 * n);
+				for (size_t i = 0; i < n; i++)
+					bits[i] = words[2 * i] | static_cast<uint64_t>(words[2 * i + 1]) << 32;
+				bits_to_doubles(bits, out.data() + done, n, min, max - min);
+			}
+		}
+
+		// Integers in [min, max], value i from words 2i and 2i + 1 by a 64bit multiply-shift. There
+		// is no rejection, to keep one value per index; the bias is below range / 2^64.
+		template<typename Type>
+		requires (std::is_integral_v<Type> && !std::is_same_v<Type, bool>)
+		void Fill(const Philox4x32& generator, std::span<Type> out, uint64_t first, Type min, Type max)
+		{
+			if (min > max)
+				std::swap(min, max);
+			typedef std::make_unsigned_t<Type> Unsigned;
+			const uint64_t range = static_cast<uint64_t>(static_cast<Unsigned>(static_cast<Unsigned>(max) - static_cast<Unsigned>(min))) + 1;
+			uint32_t words[512];
+
+			for (size_t done = 0; done < out.size(); done += 256) {
+				const size_t n = std::min<size_t>(256, out.size() - done);
+				generator.Words(2 * (first + done), words, 2 * n);
+				for (size_t i = 0; i < n; i++) {
+					const uint64_t bits = words[2 * i] | static_cast<uint64_t>(words[2 * i + 1]) << 32;
+					uint64_t hi = bits;
+					if (range != 0) {
+						uint64_t lo;
+						mul_128(bits, range, hi, lo);
+					}
+					out[done + i] = static_cast<Type>(static_cast<Unsigned>(min) + static_cast<Unsigned>(hi));
+				}
+			}
+		}
 	}
 }
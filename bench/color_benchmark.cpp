@@ -0,0 +1,560 @@
+// Conversion throughput and round-trip accuracy of ZColors.h. Standalone, no framework:
+//   g++ -std=c++20 -O2 -I.. color_benchmark.cpp -o color_benchmark && ./color_benchmark [width height]
+// Build with -mavx2, with the default SSE2 and with -DZCPP_COLOR_NO_SIMD to compare the paths.
+// Exits non-zero if any round trip exceeds its expected error.
+
+#include "ZColors.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <cstdlib>
+
+using namespace ZCPP::Color;
+
+namespace
+{
+	// Test images every measurement runs on
+	enum class Bench_Input
+	{
+		Photo,		// Smooth shading, soft hue drift, texture noise and hard edges
+		Gradient,	// Linear ramps across the whole cube diagonal
+		Random		// Uniform bytes, worst case for branches and caches
+	};
+
+	enum class Bench_Mode
+	{
+		Scalar,		// X_TO_Y per pixel
+		Batch,		// Convert(src, dst) on one thread
+		Threaded	// Convert(src, dst) split by Parallel_For
+	};
+
+	inline const char* Bench_Name(Bench_Input input)
+	{
+		switch (input) {
+		case Bench_Input::Photo: return "photo";
+		case Bench_Input::Gradient: return "gradient";
+		default: return "random";
+		}
+	}
+
+	inline const char* Bench_Name(Bench_Mode mode)
+	{
+		switch (mode) {
+		case Bench_Mode::Scalar: return "scalar";
+		case Bench_Mode::Batch: return "batch";
+		default: return "threaded";
+		}
+	}
+
+	struct Bench_Result
+	{
+		std::string name;
+		Bench_Input input;
+		Bench_Mode mode;
+		double mpixels_per_second;
+	};
+
+	// ΔE2000 between the original and the color after a trip through another type and back
+	struct Accuracy_Result
+	{
+		std::string name;
+		Bench_Input input;
+		Bench_Mode mode;
+		double max_delta_e;
+		double mean_delta_e;
+		// Expected upper bound of max_delta_e for this path
+		double limit;
+
+		bool Passed() const { return max_delta_e <= limit; }
+	};
+
+	// < The sector-branching hue conversions ZColors.h shipped before float_hue / hue_channels >
+	// Kept verbatim (bar mod -> fmodf) as the baseline Hue_Baseline() measures against.
+	namespace Branchy
+	{
+		HSV RGB_TO_HSV(RGB rgb)
+		{
+			HSV hsv;
+
+			float cMax = std::max(std::max(rgb.r, rgb.g), rgb.b);
+			float cMin = std::min(std::min(rgb.r, rgb.g), rgb.b);
+			float delta = cMax - cMin;
+
+			hsv.v = cMax;
+
+			if (cMax == 0.0f) {
+				hsv.s = 0.0f;
+			}
+			else {
+				hsv.s = delta / cMax;
+			}
+
+			if (delta == 0.0f) {
+				hsv.h = 0.0f;
+			}
+			else if (cMax == rgb.r) {
+				hsv.h = (rgb.g - rgb.b) / delta;
+			}
+			else if (cMax == rgb.g) {
+				hsv.h = 2.0f + ((rgb.b - rgb.r) / delta);
+			}
+			else if (cMax == rgb.b) {
+				hsv.h = 4.0f + ((rgb.r - rgb.g) / delta);
+			}
+
+			hsv.h = (hsv.h * 60.0f) * .0027777777777f;
+			if (hsv.h < 0)
+				hsv.h++;
+
+			hsv.a = rgb.a;
+			return hsv;
+		}
+
+		HSL RGB_TO_HSL(RGB rgb)
+		{
+			HSL hsl;
+
+			float cMax = std::max(std::max(rgb.r, rgb.g), rgb.b);
+			float cMin = std::min(std::min(rgb.r, rgb.g), rgb.b);
+			float delta = cMax - cMin;
+
+			hsl.l = (cMax + cMin) * 0.5f;
+
+			if (delta == 0.0f) {
+				hsl.h = 0.0f;
+				hsl.s = 0.0f;
+			}
+			else {
+				hsl.s = delta / (1.0f - fabsf(2.0f * hsl.l - 1.0f));
+				if (cMax == rgb.r) {
+					hsl.h = (rgb.g - rgb.b) / delta;
+				}
+				else if (cMax == rgb.g) {
+					hsl.h = 2.0f + ((rgb.b - rgb.r) / delta);
+				}
+				else if (cMax == rgb.b) {
+					hsl.h = 4.0f + ((rgb.r - rgb.g) / delta);
+				}
+			}
+
+			hsl.h = (hsl.h * 60.0f) * .0027777777777f;
+			if (hsl.h < 0)
+				hsl.h++;
+
+			hsl.a = rgb.a;
+			return hsl;
+		}
+
+		RGB HSV_TO_RGB(HSV hsv)
+		{
+			RGB rgb;
+
+			float h = fmodf(hsv.h, 1.0f) * 360.0f;
+
+			float C = hsv.s * hsv.v;
+			float X = C * (1.0f - fabsf(fmodf(h * 0.01666666666f, 2) - 1.0f));
+			float m = hsv.v - C;
+
+			if (h >= 0.0f && h < 60.0f) {
+				rgb = RGB(C, X, 0.0f);
+			}
+			else if (h >= 60.0f && h < 120.0f) {
+				rgb = RGB(X, C, 0.0f);
+			}
+			else if (h >= 120.0f && h < 180.0f) {
+				rgb = RGB(0.0f, C, X);
+			}
+			else if (h >= 180.0f && h < 240.0f) {
+				rgb = RGB(0.0f, X, C);
+			}
+			else if (h >= 240.0f && h < 300.0f) {
+				rgb = RGB(X, 0.0f, C);
+			}
+			else {
+				rgb = RGB(C, 0.0f, X);
+			}
+
+			rgb = RGB(rgb.r + m, rgb.g + m, rgb.b + m);
+
+			rgb.a = hsv.a;
+			return rgb;
+		}
+
+		RGB HSL_TO_RGB(HSL hsl)
+		{
+			RGB rgb;
+
+			float h = fmodf(hsl.h, 1.0f) * 360.0f;
+			float s = hsl.s;
+			float l = hsl.l;
+
+			float C = (1.0f - fabsf(2.0f * l - 1.0f)) * s;
+			float X = C * (1.0f - fabsf(fmodf(h * 0.01666666666f, 2) - 1.0f));
+			float m = l - C * 0.5f;
+
+			if (h >= 0 && h < 60) {
+				rgb = RGB(C, X, 0.0f);
+			}
+			else if (h >= 60 && h < 120) {
+				rgb = RGB(X, C, 0.0f);
+			}
+			else if (h >= 120 && h < 180) {
+				rgb = RGB(0.0f, C, X);
+			}
+			else if (h >= 180 && h < 240) {
+				rgb = RGB(0.0f, X, C);
+			}
+			else if (h >= 240 && h < 300) {
+				rgb = RGB(X, 0.0f, C);
+			}
+			else {
+				rgb = RGB(C, 0.0f, X);
+			}
+
+			rgb = RGB(rgb.r + m, rgb.g + m, rgb.b + m);
+
+			rgb.a = hsl.a;
+			return rgb;
+		}
+	}
+
+	// Branchy baseline against the current hue conversions on the photo input
+	struct Baseline_Result
+	{
+		std::string name;
+		double baseline_mpixels_per_second;
+		double scalar_mpixels_per_second;
+		double batch_mpixels_per_second;
+		// Largest channel difference from the baseline (hue distance wraps around 1.0)
+		double max_difference;
+	};
+
+	// < Throughput and round-trip accuracy of the conversion functions >
+	// Covers every X_TO_Y pair with a bulk Convert overload, on width x height images of each
+	// Bench_Input. Throughput runs each measurement for at least min_seconds.
+	class Color_Benchmark
+	{
+	public:
+		size_t width, height;
+		double min_seconds;
+
+		Color_Benchmark(size_t width = 1024, size_t height = 1024, double min_seconds = 0.05) : width(width), height(height), min_seconds(min_seconds)
+		{
+			for (size_t i = 0; i < images.size(); i++)
+				images[i] = Image(static_cast<Bench_Input>(i), width, height);
+		}
+
+		// Deterministic test image, the same on every machine
+		static std::vector<RGB32> Image(Bench_Input input, size_t width, size_t height)
+		{
+			std::vector<RGB32> image(width * height);
+			uint32_t state = 0x9E3779B9u;
+			auto next = [&state]() {
+				state ^= state << 13; state ^= state >> 17; state ^= state << 5;
+				return state;
+			};
+			auto level = [](float c) { return static_cast<BYTE>(std::clamp(c, 0.0f, 1.0f) * 255.0f + 0.5f); };
+
+			for (size_t y = 0; y < height; y++) {
+				for (size_t x = 0; x < width; x++) {
+					const float u = static_cast<float>(x) / static_cast<float>(std::max<size_t>(width - 1, 1));
+					const float v = static_cast<float>(y) / static_cast<float>(std::max<size_t>(height - 1, 1));
+					RGB32& p = image[y * width + x];
+					switch (input) {
+					case Bench_Input::Photo: {
+						const float noise = static_cast<float>(next() & 0xFF) * (0.04f / 255.0f) - 0.02f;
+						const float light = 0.45f + 0.3f * sinf(3.1f * u + 1.3f) * cosf(2.3f * v) + 0.1f * sinf(17.0f * u * v) + noise;
+						const float hue = 0.08f + 0.5f * u * v + (((x / 64) + (y / 64)) % 5 == 0 ? 0.45f : 0.0f);
+						const float saturation = 0.25f + 0.45f * v;
+						RGB c = HSV_TO_RGB(HSV(hue - floorf(hue), saturation, std::clamp(light, 0.0f, 1.0f)));
+						p = RGB32(level(c.r), level(c.g), level(c.b), 255);
+						break;
+					}
+					case Bench_Input::Gradient:
+						p = RGB32(level(u), level(v), level(0.5f * (u + v)), 255);
+						break;
+					default: {
+						const uint32_t bits = next();
+						p = RGB32(static_cast<BYTE>(bits), static_cast<BYTE>(bits >> 8), static_cast<BYTE>(bits >> 16), static_cast<BYTE>(bits >> 24));
+						break;
+					}
+					}
+				}
+			}
+			return image;
+		}
+
+		// Mpixels/s of every pair in every mode, for each input
+		std::vector<Bench_Result> Throughput() const
+		{
+			std::vector<Bench_Result> results;
+			Pair<RGB32, RGB>(results, "RGB32 -> RGB", RGB32_TO_RGB);
+			Pair<RGB32, HSV>(results, "RGB32 -> HSV", RGB32_TO_HSV);
+			Pair<RGB32, HSL>(results, "RGB32 -> HSL", RGB32_TO_HSL);
+			Pair<RGB32, CMYK>(results, "RGB32 -> CMYK", RGB32_TO_CMYK);
+			Pair<RGB32, HSV32>(results, "RGB32 -> HSV32", RGB32_TO_HSV32);
+			Pair<RGB32, HSL32>(results, "RGB32 -> HSL32", RGB32_TO_HSL32);
+			Pair<RGB32, Lab>(results, "RGB32 -> Lab", RGB32_TO_LAB);
+			Pair<RGB32, OKLab>(results, "RGB32 -> OKLab", RGB32_TO_OKLAB);
+			Pair<RGB32, RGBA16>(results, "RGB32 -> RGBA16", RGB32_TO_RGBA16);
+			Pair<RGB32, RGBA_Half>(results, "RGB32 -> RGBA_Half", [](RGB32 c) { return To_RGBA_Half(c); });
+
+			Pair<RGB, RGB32>(results, "RGB -> RGB32", RGB_TO_RGB32);
+			Pair<RGB, HSV>(results, "RGB -> HSV", RGB_TO_HSV);
+			Pair<RGB, HSL>(results, "RGB -> HSL", RGB_TO_HSL);
+			Pair<RGB, CMYK>(results, "RGB -> CMYK", RGB_TO_CMYK);
+			Pair<RGB, Lab>(results, "RGB -> Lab", RGB_TO_LAB);
+			Pair<RGB, OKLab>(results, "RGB -> OKLab", RGB_TO_OKLAB);
+			Pair<RGB, RGBA16>(results, "RGB -> RGBA16", RGB_TO_RGBA16);
+			Pair<RGB, RGBA_Half>(results, "RGB -> RGBA_Half", RGB_TO_RGBA_HALF);
+
+			Pair<HSV, RGB32>(results, "HSV -> RGB32", HSV_TO_RGB32);
+			Pair<HSV, RGB>(results, "HSV -> RGB", HSV_TO_RGB);
+			Pair<HSV, HSL>(results, "HSV -> HSL", HSV_TO_HSL);
+			Pair<HSV, CMYK>(results, "HSV -> CMYK", HSV_TO_CMYK);
+
+			Pair<HSL, RGB32>(results, "HSL -> RGB32", HSL_TO_RGB32);
+			Pair<HSL, RGB>(results, "HSL -> RGB", HSL_TO_RGB);
+			Pair<HSL, HSV>(results, "HSL -> HSV", HSL_TO_HSV);
+			Pair<HSL, CMYK>(results, "HSL -> CMYK", HSL_TO_CMYK);
+
+			Pair<CMYK, RGB32>(results, "CMYK -> RGB32", CMYK_TO_RGB32);
+			Pair<CMYK, RGB>(results, "CMYK -> RGB", CMYK_TO_RGB);
+			Pair<CMYK, HSV>(results, "CMYK -> HSV", CMYK_TO_HSV);
+			Pair<CMYK, HSL>(results, "CMYK -> HSL", CMYK_TO_HSL);
+
+			Pair<HSV32, RGB32>(results, "HSV32 -> RGB32", HSV32_TO_RGB32);
+			Pair<HSL32, RGB32>(results, "HSL32 -> RGB32", HSL32_TO_RGB32);
+			Pair<Lab, RGB32>(results, "Lab -> RGB32", LAB_TO_RGB32);
+			Pair<Lab, RGB>(results, "Lab -> RGB", LAB_TO_RGB);
+			Pair<OKLab, RGB32>(results, "OKLab -> RGB32", OKLAB_TO_RGB32);
+			Pair<OKLab, RGB>(results, "OKLab -> RGB", OKLAB_TO_RGB);
+			Pair<RGBA16, RGB32>(results, "RGBA16 -> RGB32", RGBA16_TO_RGB32);
+			Pair<RGBA16, RGB>(results, "RGBA16 -> RGB", RGBA16_TO_RGB);
+			Pair<RGBA_Half, RGB32>(results, "RGBA_Half -> RGB32", RGBA_HALF_TO_RGB32);
+			Pair<RGBA_Half, RGB>(results, "RGBA_Half -> RGB", RGBA_HALF_TO_RGB);
+			return results;
+		}
+
+		// Round trips from RGB32 and from RGB, scalar and batch paths measured separately
+		std::vector<Accuracy_Result> Accuracy() const
+		{
+			// 8bit results differ by a step where RGB_TO_RGB32 truncates; float results only by rounding
+			std::vector<Accuracy_Result> results;
+			Round_Trip<RGB32, RGB>(results, "RGB32 <-> RGB", RGB32_TO_RGB, RGB_TO_RGB32, 0.0);
+			Round_Trip<RGB32, HSV>(results, "RGB32 <-> HSV", RGB32_TO_HSV, HSV_TO_RGB32, 1.5);
+			Round_Trip<RGB32, HSL>(results, "RGB32 <-> HSL", RGB32_TO_HSL, HSL_TO_RGB32, 1.5);
+			Round_Trip<RGB32, CMYK>(results, "RGB32 <-> CMYK", RGB32_TO_CMYK, CMYK_TO_RGB32, 1.5);
+			Round_Trip<RGB32, HSV32>(results, "RGB32 <-> HSV32", RGB32_TO_HSV32, HSV32_TO_RGB32, 2.0);
+			Round_Trip<RGB32, HSL32>(results, "RGB32 <-> HSL32", RGB32_TO_HSL32, HSL32_TO_RGB32, 2.0);
+			Round_Trip<RGB32, Lab>(results, "RGB32 <-> Lab", RGB32_TO_LAB, LAB_TO_RGB32, 0.1);
+			Round_Trip<RGB32, OKLab>(results, "RGB32 <-> OKLab", RGB32_TO_OKLAB, OKLAB_TO_RGB32, 0.1);
+			Round_Trip<RGB32, RGBA16>(results, "RGB32 <-> RGBA16", RGB32_TO_RGBA16, RGBA16_TO_RGB32, 0.0);
+			Round_Trip<RGB32, RGBA_Half>(results, "RGB32 <-> RGBA_Half", [](RGB32 c) { return To_RGBA_Half(c); }, RGBA_HALF_TO_RGB32, 0.0);
+
+			Round_Trip<RGB, HSV>(results, "RGB <-> HSV", RGB_TO_HSV, HSV_TO_RGB, 0.001);
+			Round_Trip<RGB, HSL>(results, "RGB <-> HSL", RGB_TO_HSL, HSL_TO_RGB, 0.001);
+			Round_Trip<RGB, CMYK>(results, "RGB <-> CMYK", RGB_TO_CMYK, CMYK_TO_RGB, 0.001);
+			Round_Trip<RGB, Lab>(results, "RGB <-> Lab", RGB_TO_LAB, LAB_TO_RGB, 0.01);
+			Round_Trip<RGB, OKLab>(results, "RGB <-> OKLab", RGB_TO_OKLAB, OKLAB_TO_RGB, 0.01);
+			Round_Trip<RGB, RGBA16>(results, "RGB <-> RGBA16", RGB_TO_RGBA16, RGBA16_TO_RGB, 0.001);
+			Round_Trip<RGB, RGBA_Half>(results, "RGB <-> RGBA_Half", RGB_TO_RGBA_HALF, RGBA_HALF_TO_RGB, 0.25);
+			return results;
+		}
+
+		// Branchy baseline vs the branch-free scalar functions and batch Convert, photo input
+		std::vector<Baseline_Result> Hue_Baseline() const
+		{
+			std::vector<Baseline_Result> results;
+			Baseline<RGB, HSV>(results, "RGB -> HSV", Branchy::RGB_TO_HSV, RGB_TO_HSV);
+			Baseline<RGB, HSL>(results, "RGB -> HSL", Branchy::RGB_TO_HSL, RGB_TO_HSL);
+			Baseline<HSV, RGB>(results, "HSV -> RGB", Branchy::HSV_TO_RGB, HSV_TO_RGB);
+			Baseline<HSL, RGB>(results, "HSL -> RGB", Branchy::HSL_TO_RGB, HSL_TO_RGB);
+			return results;
+		}
+
+		static void Print(std::ostream& os, const std::vector<Bench_Result>& results)
+		{
+			std::ostringstream out;
+			out << std::left << std::fixed << std::setprecision(1);
+			for (const Bench_Result& r : results)
+				out << std::setw(22) << r.name << std::setw(10) << Bench_Name(r.input) << std::setw(10) << Bench_Name(r.mode)
+					<< std::right << std::setw(10) << r.mpixels_per_second << std::left << " Mpx/s\n";
+			os << out.str();
+		}
+
+		static void Print(std::ostream& os, const std::vector<Accuracy_Result>& results)
+		{
+			std::ostringstream out;
+			out << std::left << std::fixed << std::setprecision(5);
+			for (const Accuracy_Result& r : results)
+				out << std::setw(22) << r.name << std::setw(10) << Bench_Name(r.input) << std::setw(8) << Bench_Name(r.mode)
+					<< "max dE " << r.max_delta_e << "  mean dE " << r.mean_delta_e << "  " << (r.Passed() ? "ok" : "FAIL") << "\n";
+			os << out.str();
+		}
+
+		static void Print(std::ostream& os, const std::vector<Baseline_Result>& results)
+		{
+			std::ostringstream out;
+			out << std::left << std::fixed << std::setprecision(1);
+			for (const Baseline_Result& r : results)
+				out << std::setw(22) << r.name << "branchy " << std::setw(8) << r.baseline_mpixels_per_second
+					<< "branch-free " << std::setw(8) << r.scalar_mpixels_per_second << "batch " << std::setw(8) << r.batch_mpixels_per_second
+					<< "Mpx/s  max diff " << std::scientific << std::setprecision(2) << r.max_difference << std::fixed << std::setprecision(1) << "\n";
+			os << out.str();
+		}
+
+	private:
+		std::array<std::vector<RGB32>, 3> images;
+
+		// images[input] in From, through the same bulk path the library offers
+		template<typename From>
+		std::vector<From> Source(size_t input) const
+		{
+			if constexpr (std::is_same_v<From, RGB32>)
+				return images[input];
+			else {
+				std::vector<From> src(images[input].size());
+				Convert(std::span<const RGB32>(images[input]), std::span<From>(src));
+				return src;
+			}
+		}
+
+		// Average seconds per fn() over at least min_seconds, after one warm-up call
+		template<typename Function>
+		double Time(Function fn) const
+		{
+			fn();
+			const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			size_t runs = 0;
+			double elapsed = 0.0;
+			do {
+				fn();
+				runs++;
+				elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			} while (elapsed < min_seconds);
+			return elapsed / static_cast<double>(runs);
+		}
+
+		template<typename From, typename To, typename Scalar>
+		void Pair(std::vector<Bench_Result>& results, const char* name, Scalar scalar) const
+		{
+			for (size_t input = 0; input < images.size(); input++) {
+				const std::vector<From> src = Source<From>(input);
+				std::vector<To> dst(src.size());
+				const std::span<const From> in(src);
+				const std::span<To> out(dst);
+				const double megapixels = static_cast<double>(src.size()) * 1e-6;
+
+				const double scalar_time = Time([&] {
+					for (size_t i = 0; i < in.size(); i++)
+						out[i] = scalar(in[i]);
+				});
+				const double batch_time = Time([&] { Convert(in, out); });
+				const double threaded_time = Time([&] {
+					Parallel_For(in.size(), 16384, [&](size_t begin, size_t end) { Convert(in.subspan(begin, end - begin), out.subspan(begin, end - begin)); });
+				});
+
+				results.push_back({ name, static_cast<Bench_Input>(input), Bench_Mode::Scalar, megapixels / scalar_time });
+				results.push_back({ name, static_cast<Bench_Input>(input), Bench_Mode::Batch, megapixels / batch_time });
+				results.push_back({ name, static_cast<Bench_Input>(input), Bench_Mode::Threaded, megapixels / threaded_time });
+			}
+		}
+
+		template<typename From, typename To, typename Old, typename New>
+		void Baseline(std::vector<Baseline_Result>& results, const char* name, Old old_fn, New new_fn) const
+		{
+			const std::vector<From> src = Source<From>(static_cast<size_t>(Bench_Input::Photo));
+			std::vector<To> expected(src.size()), dst(src.size());
+			const std::span<const From> in(src);
+			const double megapixels = static_cast<double>(src.size()) * 1e-6;
+
+			const double baseline_time = Time([&] {
+				for (size_t i = 0; i < in.size(); i++)
+					expected[i] = old_fn(in[i]);
+			});
+			const double scalar_time = Time([&] {
+				for (size_t i = 0; i < in.size(); i++)
+					dst[i] = new_fn(in[i]);
+			});
+
+			// Difference of the batch path, which mirrors the scalar one
+			const double batch_time = Time([&] { Convert(in, std::span<To>(dst)); });
+			double worst = 0.0;
+			for (size_t i = 0; i < src.size(); i++) {
+				const float* x = reinterpret_cast<const float*>(&expected[i]);
+				const float* y = reinterpret_cast<const float*>(&dst[i]);
+				for (int k = 0; k < 3; k++) {
+					double d = fabs(static_cast<double>(x[k]) - static_cast<double>(y[k]));
+					if (k == 0 && !std::is_same_v<To, RGB>)
+						d = std::min(d, 1.0 - d);
+					worst = std::max(worst, d);
+				}
+			}
+			results.push_back({ name, megapixels / baseline_time, megapixels / scalar_time, megapixels / batch_time, worst });
+		}
+
+		template<typename Base, typename Via, typename There, typename Back>
+		void Round_Trip(std::vector<Accuracy_Result>& results, const char* name, There there, Back back, double limit) const
+		{
+			auto lab = [](const Base& c) {
+				if constexpr (std::is_same_v<Base, RGB32>)
+					return RGB32_TO_LAB(c);
+				else
+					return RGB_TO_LAB(c);
+			};
+
+			const float alpha_tolerance = std::is_same_v<Base, RGB32> ? 0.0f : 1e-3f;
+
+			for (size_t input = 0; input < images.size(); input++) {
+				const std::vector<Base> src = Source<Base>(input);
+				std::vector<Via> via(src.size());
+				std::vector<Base> dst(src.size());
+
+				for (Bench_Mode mode : { Bench_Mode::Scalar, Bench_Mode::Batch }) {
+					if (mode == Bench_Mode::Scalar) {
+						for (size_t i = 0; i < src.size(); i++)
+							dst[i] = back(there(src[i]));
+					}
+					else {
+						Convert(std::span<const Base>(src), std::span<Via>(via));
+						Convert(std::span<const Via>(via), std::span<Base>(dst));
+					}
+
+					// ΔE ignores alpha, so a changed alpha counts as a complete miss
+					double worst = 0.0, sum = 0.0;
+					for (size_t i = 0; i < src.size(); i++) {
+						double e = Delta_E2000(lab(src[i]), lab(dst[i]));
+						if (fabsf(static_cast<float>(src[i].a) - static_cast<float>(dst[i].a)) > alpha_tolerance)
+							e = 100.0;
+						worst = std::max(worst, e);
+						sum += e;
+					}
+					results.push_back({ name, static_cast<Bench_Input>(input), mode, worst, src.empty() ? 0.0 : sum / static_cast<double>(src.size()), limit });
+				}
+			}
+		}
+	};
+}
+
+int main(int argc, char** argv)
+{
+	const size_t width = argc > 2 ? std::strtoul(argv[1], nullptr, 10) : 1024;
+	const size_t height = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1024;
+	Color_Benchmark benchmark(width, height);
+
+	std::cout << "Throughput, " << width << "x" << height << "\n";
+	Color_Benchmark::Print(std::cout, benchmark.Throughput());
+
+	const std::vector<Accuracy_Result> accuracy = benchmark.Accuracy();
+	std::cout << "\nHue conversions, branchy baseline vs branch-free (photo input)\n";
+	Color_Benchmark::Print(std::cout, benchmark.Hue_Baseline());
+
+	std::cout << "\nRound-trip accuracy (CIEDE2000)\n";
+	Color_Benchmark::Print(std::cout, accuracy);
+
+	for (const Accuracy_Result& r : accuracy)
+		if (!r.Passed())
+			return 1;
+	return 0;
+}
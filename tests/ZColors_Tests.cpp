@@ -0,0 +1,635 @@
+// ZColors.h tests. Standalone, no framework:
+//   g++ -std=c++20 -O2 -pthread -I.. ZColors_Tests.cpp -o ZColors_Tests && ./ZColors_Tests
+// The batch kernels differ per instruction set, so build and run it three times:
+// with the default SSE2, with -mavx2 -mf16c and with -DZCPP_COLOR_NO_SIMD.
+// Exits non-zero if any check fails.
+
+#include "ZColors.h"
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <sstream>
+
+using namespace ZCPP::Color;
+
+static int failures = 0;
+
+#define CHECK(condition, ...) \
+	do { \
+		if (!(condition)) { \
+			failures++; \
+			std::printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+			std::printf(__VA_ARGS__); \
+			std::printf("\n"); \
+		} \
+	} while (0)
+
+static std::mt19937 rng(1);
+
+static float Unit() { return std::uniform_real_distribution<float>(0.0f, 1.0f)(rng); }
+
+// < Random valid values of each type >
+template<typename Type> Type Sample();
+template<> RGB32 Sample() { return RGB32(rng() % 256, rng() % 256, rng() % 256, rng() % 256); }
+template<> RGB Sample() { return RGB(Unit(), Unit(), Unit(), Unit()); }
+template<> HSV Sample() { return HSV(Unit(), Unit(), Unit(), Unit()); }
+template<> HSL Sample() { return HSL(Unit(), Unit(), Unit(), Unit()); }
+template<> CMYK Sample() { return CMYK(Unit(), Unit(), Unit(), Unit(), Unit()); }
+
+// < Largest channel difference, hue wraps around 1.0 >
+static float Hue_Difference(float x, float y) { float d = fabsf(x - y); return std::min(d, 1.0f - d); }
+static float Difference(RGB32 x, RGB32 y) { return static_cast<float>(std::max({ abs(x.r - y.r), abs(x.g - y.g), abs(x.b - y.b), abs(x.a - y.a) })); }
+static float Difference(RGB x, RGB y) { return std::max({ fabsf(x.r - y.r), fabsf(x.g - y.g), fabsf(x.b - y.b), fabsf(x.a - y.a) }); }
+static float Difference(HSV x, HSV y) { return std::max({ Hue_Difference(x.h, y.h), fabsf(x.s - y.s), fabsf(x.v - y.v), fabsf(x.a - y.a) }); }
+static float Difference(HSL x, HSL y) { return std::max({ Hue_Difference(x.h, y.h), fabsf(x.s - y.s), fabsf(x.l - y.l), fabsf(x.a - y.a) }); }
+static float Difference(CMYK x, CMYK y) { return std::max({ fabsf(x.c - y.c), fabsf(x.m - y.m), fabsf(x.y - y.y), fabsf(x.k - y.k), fabsf(x.a - y.a) }); }
+
+// < Convert(span, span) against the scalar function, for every tail length 0 - 15 after 0 and 4 full AVX2 blocks >
+template<typename From, typename To>
+static void Batch_Matches_Scalar(const char* name, To(*scalar)(From), float tolerance)
+{
+	for (size_t blocks : { 0, 4 })
+		for (size_t tail = 0; tail < 16; tail++) {
+			const size_t count = blocks * 8 + tail;
+			std::vector<From> src(count);
+			for (From& c : src)
+				c = Sample<From>();
+			// Guard element past the end, which the batch path must leave alone
+			std::vector<To> dst(count + 1);
+			const To guard = Sample<To>();
+			dst[count] = guard;
+			Convert(std::span<const From>(src), std::span<To>(dst.data(), count));
+
+			float worst = 0.0f;
+			for (size_t i = 0; i < count; i++)
+				worst = std::max(worst, Difference(dst[i], scalar(src[i])));
+			CHECK(worst <= tolerance, "Convert %s, %zu pixels: off by %g from scalar (tolerance %g)", name, count, worst, tolerance);
+			CHECK(Difference(dst[count], guard) == 0.0f, "Convert %s, %zu pixels: wrote past the end", name, count);
+		}
+}
+
+static void Batch_Conversions()
+{
+	// Floats only differ by rounding order; 8bit results by at most the one step a rounding change moves
+	const float floats = 2e-6f, bytes = 1.0f;
+
+	Batch_Matches_Scalar<RGB32, RGB>("RGB32 -> RGB", RGB32_TO_RGB, floats);
+	Batch_Matches_Scalar<RGB32, HSV>("RGB32 -> HSV", RGB32_TO_HSV, floats);
+	Batch_Matches_Scalar<RGB32, HSL>("RGB32 -> HSL", RGB32_TO_HSL, floats);
+	Batch_Matches_Scalar<RGB32, CMYK>("RGB32 -> CMYK", RGB32_TO_CMYK, floats);
+
+	Batch_Matches_Scalar<RGB, RGB32>("RGB -> RGB32", RGB_TO_RGB32, bytes);
+	Batch_Matches_Scalar<RGB, HSV>("RGB -> HSV", RGB_TO_HSV, floats);
+	Batch_Matches_Scalar<RGB, HSL>("RGB -> HSL", RGB_TO_HSL, floats);
+	Batch_Matches_Scalar<RGB, CMYK>("RGB -> CMYK", RGB_TO_CMYK, floats);
+
+	Batch_Matches_Scalar<HSV, RGB32>("HSV -> RGB32", HSV_TO_RGB32, bytes);
+	Batch_Matches_Scalar<HSV, RGB>("HSV -> RGB", HSV_TO_RGB, floats);
+	Batch_Matches_Scalar<HSV, HSL>("HSV -> HSL", HSV_TO_HSL, floats);
+	Batch_Matches_Scalar<HSV, CMYK>("HSV -> CMYK", HSV_TO_CMYK, floats);
+
+	Batch_Matches_Scalar<HSL, RGB32>("HSL -> RGB32", HSL_TO_RGB32, bytes);
+	Batch_Matches_Scalar<HSL, RGB>("HSL -> RGB", HSL_TO_RGB, floats);
+	Batch_Matches_Scalar<HSL, HSV>("HSL -> HSV", HSL_TO_HSV, floats);
+	Batch_Matches_Scalar<HSL, CMYK>("HSL -> CMYK", HSL_TO_CMYK, floats);
+
+	Batch_Matches_Scalar<CMYK, RGB32>("CMYK -> RGB32", CMYK_TO_RGB32, bytes);
+	Batch_Matches_Scalar<CMYK, RGB>("CMYK -> RGB", CMYK_TO_RGB, floats);
+	Batch_Matches_Scalar<CMYK, HSV>("CMYK -> HSV", CMYK_TO_HSV, floats);
+	Batch_Matches_Scalar<CMYK, HSL>("CMYK -> HSL", CMYK_TO_HSL, floats);
+}
+
+// < LUT and fixed-point RGB32 fast paths >
+static void Fixed_Point()
+{
+	int lut = 0;
+	for (int i = 0; i < 256; i++)
+		lut += BYTE_TO_FLOAT[i] != static_cast<float>(i) * static_cast<float>(1.0 / 255.0);
+	CHECK(lut == 0, "BYTE_TO_FLOAT differs from BYTE * (1.0 / 255.0) in %d entries", lut);
+
+	// Q16 grayscale stays within 1 of the float path over the whole cube
+	int gray = 0;
+	for (int r = 0; r < 256; r++)
+		for (int g = 0; g < 256; g++)
+			for (int b = 0; b < 256; b += 3) {
+				const RGB32 c(r, g, b, 77);
+				const RGB32 q = RGB32_TO_GRAYSCALE(c), f = RGB_TO_RGB32(RGB_TO_GRAYSCALE(RGB32_TO_RGB(c)));
+				gray = std::max({ gray, abs(q.r - f.r), abs(q.g - q.r), abs(q.b - q.r) });
+			}
+	CHECK(gray <= 1, "RGB32_TO_GRAYSCALE is %d steps from the float path", gray);
+	CHECK(RGB32_TO_GRAYSCALE(RGB32(255, 255, 255)) == RGB32(255, 255, 255), "white does not stay white");
+
+	for (size_t count : { 0, 1, 7, 8, 9, 15, 16, 31, 1003 }) {
+		std::vector<RGB32> src(count), dst(count);
+		for (RGB32& c : src)
+			c = Sample<RGB32>();
+		To_grayscale(std::span<const RGB32>(src), std::span<RGB32>(dst));
+		size_t bad = 0;
+		for (size_t i = 0; i < count; i++)
+			bad += !(dst[i] == RGB32_TO_GRAYSCALE(src[i]));
+		CHECK(bad == 0, "To_grayscale span of %zu pixels differs from scalar in %zu", count, bad);
+	}
+
+	// Integer HSV32 / HSL32: hue and saturation within one step of the float result, round trips within 5
+	int hue = 0, saturation = 0, trip = 0;
+	for (int r = 0; r < 256; r += 3)
+		for (int g = 0; g < 256; g += 5)
+			for (int b = 0; b < 256; b += 7) {
+				const RGB32 c(r, g, b);
+				const HSV32 v = RGB32_TO_HSV32(c);
+				const HSL32 l = RGB32_TO_HSL32(c);
+				const HSV fv = RGB32_TO_HSV(c);
+				const HSL fl = RGB32_TO_HSL(c);
+				for (int h : { abs((static_cast<int>(lroundf(fv.h * 256)) & 255) - v.h), abs((static_cast<int>(lroundf(fl.h * 256)) & 255) - l.h) })
+					hue = std::max(hue, std::min(h, 256 - h));
+				saturation = std::max({ saturation, abs(static_cast<int>(lroundf(fv.s * 255)) - v.s), abs(static_cast<int>(lroundf(fl.s * 255)) - l.s) });
+				for (RGB32 back : { HSV32_TO_RGB32(v), HSL32_TO_RGB32(l) })
+					trip = std::max({ trip, abs(back.r - r), abs(back.g - g), abs(back.b - b) });
+			}
+	CHECK(hue <= 1 && saturation <= 1, "HSV32/HSL32 off by %d hue, %d saturation steps from float", hue, saturation);
+	CHECK(trip <= 5, "HSV32/HSL32 round trip off by %d", trip);
+}
+
+// < sRGB transfer: lossless RGB32 round trips and table accuracy >
+// < Load_Cube() accepts valid .cube files and rejects bad sizes and domains; a default LUT is the identity >
+static void Cube_Files()
+{
+	auto load = [](const std::string& header) {
+		std::string text = header + "LUT_3D_SIZE 2\n";
+		for (int i = 0; i < 8; i++)
+			text += std::to_string(i & 1) + " " + std::to_string((i >> 1) & 1) + " " + std::to_string(i >> 2) + "\n";
+		std::istringstream in(text);
+		LUT3D lut;
+		return lut.Load_Cube(in);
+	};
+	CHECK(load(""), "Load_Cube rejected a size-2 identity");
+	CHECK(load("DOMAIN_MIN 0 0 0\nDOMAIN_MAX 2 2 2\n"), "Load_Cube rejected a valid domain");
+	CHECK(!load("DOMAIN_MIN 0 0\n"), "Load_Cube accepted a DOMAIN_MIN with two values");
+	CHECK(!load("DOMAIN_MAX 1 x 1\n"), "Load_Cube accepted an unparsable DOMAIN_MAX");
+	CHECK(!load("DOMAIN_MIN 0 0.5 0\nDOMAIN_MAX 1 0.5 1\n"), "Load_Cube accepted equal domain bounds");
+	CHECK(!load("DOMAIN_MIN 1 0 0\nDOMAIN_MAX 0 1 1\n"), "Load_Cube accepted a reversed domain");
+	std::istringstream huge("LUT_3D_SIZE 257\n");
+	CHECK(!LUT3D().Load_Cube(huge), "Load_Cube accepted LUT_3D_SIZE 257");
+
+	const LUT3D identity;
+	std::vector<RGB32> image(37), out(37);
+	for (RGB32& c : image)
+		c = Sample<RGB32>();
+	identity.Apply(image, out);
+	float worst = 0.0f;
+	for (size_t i = 0; i < image.size(); i++)
+		worst = std::max(worst, Difference(RGB32(image[i].r, image[i].g, image[i].b, 0), RGB32(out[i].r, out[i].g, out[i].b, 0)));
+	CHECK(identity.Size() == 2 && worst <= 1.0f, "default LUT3D is off the identity by %g", worst);
+}
+
+static void Transfer()
+{
+	// Every level of every channel, with varying alpha, at tail lengths the batch path splits
+	std::vector<RGB32> src;
+	for (int i = 0; i < 256 * 4 + 11; i++)
+		src.push_back(RGB32(i & 255, (i * 7) & 255, (i * 13) & 255, (i * 3) & 255));
+	std::vector<RGB> linear(src.size());
+	std::vector<RGB32> back(src.size());
+	Decode_SRGB(std::span<const RGB32>(src), std::span<RGB>(linear));
+	Encode_SRGB(std::span<const RGB>(linear), std::span<RGB32>(back));
+
+	size_t lossy = 0, decode = 0, scalar = 0;
+	for (size_t i = 0; i < src.size(); i++) {
+		lossy += !(back[i] == src[i]);
+		decode += Difference(linear[i], RGB32_TO_LINEAR(src[i])) != 0.0f;
+		scalar += !(LINEAR_TO_RGB32(RGB32_TO_LINEAR(src[i])) == src[i]);
+	}
+	CHECK(lossy == 0, "RGB32 -> linear -> RGB32 batch round trip changed %zu pixels", lossy);
+	CHECK(scalar == 0, "RGB32 -> linear -> RGB32 scalar round trip changed %zu pixels", scalar);
+	CHECK(decode == 0, "Decode_SRGB differs from RGB32_TO_LINEAR in %zu pixels", decode);
+
+	// The encoding table interpolates, so it only has to stay close to the exact curve
+	std::vector<RGB> ramp(4097);
+	for (size_t i = 0; i < ramp.size(); i++) {
+		const float x = static_cast<float>(i) / 4096.0f;
+		ramp[i] = RGB(x, x * x, 1.0f - x, x);
+	}
+	std::vector<RGB> encoded(ramp);
+	To_SRGB(std::span<RGB>(encoded));
+	float worst = 0.0f;
+	for (size_t i = 0; i < ramp.size(); i++)
+		worst = std::max(worst, Difference(encoded[i], LINEAR_TO_SRGB(ramp[i])));
+	CHECK(worst <= 2e-5f, "To_SRGB is %g from LINEAR_TO_SRGB", worst);
+
+	To_Linear(std::span<RGB>(encoded));
+	worst = 0.0f;
+	for (size_t i = 0; i < ramp.size(); i++)
+		worst = std::max(worst, Difference(encoded[i], ramp[i]));
+	CHECK(worst <= 2e-5f, "To_SRGB -> To_Linear drifts by %g", worst);
+
+	// Half red, half green in linear light is brighter than the encoded average
+	std::vector<RGB32> red(37, RGB32(255, 0, 0)), green(37, RGB32(0, 255, 0)), mix(37);
+	Mix(std::span<const RGB32>(red), std::span<const RGB32>(green), std::span<RGB32>(mix), 0.5f);
+	CHECK(mix[36] == RGB32(188, 188, 0), "linear Mix of red and green gave %d %d %d", mix[36].r, mix[36].g, mix[36].b);
+}
+
+// < Lab / OKLab: reference ΔE2000 data, batch against scalar and lossless RGB32 round trips >
+// < Unpremultiply(RGB32) for every alpha and channel value, including channels above alpha >
+static void Premultiplied_Alpha()
+{
+	std::vector<RGB32> all;
+	for (int a = 0; a < 256; a++)
+		for (int x = 0; x < 256; x++)
+			all.push_back(RGB32(x, x / 2, 255 - x, a));
+	std::vector<RGB32> bulk(all);
+	Unpremultiply(std::span<RGB32>(bulk));
+
+	int worst = 0;
+	for (size_t i = 0; i < all.size(); i++) {
+		const RGB32 in = all[i], out = Unpremultiply(in);
+		auto expected = [&](int x) { return in.a == 0 ? 0 : std::min(255, (std::min<int>(x, in.a) * 255 + in.a / 2) / in.a); };
+		worst = std::max({ worst, abs(out.r - expected(in.r)), abs(out.g - expected(in.g)), abs(out.b - expected(in.b)) });
+		CHECK(out.a == in.a && bulk[i] == out, "Unpremultiply(%d, %d, %d, %d)", in.r, in.g, in.b, in.a);
+	}
+	CHECK(worst <= 1, "Unpremultiply(RGB32) is %d off round(x * 255 / a)", worst);
+	CHECK(Unpremultiply(RGB32(200, 0, 0, 1)) == RGB32(255, 0, 0, 1), "Unpremultiply(RGB32(200, 0, 0, 1))");
+}
+
+static void Perceptual()
+{
+	// Pairs from Sharma, Wu and Dalal (2005), table 1
+	struct Pair { Lab x, y; float expected; };
+	const Pair sharma[] = {
+		{ Lab(50.0f, 2.6772f, -79.7751f), Lab(50.0f, 0.0f, -82.7485f), 2.0425f },
+		{ Lab(50.0f, -1.0f, 2.0f), Lab(50.0f, 0.0f, 0.0f), 2.3669f },
+		{ Lab(50.0f, 2.5f, 0.0f), Lab(58.0f, 24.0f, 15.0f), 19.4535f },
+		{ Lab(50.0f, 2.5f, 0.0f), Lab(50.0f, 3.1736f, 0.5854f), 1.0f },
+		{ Lab(60.2574f, -34.0099f, 36.2677f), Lab(60.4626f, -34.1751f, 39.4387f), 1.2644f },
+		{ Lab(22.7233f, 20.0904f, -46.6940f), Lab(23.0331f, 14.9730f, -42.5619f), 2.0373f },
+		{ Lab(50.0f, 0.0f, 0.0f), Lab(50.0f, -1.0f, 2.0f), 2.3669f },
+		{ Lab(2.0776f, 0.0795f, -1.1350f), Lab(0.9033f, -0.0636f, -0.5514f), 0.9082f },
+	};
+	for (const Pair& p : sharma)
+		CHECK(fabsf(Delta_E2000(p.x, p.y) - p.expected) <= 1e-4f, "Delta_E2000 reference pair gave %g, expected %g", Delta_E2000(p.x, p.y), p.expected);
+
+	const size_t count = 100003;
+	std::vector<RGB32> src(count);
+	for (RGB32& c : src)
+		c = Sample<RGB32>();
+	std::vector<Lab> lab(count);
+	std::vector<OKLab> ok(count);
+	Convert(std::span<const RGB32>(src), std::span<Lab>(lab));
+	Convert(std::span<const RGB32>(src), std::span<OKLab>(ok));
+
+	float lab_error = 0.0f, ok_error = 0.0f;
+	for (size_t i = 0; i < count; i++) {
+		const Lab x = RGB32_TO_LAB(src[i]);
+		const OKLab y = RGB32_TO_OKLAB(src[i]);
+		lab_error = std::max({ lab_error, fabsf(x.l - lab[i].l), fabsf(x.a - lab[i].a), fabsf(x.b - lab[i].b) });
+		ok_error = std::max({ ok_error, fabsf(y.l - ok[i].l), fabsf(y.a - ok[i].a), fabsf(y.b - ok[i].b) });
+	}
+	CHECK(lab_error <= 1e-3f, "batch RGB32 -> Lab is %g from scalar", lab_error);
+	CHECK(ok_error <= 5e-6f, "batch RGB32 -> OKLab is %g from scalar", ok_error);
+
+	std::vector<RGB32> from_lab(count), from_ok(count);
+	Convert(std::span<const Lab>(lab), std::span<RGB32>(from_lab));
+	Convert(std::span<const OKLab>(ok), std::span<RGB32>(from_ok));
+	size_t lossy = 0;
+	for (size_t i = 0; i < count; i++)
+		lossy += !(from_lab[i] == src[i]) + !(from_ok[i] == src[i]) + !(LAB_TO_RGB32(RGB32_TO_LAB(src[i])) == src[i]) + !(OKLAB_TO_RGB32(RGB32_TO_OKLAB(src[i])) == src[i]);
+	CHECK(lossy == 0, "RGB32 -> Lab/OKLab -> RGB32 changed %zu pixels", lossy);
+
+	// Random float pairs, so exactly opposite hues (where ΔE2000 itself jumps) don't come up
+	std::vector<Lab> candidates(1003);
+	std::vector<OKLab> ok_candidates(candidates.size());
+	std::vector<float> distance(candidates.size());
+	float de2000 = 0.0f, deok = 0.0f;
+	for (int round = 0; round < 20; round++) {
+		const Lab target(Unit() * 100.0f, Unit() * 200.0f - 100.0f, Unit() * 200.0f - 100.0f);
+		for (Lab& c : candidates)
+			c = Lab(Unit() * 100.0f, Unit() * 200.0f - 100.0f, Unit() * 200.0f - 100.0f);
+		Delta_E2000(target, std::span<const Lab>(candidates), std::span<float>(distance));
+		for (size_t i = 0; i < candidates.size(); i++)
+			de2000 = std::max(de2000, fabsf(distance[i] - Delta_E2000(target, candidates[i])));
+
+		const OKLab ok_target(Unit(), Unit() - 0.5f, Unit() - 0.5f);
+		for (OKLab& c : ok_candidates)
+			c = OKLab(Unit(), Unit() - 0.5f, Unit() - 0.5f);
+		Delta_EOK(ok_target, std::span<const OKLab>(ok_candidates), std::span<float>(distance));
+		for (size_t i = 0; i < ok_candidates.size(); i++)
+			deok = std::max(deok, fabsf(distance[i] - Delta_EOK(ok_target, ok_candidates[i])));
+	}
+	CHECK(de2000 <= 2e-4f, "batch Delta_E2000 is %g from scalar", de2000);
+	CHECK(deok <= 1e-6f, "batch Delta_EOK is %g from scalar", deok);
+
+	CHECK(Nearest(lab[5], std::span<const Lab>(lab)) == 5, "Nearest did not find a Lab color in its own list");
+	CHECK(Nearest(ok[7], std::span<const OKLab>(ok)) == 7, "Nearest did not find an OKLab color in its own list");
+}
+
+// < YCbCr frames: every layout byte-identical to the scalar fixed point model, on odd sizes too >
+static void Video_Frames()
+{
+	int trip = 0;
+	for (size_t width : { 1, 7, 37, 64 })
+		for (size_t height : { 1, 3, 17 }) {
+			std::vector<RGB32> src(width * height);
+			for (RGB32& c : src)
+				c = Sample<RGB32>();
+
+			for (int subsampling = 0; subsampling < 3; subsampling++)
+				for (int layout = 0; layout < 2; layout++)
+					for (int matrix = 0; matrix < 2; matrix++)
+						for (int range = 0; range < 2; range++) {
+							YCbCr_Image frame(width, height, static_cast<Chroma_Subsampling>(subsampling), static_cast<YCbCr_Layout>(layout),
+								static_cast<YCbCr_Matrix>(matrix), static_cast<YCbCr_Range>(range));
+							const YCbCr_Coefficients k(frame.Matrix(), frame.Range());
+							const size_t cx = frame.Chroma_X(), cy = frame.Chroma_Y(), step = frame.Chroma_Step();
+							Convert(std::span<const RGB32>(src), frame);
+
+							// Chroma sums 4 samples, repeating edge pixels when a block runs off the frame
+							size_t encode = 0;
+							for (size_t y = 0; y < height; y++)
+								for (size_t x = 0; x < width; x++)
+									encode += frame.Y(y)[x] != k.Luma(src[y * width + x]);
+							for (size_t row = 0; row < frame.Chroma_Height(); row++)
+								for (size_t c = 0; c < frame.Chroma_Width(); c++) {
+									const size_t x0 = c * cx, x1 = std::min(x0 + cx - 1, width - 1);
+									const size_t y0 = row * cy, y1 = std::min(y0 + cy - 1, height - 1);
+									const RGB32 p[4] = { src[y0 * width + x0], src[y0 * width + x1], src[y1 * width + x0], src[y1 * width + x1] };
+									const int r = p[0].r + p[1].r + p[2].r + p[3].r, g = p[0].g + p[1].g + p[2].g + p[3].g, b = p[0].b + p[1].b + p[2].b + p[3].b;
+									encode += (frame.Cb(row)[c * step] != k.Cb(r, g, b)) + (frame.Cr(row)[c * step] != k.Cr(r, g, b));
+								}
+
+							std::vector<RGB32> dst(width * height);
+							Convert(frame, std::span<RGB32>(dst));
+							size_t decode = 0;
+							for (size_t y = 0; y < height; y++)
+								for (size_t x = 0; x < width; x++) {
+									const RGB32 expected = k.To_RGB32(frame.Y(y)[x], frame.Cb(y / cy)[x / cx * step], frame.Cr(y / cy)[x / cx * step]);
+									const RGB32 got = dst[y * width + x];
+									decode += !(got.r == expected.r && got.g == expected.g && got.b == expected.b && got.a == 255);
+									if (subsampling == 0 && range == 1)
+										trip = std::max({ trip, abs(got.r - src[y * width + x].r), abs(got.g - src[y * width + x].g), abs(got.b - src[y * width + x].b) });
+								}
+
+							CHECK(encode == 0 && decode == 0, "YCbCr %zux%zu subsampling %d layout %d matrix %d range %d: %zu encoded and %zu decoded bytes differ from scalar",
+								width, height, subsampling, layout, matrix, range, encode, decode);
+						}
+		}
+	CHECK(trip <= 1, "full range 4:4:4 RGB32 round trip off by %d", trip);
+
+	YCbCr_Image white(2, 2);
+	const std::vector<RGB32> pixels(4, RGB32(255, 255, 255));
+	Convert(std::span<const RGB32>(pixels), white);
+	CHECK(white.Y()[0] == 235 && white.Cb()[0] == 128 && white.Cr()[0] == 128, "limited range white encoded as %d %d %d", white.Y()[0], white.Cb()[0], white.Cr()[0]);
+}
+
+// < Half floats and 16bit pixels: exact rounding, batch identical to scalar, lossless RGB32 >
+// < Serial Floyd-Steinberg with the same per-slot order of float operations as Error_Diffusion >
+static std::vector<RGB32> Serial_Diffuse(const std::vector<RGB>& src, size_t width, size_t height)
+{
+	std::vector<RGB32> dst(src.size());
+	std::vector<float> current((width + 2) * 3, 0.0f), next((width + 2) * 3);
+	auto level = [](float c) { return static_cast<BYTE>(std::clamp(c, 0.0f, 255.0f) + 0.5f); };
+	for (size_t y = 0; y < height; y++) {
+		std::fill(next.begin(), next.end(), 0.0f);
+		float carry[3] = { 0.0f, 0.0f, 0.0f };
+		for (size_t x = 0; x < width; x++) {
+			const RGB& s = src[y * width + x];
+			const float* e = current.data() + 3 * (x + 1);
+			const float value[3] = { s.r * 255.0f + e[0] + carry[0], s.g * 255.0f + e[1] + carry[1], s.b * 255.0f + e[2] + carry[2] };
+			RGB32& q = dst[y * width + x];
+			q = RGB32(level(value[0]), level(value[1]), level(value[2]), static_cast<BYTE>(std::clamp(s.a, 0.0f, 1.0f) * 255.0f + 0.5f));
+			const float quantized[3] = { static_cast<float>(q.r), static_cast<float>(q.g), static_cast<float>(q.b) };
+			float* o = next.data() + 3 * (x + 1);
+			for (size_t ch = 0; ch < 3; ch++) {
+				const float err = value[ch] - quantized[ch];
+				carry[ch] = err * (7.0f / 16.0f);
+				o[ch + 3] = err * (1.0f / 16.0f);
+				o[ch] += err * (5.0f / 16.0f);
+				o[ch - 3] += err * (3.0f / 16.0f);
+			}
+		}
+		current.swap(next);
+	}
+	return dst;
+}
+
+// < The threaded wavefront equals a serial pass, repeated to shake out ordering races >
+static void Dithering()
+{
+	const size_t width = 203;
+	for (size_t height : { 1, 2, 3, 7, 64, 129 }) {
+		std::vector<RGB> src(width * height);
+		for (RGB& c : src)
+			c = Sample<RGB>();
+		const std::vector<RGB32> expected = Serial_Diffuse(src, width, height);
+		for (int run = 0; run < 8; run++) {
+			std::vector<RGB32> out(src.size());
+			Error_Diffuse(src, out, width);
+			if (std::memcmp(out.data(), expected.data(), out.size() * sizeof(RGB32)) != 0) {
+				CHECK(false, "Error_Diffuse %zux%zu differs from a serial Floyd-Steinberg pass (run %d)", width, height, run);
+				break;
+			}
+		}
+	}
+}
+
+// < Encodes image to format in two row bands, returns the file bytes >
+static std::string Encode(Image_Format format, const std::vector<RGB32>& image, size_t width, size_t height, size_t split)
+{
+	std::ostringstream stream;
+	Image_Writer writer;
+	bool ok = writer.Open(stream, format, width, height);
+	ok = ok && writer.Write_Rows(std::span<const RGB32>(image).first(split * width));
+	ok = ok && writer.Write_Rows(std::span<const RGB32>(image).subspan(split * width));
+	ok = ok && writer.Close();
+	CHECK(ok, "Image_Writer failed on format %d", static_cast<int>(format));
+	return stream.str();
+}
+
+static bool Decode(const std::string& bytes, std::vector<RGB32>& image)
+{
+	Image_Reader reader;
+	if (!reader.Open(std::span<const BYTE>(reinterpret_cast<const BYTE*>(bytes.data()), bytes.size())))
+		return false;
+	image.assign(reader.Width() * reader.Height(), RGB32());
+	return reader.Read(image);
+}
+
+// < QOI, PAM, PPM and PGM round trips, and a truncated QOI that must fail >
+static void Image_Codecs()
+{
+	// Noise, long runs, small steps and alpha changes, so every QOI op is used
+	const size_t width = 37, height = 23;
+	std::vector<RGB32> image(width * height);
+	for (size_t i = 0; i < image.size(); i++) {
+		const size_t y = i / width;
+		if (y < 5)
+			image[i] = Sample<RGB32>();
+		else if (y < 10)
+			image[i] = RGB32(10, 20, 30, 255);
+		else if (y < 15)
+			image[i] = RGB32(static_cast<BYTE>(i), static_cast<BYTE>(i * 3), static_cast<BYTE>(i / 2), 255);
+		else
+			image[i] = i % 5 == 0 ? image[i - 7] : RGB32(static_cast<BYTE>(i), 40, static_cast<BYTE>(200 - i % 90), static_cast<BYTE>(i % 3 * 100));
+	}
+
+	std::vector<RGB32> out;
+	const std::string qoi = Encode(Image_Format::QOI, image, width, height, 9);
+	CHECK(Decode(qoi, out) && memcmp(out.data(), image.data(), image.size() * sizeof(RGB32)) == 0, "QOI round trip is not exact");
+
+	const std::string pam = Encode(Image_Format::PAM, image, width, height, 9);
+	CHECK(Decode(pam, out) && memcmp(out.data(), image.data(), image.size() * sizeof(RGB32)) == 0, "PAM round trip is not exact");
+
+	bool ppm = Decode(Encode(Image_Format::PPM, image, width, height, 9), out) && out.size() == image.size();
+	for (size_t i = 0; ppm && i < image.size(); i++)
+		ppm = out[i].r == image[i].r && out[i].g == image[i].g && out[i].b == image[i].b && out[i].a == 255;
+	CHECK(ppm, "PPM round trip does not keep RGB with opaque alpha");
+
+	bool pgm = Decode(Encode(Image_Format::PGM, image, width, height, 9), out) && out.size() == image.size();
+	for (size_t i = 0; pgm && i < image.size(); i++) {
+		const BYTE gray = RGB32_TO_GRAYSCALE(image[i]).r;
+		pgm = out[i].r == gray && out[i].g == gray && out[i].b == gray && out[i].a == 255;
+	}
+	CHECK(pgm, "PGM round trip does not give the gray level");
+
+	CHECK(!Decode(qoi.substr(0, qoi.size() / 2), out), "QOI cut in half decoded");
+	CHECK(!Decode(qoi.substr(0, 10), out), "QOI cut inside the header decoded");
+}
+
+static void HDR_Formats()
+{
+	auto is_nan = [](HALF h) { return (h & 0x7C00) == 0x7C00 && (h & 0x03FF) != 0; };
+
+	// Every half survives half -> float -> half, NaNs stay NaN
+	size_t trip = 0;
+	for (uint32_t h = 0; h < 65536; h++) {
+		const HALF back = FLOAT_TO_HALF(HALF_TO_FLOAT(static_cast<HALF>(h)));
+		trip += is_nan(static_cast<HALF>(h)) ? !is_nan(back) : back != h;
+	}
+	CHECK(trip == 0, "%zu halves change through HALF_TO_FLOAT -> FLOAT_TO_HALF", trip);
+
+	// Round to nearest even: halfway between two halves goes to the even one, a float ulp either side doesn't
+	size_t ties = 0;
+	for (uint32_t h = 0; h < 0x7BFF; h++) {
+		const float lo = HALF_TO_FLOAT(static_cast<HALF>(h)), hi = HALF_TO_FLOAT(static_cast<HALF>(h + 1));
+		const float mid = lo + (hi - lo) * 0.5f;
+		ties += FLOAT_TO_HALF(mid) != ((h & 1) ? h + 1 : h);
+		ties += FLOAT_TO_HALF(nextafterf(mid, 0.0f)) != h;
+		ties += FLOAT_TO_HALF(nextafterf(mid, INFINITY)) != h + 1;
+		ties += FLOAT_TO_HALF(-mid) != (((h & 1) ? h + 1 : h) | 0x8000);
+	}
+	CHECK(ties == 0, "FLOAT_TO_HALF rounds %zu halfway or near-halfway floats wrong", ties);
+	CHECK(FLOAT_TO_HALF(65520.0f) == 0x7C00 && FLOAT_TO_HALF(1e9f) == 0x7C00 && FLOAT_TO_HALF(-INFINITY) == 0xFC00, "overflow does not round to infinity");
+	CHECK(FLOAT_TO_HALF(ldexpf(1.0f, -25)) == 0 && FLOAT_TO_HALF(nextafterf(ldexpf(1.0f, -25), 1.0f)) == 1, "smallest denormal rounds wrong");
+	CHECK(is_nan(FLOAT_TO_HALF(NAN)) && isnan(HALF_TO_FLOAT(0x7E00)), "NaN is not preserved");
+
+#if defined(ZCPP_COLOR_F16C)
+	// Bit for bit against the hardware conversion over a sweep of every float exponent
+	auto bits = [](float f) { uint32_t u; std::memcpy(&u, &f, 4); return u; };
+	size_t hardware = 0;
+	for (uint64_t x = 0; x < (1ull << 32); x += 251) {
+		const uint32_t u = static_cast<uint32_t>(x);
+		float f;
+		std::memcpy(&f, &u, 4);
+		const HALF h = static_cast<HALF>(_mm_cvtsi128_si32(_mm_cvtps_ph(_mm_set_ss(f), 0)));
+		hardware += is_nan(h) ? !is_nan(FLOAT_TO_HALF(f)) : FLOAT_TO_HALF(f) != h;
+		hardware += bits(HALF_TO_FLOAT(static_cast<HALF>(u))) != bits(_mm_cvtss_f32(_mm_cvtph_ps(_mm_cvtsi32_si128(static_cast<int>(u & 0xFFFF)))));
+	}
+	CHECK(hardware == 0, "%zu conversions differ from F16C", hardware);
+#endif
+
+	for (size_t count : { 0, 1, 3, 4, 7, 8, 9, 15, 16, 31, 1031 }) {
+		std::vector<RGB> rgb(count), back(count);
+		std::vector<RGB32> bytes(count), bytes_back(count);
+		std::vector<RGBA_Half> half(count);
+		std::vector<RGBA16> wide(count);
+		for (size_t i = 0; i < count; i++) {
+			rgb[i] = RGB(Unit() * 1.5f - 0.2f, Unit() * 100.0f, Unit(), Unit());
+			bytes[i] = Sample<RGB32>();
+		}
+
+		size_t bad = 0;
+		Convert(std::span<const RGB>(rgb), std::span<RGBA_Half>(half));
+		Convert(std::span<const RGBA_Half>(half), std::span<RGB>(back));
+		for (size_t i = 0; i < count; i++)
+			bad += (half[i] != RGB_TO_RGBA_HALF(rgb[i])) + (Difference(back[i], RGBA_HALF_TO_RGB(half[i])) != 0.0f);
+
+		Convert(std::span<const RGB>(rgb), std::span<RGBA16>(wide));
+		Convert(std::span<const RGBA16>(wide), std::span<RGB>(back));
+		for (size_t i = 0; i < count; i++)
+			bad += (wide[i] != RGB_TO_RGBA16(rgb[i])) + (Difference(back[i], RGBA16_TO_RGB(wide[i])) != 0.0f);
+		CHECK(bad == 0, "RGB <-> RGBA_Half / RGBA16 batch of %zu differs from scalar in %zu", count, bad);
+
+		// 8bit -> 16bit / half -> 8bit is lossless, 16bit -> 8bit rounds to the nearest level
+		size_t lossy = 0;
+		Convert(std::span<const RGB32>(bytes), std::span<RGBA16>(wide));
+		Convert(std::span<const RGBA16>(wide), std::span<RGB32>(bytes_back));
+		for (size_t i = 0; i < count; i++)
+			lossy += (wide[i] != RGB32_TO_RGBA16(bytes[i])) + !(bytes_back[i] == bytes[i]);
+		Convert(std::span<const RGB32>(bytes), std::span<RGBA_Half>(half));
+		Convert(std::span<const RGBA_Half>(half), std::span<RGB32>(bytes_back));
+		for (size_t i = 0; i < count; i++)
+			lossy += !(bytes_back[i] == bytes[i]) + !(RGBA_HALF_TO_RGB32(To_RGBA_Half(bytes[i])) == bytes[i]);
+
+		for (RGBA16& c : wide)
+			c = RGBA16(rng(), rng(), rng(), rng());
+		Convert(std::span<const RGBA16>(wide), std::span<RGB32>(bytes_back));
+		for (size_t i = 0; i < count; i++)
+			lossy += !(bytes_back[i] == RGBA16_TO_RGB32(wide[i])) + (bytes_back[i].r != static_cast<int>(wide[i].r / 257.0 + 0.5));
+		CHECK(lossy == 0, "RGB32 through RGBA16 / RGBA_Half, %zu pixels: %zu mismatches", count, lossy);
+	}
+}
+
+// < Color_Histogram: incremental updates land on the same counts as a recount >
+static void Histograms()
+{
+	const size_t width = 301, height = 203;
+	std::vector<RGB32> before(width * height);
+	for (RGB32& c : before)
+		c = Sample<RGB32>();
+	std::vector<RGB32> after(before);
+	for (size_t y = 40; y < 190; y++)
+		for (size_t x = 17; x < 250; x++)
+			after[y * width + x] = Sample<RGB32>();
+
+	auto same = [](const Color_Histogram& x, const Color_Histogram& y) {
+		for (int ch = 0; ch < static_cast<int>(Color_Histogram::channels); ch++)
+			if (x.Get(static_cast<Histogram_Channel>(ch)) != y.Get(static_cast<Histogram_Channel>(ch)))
+				return false;
+		return true;
+	};
+	const Color_Histogram expected(after);
+
+	Color_Histogram region(before);
+	region.Update_Region(before, after, width, 17, 40, 233, 150);
+	CHECK(same(region, expected), "Update_Region does not match a recount");
+
+	// A rectangle hanging off the bottom only updates the rows that exist
+	Color_Histogram clipped(before);
+	clipped.Update_Region(before, after, width, 17, 40, 233, 1000);
+	CHECK(same(clipped, expected), "Update_Region past the last row does not match a recount");
+
+	Color_Histogram whole(before);
+	whole.Update(before, after);
+	CHECK(same(whole, expected), "Update does not match a recount");
+
+	Color_Histogram removed(before);
+	removed.Remove(before);
+	CHECK(removed.Count(Histogram_Channel::Red) == 0, "Remove left %llu pixels behind", removed.Count(Histogram_Channel::Red));
+}
+
+int main()
+{
+	Batch_Conversions();
+	Fixed_Point();
+	Cube_Files();
+	Transfer();
+	Premultiplied_Alpha();
+	Perceptual();
+	Video_Frames();
+	Dithering();
+	Image_Codecs();
+	HDR_Formats();
+	Histograms();
+
+	if (failures == 0)
+		std::printf("All ZColors tests passed\n");
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,267 @@
+// ZRandom.h tests. Standalone, no framework:
+//   g++ -std=c++20 -O2 -pthread -I.. ZRandom_Tests.cpp -o ZRandom_Tests && ./ZRandom_Tests
+// Build once with -mavx2 and once with -DZCPP_RANDOM_NO_SIMD to cover both fill paths.
+// Exits non-zero if any check fails.
+
+#include "ZRandom.h"
+#include <climits>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(condition, ...) \
+	do { \
+		if (!(condition)) { \
+			failures++; \
+			std::printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+			std::printf(__VA_ARGS__); \
+			std::printf("\n"); \
+		} \
+	} while (0)
+
+// < The next words of engine match the reference outputs >
+template<typename Engine_Type, size_t Count>
+static void Check_Words(const char* name, Engine_Type engine, const std::array<uint64_t, Count>& expected)
+{
+	for (size_t i = 0; i < Count; i++) {
+		const uint64_t word = engine();
+		if (word != expected[i]) {
+			CHECK(false, "%s word %zu is %016llx, reference %016llx", name, i, (unsigned long long)word, (unsigned long long)expected[i]);
+			return;
+		}
+	}
+}
+
+// < Checks every value lies in [min, max] (either order); short ranges must also hit both ends >
+template<typename Type>
+static void Check_Range(const char* name, const std::vector<Type>& out, Type min, Type max)
+{
+	if (min > max)
+		std::swap(min, max);
+	Type low = out[0], high = out[0];
+	for (Type value : out) {
+		low = std::min(low, value);
+		high = std::max(high, value);
+	}
+	const bool inside = low >= min && high <= max;
+	const bool covered = (long long)max - (long long)min > 1000 || (low == min && high == max);
+	CHECK(inside && covered, "%s(%lld, %lld) gave [%lld, %lld]", name,
+		(long long)min, (long long)max, (long long)low, (long long)high);
+}
+
+template<typename Type>
+static void Fill_Narrow(const char* name, Type min, Type max)
+{
+	std::vector<Type> out(4099);
+	ZCPP::Random::Fill(std::span<Type>(out), min, max);
+	Check_Range(name, out, min, max);
+}
+
+template<typename Type>
+static void Philox_Narrow(const char* name, Type min, Type max)
+{
+	const ZCPP::Random::Philox4x32 generator(99);
+	std::vector<Type> out(4099);
+	ZCPP::Random::Fill(generator, std::span<Type>(out), 0, min, max);
+	Check_Range(name, out, min, max);
+}
+
+// < Random123 known answers for Philox4x32-10 >
+static void Philox_Vectors()
+{
+	typedef ZCPP::Random::Philox4x32 Philox;
+	typedef std::array<uint32_t, 4> Block;
+	CHECK(Philox::Block(0, 0, 0, 0, 0, 0) == (Block{ 0x6627E8D5u, 0xE169C58Du, 0xBC57AC4Cu, 0x9B00DBD8u }), "Philox4x32 zero vector");
+	CHECK(Philox::Block(~0u, ~0u, ~0u, ~0u, ~0u, ~0u) == (Block{ 0x408F276Du, 0x41C83B0Eu, 0xA20BC7C6u, 0x6D5451FDu }), "Philox4x32 ones vector");
+	CHECK(Philox::Block(0x243F6A88u, 0x85A308D3u, 0x13198A2Eu, 0x03707344u, 0xA4093822u, 0x299F31D0u)
+		== (Block{ 0xD16CFE09u, 0x94FDCCEBu, 0x5001E420u, 0x24126EA1u }), "Philox4x32 pi vector");
+
+	// Seed 0, stream 0 starts at the zero vector through the bulk path too
+	const Philox generator(0, 0);
+	uint32_t words[32];
+	generator.Words(0, words, 32);
+	CHECK(words[0] == 0x6627E8D5u && words[1] == 0xE169C58Du && words[2] == 0xBC57AC4Cu && words[3] == 0x9B00DBD8u,
+		"Philox4x32(0, 0).Words() does not start with the zero vector");
+}
+
+// < Words() from any start index matches At(), and a fill split at unaligned offsets matches one call >
+static void Philox_Words()
+{
+	const ZCPP::Random::Philox4x32 generator(0x1234567890ABCDEFull, 7);
+	std::vector<uint32_t> words(300);
+	for (uint64_t first : { 0ull, 1ull, 2ull, 3ull, 5ull, 33ull, 0xFFFFFFFDull }) {
+		for (size_t count : { 0, 1, 3, 31, 32, 33, 37, 64, 97, 300 }) {
+			generator.Words(first, words.data(), count);
+			for (size_t i = 0; i < count; i++)
+				if (words[i] != generator.At(first + i)) {
+					CHECK(false, "Philox4x32::Words(%llu, %zu) word %zu differs from At()", (unsigned long long)first, count, i);
+					break;
+				}
+		}
+	}
+
+	std::vector<float> whole(1000), split(1000);
+	ZCPP::Random::Fill(generator, std::span<float>(whole));
+	for (size_t begin = 0, step = 1; begin < split.size(); begin += step, step = step * 3 + 2) {
+		const size_t n = std::min(step, split.size() - begin);
+		ZCPP::Random::Fill(generator, std::span<float>(split).subspan(begin, n), begin);
+	}
+	CHECK(whole == split, "Philox4x32 fill split at unaligned offsets differs from a single fill");
+}
+
+// < Set_Thread_Index() restarts the Fill lanes too, not only the scalar engine >
+static void Fill_Restart()
+{
+	std::vector<uint32_t> first(1000), second(1000);
+	ZCPP::Random::Fill(std::span<uint32_t>(first));
+	ZCPP::Random::Set_Thread_Index(3);
+	ZCPP::Random::Fill(std::span<uint32_t>(first));
+	ZCPP::Random::Set_Thread_Index(3);
+	ZCPP::Random::Fill(std::span<uint32_t>(second));
+	CHECK(first == second, "Set_Thread_Index(3) + Fill repeated gave different output");
+}
+
+// < Known answers from the reference implementations of each engine >
+static void Engine_Vectors()
+{
+	using namespace ZCPP::Random;
+	Check_Words("SplitMix64(1234567)", SplitMix64(1234567), std::array<uint64_t, 5>{
+		6457827717110365317ull, 3203168211198807973ull, 9817491932198370423ull, 4593380528125082431ull, 16408922859458223821ull });
+
+	// xoshiro256** from state { 1, 2, 3, 4 }, then after one Jump()
+	Xoshiro256ss xoshiro;
+	xoshiro.s[0] = 1; xoshiro.s[1] = 2; xoshiro.s[2] = 3; xoshiro.s[3] = 4;
+	Check_Words("Xoshiro256ss{1, 2, 3, 4}", xoshiro, std::array<uint64_t, 4>{
+		0x0000000000002D00ull, 0x0000000000000000ull, 0x000000005A007080ull, 0x10E0000000009D80ull });
+	xoshiro.Jump();
+	Check_Words("Xoshiro256ss{1, 2, 3, 4}.Jump()", xoshiro, std::array<uint64_t, 2>{ 0xBBD2F312298443D8ull, 0x62E57DB2D5706577ull });
+
+	// pcg32-demo and pcg64-demo, seeded with (42, 54)
+	Check_Words("PCG32(42, 54)", PCG32(42, 54), std::array<uint64_t, 6>{
+		0xA15C02B7ull, 0x7B47F409ull, 0xBA1D3330ull, 0x83D2F293ull, 0xBFA4784Bull, 0xCBED606Eull });
+	Check_Words("PCG64(42, 54)", PCG64(42, 54), std::array<uint64_t, 6>{
+		0x86B1DA1D72062B68ull, 0x1304AA46C9853D39ull, 0xA3670E9E0DD50358ull, 0xF9090E529A7DAE00ull, 0xC85B9FD837996F2Cull, 0x606121F8E3919196ull });
+
+	Check_Words("Wyrand(42)", Wyrand(42), std::array<uint64_t, 4>{
+		0xAE4A7CBFDDA9B434ull, 0xE9CC09D33D38D9D2ull, 0xCB5756512B93433Aull, 0xEB29B2A1320E1A71ull });
+}
+
+// < BoundedRange is uniform over a small signed range and exact over the full 64bit range >
+static void Bounded_Ranges()
+{
+	using namespace ZCPP::Random;
+	Xoshiro256ss engine(1);
+	const BoundedRange<int> dice(-3, 3);
+	const int draws = 700000;
+	int counts[7] = {};
+	for (int i = 0; i < draws; i++) {
+		const int value = dice(engine);
+		if (value < -3 || value > 3) {
+			CHECK(false, "BoundedRange<int>(-3, 3) gave %d", value);
+			return;
+		}
+		counts[value + 3]++;
+	}
+	double chi_square = 0.0;
+	for (int count : counts)
+		chi_square += (count - draws / 7.0) * (count - draws / 7.0) / (draws / 7.0);
+	// 6 degrees of freedom, p = 0.001
+	CHECK(chi_square < 22.46, "BoundedRange<int>(-3, 3) chi-square %.2f over 7 bins", chi_square);
+
+	// The full range takes the raw engine words
+	Xoshiro256ss copy = engine;
+	const BoundedRange<uint64_t> full(0, UINT64_MAX);
+	bool raw = full.Min() == 0 && full.Max() == UINT64_MAX;
+	for (int i = 0; i < 100; i++)
+		raw = raw && full(engine) == copy();
+	CHECK(raw, "BoundedRange<uint64_t>(0, UINT64_MAX) does not return the engine's words");
+	const BoundedRange<long long> signed_full(LLONG_MAX, LLONG_MIN);
+	CHECK(signed_full.Min() == LLONG_MIN && signed_full.Max() == LLONG_MAX, "BoundedRange<long long> full range bounds");
+	for (int i = 0; i < 100; i++)
+		raw = raw && static_cast<uint64_t>(signed_full(engine)) == copy();
+	CHECK(raw, "BoundedRange<long long>(LLONG_MAX, LLONG_MIN) does not return the engine's words");
+}
+
+// < Scalar draws followed by a Fill, from the calling thread's engines >
+static std::vector<unsigned long long> Draws()
+{
+	std::vector<unsigned long long> out(64);
+	for (unsigned long long& value : out)
+		value = ZCPP::Random::Random<unsigned long long>();
+	std::vector<unsigned long long> filled(300);
+	ZCPP::Random::Fill(std::span<unsigned long long>(filled));
+	out.insert(out.end(), filled.begin(), filled.end());
+	return out;
+}
+
+// < Draws() from a new thread with the given index >
+static std::vector<unsigned long long> Thread_Draws(unsigned long long index)
+{
+	std::vector<unsigned long long> out;
+	std::thread worker([&] {
+		ZCPP::Random::Set_Thread_Index(index);
+		out = Draws();
+	});
+	worker.join();
+	return out;
+}
+
+// < Per-thread streams depend only on (master seed, thread index) >
+static void Thread_Streams()
+{
+	ZCPP::Random::Seed(42);
+	const std::vector<unsigned long long> first = Thread_Draws(5);
+	ZCPP::Random::Seed(42);
+	CHECK(Thread_Draws(5) == first, "same master seed and thread index gave different streams");
+	CHECK(Thread_Draws(6) != first, "threads 5 and 6 drew the same stream");
+	ZCPP::Random::Seed(43);
+	CHECK(Thread_Draws(5) != first, "master seeds 42 and 43 gave the same stream");
+
+	// Seed() restarts the calling thread's stream, scalar engine and Fill lanes alike
+	ZCPP::Random::Seed(42);
+	const std::vector<unsigned long long> before = Draws();
+	Draws();
+	ZCPP::Random::Seed(42);
+	CHECK(Draws() == before, "Seed() did not restart the calling thread's stream");
+
+	// Set_Thread_Index() after earlier draws matches a fresh thread with that index
+	ZCPP::Random::Set_Thread_Index(7);
+	const std::vector<unsigned long long> restarted = Draws();
+	CHECK(Thread_Draws(7) == restarted, "Set_Thread_Index(7) after earlier draws differs from a new thread 7");
+}
+
+int main()
+{
+	ZCPP::Random::Seed(12345);
+
+	Fill_Narrow<signed char>("Fill<signed char>", -100, 100);
+	Fill_Narrow<signed char>("Fill<signed char>", -5, 5);
+	Fill_Narrow<signed char>("Fill<signed char>", 5, -5);
+	Fill_Narrow<char>("Fill<char>", -5, 5);
+	Fill_Narrow<short>("Fill<short>", -5, 5);
+	Fill_Narrow<short>("Fill<short>", -30000, 30000);
+	Fill_Narrow<unsigned char>("Fill<unsigned char>", 10, 20);
+	Fill_Narrow<unsigned short>("Fill<unsigned short>", 10, 20);
+	Fill_Narrow<int>("Fill<int>", -5, 5);
+	Fill_Narrow<long long>("Fill<long long>", -5, 5);
+
+	Philox_Narrow<signed char>("Philox Fill<signed char>", -100, 100);
+	Philox_Narrow<signed char>("Philox Fill<signed char>", -5, 5);
+	Philox_Narrow<char>("Philox Fill<char>", -5, 5);
+	Philox_Narrow<short>("Philox Fill<short>", -5, 5);
+	Philox_Narrow<short>("Philox Fill<short>", -30000, 30000);
+	Philox_Narrow<unsigned short>("Philox Fill<unsigned short>", 10, 20);
+	Philox_Narrow<long long>("Philox Fill<long long>", -5, 5);
+	Philox_Vectors();
+	Philox_Words();
+	Fill_Restart();
+	Thread_Streams();
+	Engine_Vectors();
+	Bounded_Ranges();
+
+	if (failures == 0)
+		std::printf("All ZRandom tests passed\n");
+	return failures == 0 ? 0 : 1;
+}